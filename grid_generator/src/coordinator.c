@@ -141,7 +141,6 @@ int main(int argc, char *argv[])
     double *rel_on_line_dual = malloc(NO_OF_VECTORS_H*sizeof(double));
 	double *inner_product_weights = malloc(8*NO_OF_SCALARS*sizeof(double));
     double *density_to_rhombi_weights = malloc(4*NO_OF_VECTORS_H*sizeof(double));
-    double *interpol_weights = malloc(5*NO_OF_LATLON_IO_POINTS*sizeof(double));
     double *exner_bg = malloc(NO_OF_SCALARS*sizeof(double));
     double *theta_v_bg = malloc(NO_OF_SCALARS*sizeof(double));
 	double *oro = calloc(NO_OF_SCALARS_H, sizeof(double));
@@ -161,7 +160,6 @@ int main(int argc, char *argv[])
     int *adjacent_signs_h = malloc(6*NO_OF_SCALARS_H*sizeof(int));
     int *vorticity_signs_triangles = malloc(3*NO_OF_DUAL_SCALARS_H*sizeof(int));
     int *density_to_rhombi_indices = malloc(4*NO_OF_VECTORS_H*sizeof(int));
-    int *interpol_indices = malloc(5*NO_OF_LATLON_IO_POINTS*sizeof(int));
 	int *is_land = calloc(NO_OF_SCALARS_H, sizeof(int));
     printf(GREEN "finished" RESET);
     printf(".\n");
@@ -329,11 +327,6 @@ int main(int argc, char *argv[])
     printf(GREEN "finished" RESET);
     printf(".\n");
     
-    printf("Calculating interpolation to the lat-lon grid ... ");
-    interpolate_ll(latitude_scalar, longitude_scalar, interpol_indices, interpol_weights);
-    printf(GREEN "finished" RESET);
-    printf(".\n");
-    
     // A statistics file is created to compare the fundamental statistical properties of the grid with the literature.
 	write_statistics_file(pent_hex_face_unity_sphere, normal_distance, normal_distance_dual, no_of_lloyd_iterations, grid_name, statistics_file);
 	
@@ -343,10 +336,10 @@ int main(int argc, char *argv[])
     int retval, latitude_scalar_id, longitude_scalar_id, direction_id, latitude_vector_id, longitude_vector_id, latitude_scalar_dual_id, longitude_scalar_dual_id,
     z_scalar_id, z_vector_id, normal_distance_id, volume_id, area_id, trsk_weights_id, z_vector_dual_id, normal_distance_dual_id, area_dual_id, f_vec_id, to_index_id,
     from_index_id, to_index_dual_id, from_index_dual_id, adjacent_vector_indices_h_id, trsk_indices_id, trsk_modified_curl_indices_id, adjacent_signs_h_id,
-    vorticity_signs_triangles_id, f_vec_dimid, scalar_dimid, scalar_h_dimid, scalar_dual_h_dimid, vector_dimid, latlon_dimid_5, scalar_h_dimid_6, vector_h_dimid,
+    vorticity_signs_triangles_id, f_vec_dimid, scalar_dimid, scalar_h_dimid, scalar_dual_h_dimid, vector_dimid, scalar_h_dimid_6, vector_h_dimid,
     vector_h_dimid_10, vector_h_dimid_4, vector_v_dimid_6, vector_dual_dimid, gravity_potential_id, scalar_dual_h_dimid_3, vector_dual_area_dimid,
     inner_product_weights_id, scalar_8_dimid, scalar_2_dimid, vector_h_dual_dimid_2, density_to_rhombi_indices_id, density_to_rhombi_weights_id,
-    vorticity_indices_triangles_id, ncid_g_prop, single_double_dimid, no_of_lloyd_iterations_id, single_int_dimid, interpol_indices_id, interpol_weights_id,
+    vorticity_indices_triangles_id, ncid_g_prop, single_double_dimid, no_of_lloyd_iterations_id, single_int_dimid,
     theta_v_bg_id, exner_bg_id, sfc_albedo_id, sfc_rho_c_id, t_conductivity_id, roughness_length_id, is_land_id, no_of_oro_layers_id, stretching_parameter_id,
     toa_id, radius_id;
     
@@ -369,8 +362,6 @@ int main(int argc, char *argv[])
         ERR(retval);
     if ((retval = nc_def_dim(ncid_g_prop, "vector_h_index", NO_OF_VECTORS_H, &vector_h_dimid)))
         ERR(retval);
-    if ((retval = nc_def_dim(ncid_g_prop, "latlon_3_index", 5*NO_OF_LATLON_IO_POINTS, &latlon_dimid_5)))
-        ERR(retval);
     if ((retval = nc_def_dim(ncid_g_prop, "scalar_h_6_index", 6*NO_OF_SCALARS_H, &scalar_h_dimid_6)))
         ERR(retval);
 	if ((retval = nc_def_dim(ncid_g_prop, "vector_h_10_index", 10*NO_OF_VECTORS_H, &vector_h_dimid_10)))
@@ -471,8 +462,6 @@ int main(int argc, char *argv[])
         ERR(retval);
     if ((retval = nc_def_var(ncid_g_prop, "density_to_rhombi_weights", NC_DOUBLE, 1, &vector_h_dimid_4, &density_to_rhombi_weights_id)))
         ERR(retval);
-    if ((retval = nc_def_var(ncid_g_prop, "interpol_weights", NC_DOUBLE, 1, &latlon_dimid_5, &interpol_weights_id)))
-        ERR(retval);
     if ((retval = nc_def_var(ncid_g_prop, "from_index", NC_INT, 1, &vector_h_dimid, &from_index_id)))
         ERR(retval);
     if ((retval = nc_def_var(ncid_g_prop, "to_index", NC_INT, 1, &vector_h_dimid, &to_index_id)))
@@ -483,8 +472,6 @@ int main(int argc, char *argv[])
         ERR(retval);
     if ((retval = nc_def_var(ncid_g_prop, "adjacent_vector_indices_h", NC_INT, 1, &scalar_h_dimid_6, &adjacent_vector_indices_h_id)))
         ERR(retval);
-    if ((retval = nc_def_var(ncid_g_prop, "interpol_indices", NC_INT, 1, &latlon_dimid_5, &interpol_indices_id)))
-        ERR(retval);
     if ((retval = nc_def_var(ncid_g_prop, "trsk_indices", NC_INT, 1, &vector_h_dimid_10, &trsk_indices_id)))
         ERR(retval);
     if ((retval = nc_def_var(ncid_g_prop, "trsk_modified_curl_indices", NC_INT, 1, &vector_h_dimid_10, &trsk_modified_curl_indices_id)))
@@ -569,8 +556,6 @@ int main(int argc, char *argv[])
         ERR(retval);
     if ((retval = nc_put_var_double(ncid_g_prop, density_to_rhombi_weights_id, &density_to_rhombi_weights[0])))
         ERR(retval);
-    if ((retval = nc_put_var_double(ncid_g_prop, interpol_weights_id, &interpol_weights[0])))
-        ERR(retval);
 	if ((retval = nc_put_var_double(ncid_g_prop, sfc_albedo_id, &sfc_albedo[0])))
 	  	ERR(retval);
 	if ((retval = nc_put_var_double(ncid_g_prop, sfc_rho_c_id, &sfc_rho_c[0])))
@@ -601,8 +586,6 @@ int main(int argc, char *argv[])
         ERR(retval);
     if ((retval = nc_put_var_int(ncid_g_prop, density_to_rhombi_indices_id, &density_to_rhombi_indices[0])))
         ERR(retval);
-    if ((retval = nc_put_var_int(ncid_g_prop, interpol_indices_id, &interpol_indices[0])))
-        ERR(retval);
 	if ((retval = nc_put_var_int(ncid_g_prop, is_land_id, &is_land[0])))
 	  	ERR(retval);
     if ((retval = nc_close(ncid_g_prop)))
@@ -661,8 +644,6 @@ int main(int argc, char *argv[])
     free(adjacent_signs_h);
     free(vorticity_signs_triangles);
     free(area_dual);
-	free(interpol_indices);
-	free(interpol_weights);
     return 0;
 }
 
@@ -16,6 +16,7 @@ int find_triangle_on_face_index_from_coords(int, int, int, int *);
 int find_triangle_indices_from_h_vector_index(int, int, int *, int *, int *, int *, int *, int *, int *, int *, int [][3], int [][3], int [][3]);
 int find_triangle_edge_points(int, int, int, int *, int *, int *, int *, int *, int *, int *, int [][3], int [][3], int [][3]);
 int build_icosahedron(double [], double [], int [][2], int [][3], int [][3], int [][3]);
+int sort_edge_indices(double[], double[], int, int[]);
 int generate_horizontal_generators(double [], double [], double [], double [], double [], double [], double [], int [][3], int [][3], int [][3]);
 int calc_inner_product(double [], double [], double [], int [], int [], double [], double [], double [], int []);
 int coriolis(int [], int [], int [], double [], double [], int [], double [], double [], double [], double [], double [], double [], double [], double [], double [], int [], int [], int [], double [], double [], double);
@@ -43,7 +44,6 @@ int optimize_to_scvt(double [], double [], double [], double [], int, int [][3],
 int read_horizontal_explicit(double [], double [], int [], int [], int [], int [], char [], int *);
 int write_statistics_file(double [], double [], double [], int, char [], char []);
 int direct_tangential_unity(double [], double [], double [], double [], int [], int [], double [], double);
-int interpolate_ll(double [], double [], int [], double []);
 int set_background_state(double [], double [], double [], double []);
 int set_sfc_properties(double [], double [], double [], double [], double [], double [], double [], int [], int, int);
 int find_geodetic(double, double, double, double, double, double *, double *);
@@ -68,7 +68,6 @@ double calc_triangle_area(double, double, double, double, double, double);
 int active_turn_x(double, double[], double[]);
 double calc_spherical_polygon_area(double[], double[], int);
 int find_min_dist_rel_on_line(double, double, double, double, double, double, double *);
-int sort_edge_indices(double[], double[], int, int[]);
 double find_turn_angle(double, double);
 double deg2rad(double);
 double rad2deg(double);
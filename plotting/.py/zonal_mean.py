@@ -2,6 +2,7 @@
 # Github repository: https://github.com/OpenNWP/GAME
 
 # This file is for plotting zonal means.
+# For long runs, the model can compute the zonal means itself (mean_output_steps and zonal_mean_bins in the run scripts).
 
 import matplotlib.pyplot as plt
 import toolbox.read_model_output as rmo
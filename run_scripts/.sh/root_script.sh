@@ -25,6 +25,6 @@ fi
 
 cp $game_home_dir/build/game .
 
-./game $run_span $write_out_interval $momentum_diff_h $momentum_diff_v $rad_on $prog_soil_temp $write_out_integrals $temperature_diff_h $start_year $start_month $start_day $start_hour $temperature_diff_v $run_id $orography_id $ideal_input_id $grib_output_switch $netcdf_output_switch $pressure_level_output_switch $model_level_output_switch $surface_output_switch $time_to_next_analysis $pbl_scheme $mass_diff_h $mass_diff_v $sfc_phase_trans $sfc_sensible_heat_flux
+./game $run_span $write_out_interval $momentum_diff_h $momentum_diff_v $rad_on $prog_soil_temp $write_out_integrals $temperature_diff_h $start_year $start_month $start_day $start_hour $temperature_diff_v $run_id $orography_id $ideal_input_id $grib_output_switch $netcdf_output_switch $pressure_level_output_switch $model_level_output_switch $surface_output_switch $time_to_next_analysis $pbl_scheme $mass_diff_h $mass_diff_v $sfc_phase_trans $sfc_sensible_heat_flux $rad_async $no_of_rad_threads $rad_chunk_size $rad_coarsening $rad_time_interpol $rad_sw_full_gpoints $rad_lw_full_gpoints $async_output_switch $grib_ccsds_switch $grib_bits_per_value $netcdf4_switch $netcdf_compression $netcdf_compression_level $netcdf_shuffle_switch $netcdf_time_series_switch $ugrid_output_switch $latlon_resolution $latlon_lat_min $latlon_lat_max $latlon_lon_min $latlon_lon_max $station_file $station_output_steps $output_variables $mean_output_steps $mean_output_begin $mean_output_interval $zonal_mean_bins $pressure_levels $output_keepbits $shm_output_switch $shm_output_slots $output_streams_file $no_of_output_threads
 
 cd - > /dev/null
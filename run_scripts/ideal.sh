@@ -42,17 +42,51 @@ sfc_sensible_heat_flux=1 # switch for sensible heat flux at the surface
 pbl_scheme=1 # planetary boundary layer scheme: 0: off, 1: NWP, 2: Held-Suarez
 
 # I/O
+output_streams_file=none # file defining output streams with their own intervals, products, formats, pressure levels and variables (none: one stream from the settings of this script)
 write_out_interval=86400 # every how many seconds an output file will be created; for small Earth experiments this will be rescaled proportional to the radius
 write_out_integrals=1 # If set to 1, fundamental integrals of the atmosphere will be written out at every time step.
 model_level_output_switch=0 # If set to 1, variables will be written out on model levels.
-pressure_level_output_switch=1 # If set to 1, additional output on pressure levels will be created. The pressure levels can be set in the file src/io/write_output.c.
+pressure_level_output_switch=1 # If set to 1, additional output on pressure levels will be created.
+pressure_levels=200,300,500,700,850,925 # pressure levels of the pressure level output in hPa (comma-separated list)
 surface_output_switch=1 # If set to 1, surface variables will be diagnozed and writing to separate files.
 grib_output_switch=1 # If set to 1, output will be written to grib files on a lat-lon grid.
 netcdf_output_switch=0 # If set to 1, output will be written to netcdf files on the hexagonal (and pentagonal) cell centers.
+async_output_switch=0 # If set to 1, output is written by a separate thread while the model is integrated further.
+grib_ccsds_switch=0 # If set to 1, GRIB output is packed with CCSDS (requires ecCodes with libaec).
+grib_bits_per_value=default # bits per value of the GRIB output per variable, e.g. tcdc:12,mslp:16, default: packing of the GRIB template
+output_keepbits=off # rounding of the output to a number of mantissa bits: off, default (the defaults of the output writer) or per variable, e.g. t2:12,mslp:4d (d: decimal digits)
+netcdf4_switch=0 # If set to 1, netcdf output is written in the NetCDF-4 format, chunked by layer.
+netcdf_compression=0 # compression of the netcdf output (NetCDF-4 only), 0: none, 1: deflate, 2: zstd
+netcdf_compression_level=4 # compression level, 1 - 9 for deflate, 1 - 22 for zstd
+netcdf_shuffle_switch=0 # If set to 1, the shuffle filter is applied to the netcdf output (NetCDF-4 only).
+netcdf_time_series_switch=0 # If set to 1, netcdf output is appended to one file per product (surface, pressure levels, model levels) with a time dimension.
+ugrid_output_switch=0 # If set to 1, model level output on the native grid is written to a UGRID file (one file per run).
+shm_output_switch=0 # If set to 1, model level output on the native grid is published to the shared memory segment /game_<run_id> for a consumer process on the same node.
+shm_output_slots=4 # number of output times the shared memory segment holds (ring buffer)
+latlon_resolution=0 # resolution of the lat-lon grid of the GRIB output in degrees (0: default resolution matching the model grid)
+latlon_lat_min=-90 # southern boundary of the lat-lon output domain in degrees
+latlon_lat_max=90 # northern boundary of the lat-lon output domain in degrees
+latlon_lon_min=0 # western boundary of the lat-lon output domain in degrees
+latlon_lon_max=360 # eastern boundary of the lat-lon output domain in degrees
+station_file=$game_home_dir/run_scripts/stations.txt # list of stations (name, latitude and longitude in degrees, one station per line) for the station output
+station_output_steps=0 # station output is written every station_output_steps time steps (0: no station output)
+output_variables=all # variables of the output (comma-separated list of names, e.g. mslp,t2,temperature, or all), only these are diagnosed and written
+mean_output_steps=0 # time means are accumulated every mean_output_steps time steps (0: no mean output)
+mean_output_begin=0 # time since the initialization in seconds from which on the time means are accumulated
+mean_output_interval=0 # the means are written every mean_output_interval seconds (0: only at the end of the run)
+zonal_mean_bins=0 # number of latitude bins of the zonal means of the mean output (0: no zonal means)
 time_to_next_analysis=-1 # the time between this model run and the next analysis, only relevant in NWP runs for data assimilation
 
 # parallelization
 export OMP_NUM_THREADS=4 # relevant for OMP
+rad_async=0 # If set to 1, radiation is computed by a separate thread team while the dynamics is integrated further, the new fluxes are used from the next time step on.
+no_of_rad_threads=2 # the number of OMP threads of the radiation thread team, only relevant if rad_async=1 (these come in addition to OMP_NUM_THREADS)
+no_of_output_threads=1 # the number of OMP threads of the output thread, only relevant if async_output_switch=1 (these come in addition to OMP_NUM_THREADS)
+rad_chunk_size=0 # the number of columns per radiation chunk, 0 means it is chosen automatically from the number of threads and the cache size
+rad_coarsening=0 # the number of resolution levels the radiation grid is coarser than the model grid (0, 1 or 2)
+rad_time_interpol=0 # If set to 1, the radiative heating is interpolated in time between radiation updates (long wave: linear extrapolation, short wave: zenith angle scaling).
+rad_sw_full_gpoints=0 # If set to 1, the full short wave k-distribution of RTE+RRTMGP (224 g-points) is used instead of the reduced one (112 g-points).
+rad_lw_full_gpoints=0 # If set to 1, the full long wave k-distribution of RTE+RRTMGP (256 g-points) is used instead of the reduced one (128 g-points).
 
 # that's it, now the basic run script will be sourced
 source $game_home_dir/run_scripts/.sh/root_script.sh
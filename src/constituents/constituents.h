@@ -22,3 +22,4 @@ double gas_constant_diagnostics(State *, int, Config *);
 double density_total(State *, int);
 double calc_diffusion_coeff(double, double);
 int temperature_diagnostics(State *, Grid *, Diagnostics *);
+double temperature_diagnostics_point(State *, Grid *, int);
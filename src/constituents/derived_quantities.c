@@ -18,25 +18,29 @@ int temperature_diagnostics(State *state, Grid *grid, Diagnostics *diagnostics)
 	This function diagnoses the temperature of the gas phase.
 	*/
 	
-	if (MOISTURE_ON == 0)
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_SCALARS; ++i)
 	{
-		#pragma omp parallel for
-		for (int i = 0; i < NO_OF_SCALARS; ++i)
-		{
-			diagnostics -> temperature[i] = (grid -> theta_v_bg[i] + state -> theta_v_pert[i])*(grid -> exner_bg[i] + state -> exner_pert[i]);
-		}
+		diagnostics -> temperature[i] = temperature_diagnostics_point(state, grid, i);
 	}
+	
+	return 0;
+}
+
+double temperature_diagnostics_point(State *state, Grid *grid, int grid_point_index)
+{
+	/*
+	This function diagnoses the temperature of the gas phase at one grid point.
+	*/
+	
+	double result = (grid -> theta_v_bg[grid_point_index] + state -> theta_v_pert[grid_point_index])
+	*(grid -> exner_bg[grid_point_index] + state -> exner_pert[grid_point_index]);
 	if (MOISTURE_ON == 1)
 	{
-		#pragma omp parallel for
-		for (int i = 0; i < NO_OF_SCALARS; ++i)
-		{
-			diagnostics -> temperature[i] = (grid -> theta_v_bg[i] + state -> theta_v_pert[i])*(grid -> exner_bg[i] + state -> exner_pert[i])
-			/(1.0 + state -> rho[(NO_OF_CONDENSED_CONSTITUENTS + 1)*NO_OF_SCALARS + i]/state -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + i]*(M_D/M_V - 1.0));
-		}
+		result = result/(1.0 + state -> rho[(NO_OF_CONDENSED_CONSTITUENTS + 1)*NO_OF_SCALARS + grid_point_index]
+		/state -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + grid_point_index]*(M_D/M_V - 1.0));
 	}
-	
-	return 0;
+	return result;
 }
 
 double gas_constant_diagnostics(State *state, int grid_point_index, Config *config)
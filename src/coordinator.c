@@ -44,12 +44,21 @@ int main(int argc, char *argv[])
     State *state_new = calloc(1, sizeof(State));
     State *state_tendency = calloc(1, sizeof(State));
     State *state_old = calloc(1, sizeof(State));
+    Async_radiation *async_radiation = calloc(1, sizeof(Async_radiation));
+    // the coarse radiation grid is only allocated if the radiation is coarsened, NULL is handed to the radiation otherwise
+    Radiation_grid *radiation_grid = NULL;
+    // the buffer of the output thread holds a copy of the state and the diagnostics, so it is only allocated if it is used
+    Async_output *async_output = NULL;
     
     /*
     reading command line input
     --------------------------
     */
 	read_argv(argc, argv, config, config_io, grid, irrev);
+	if (config_io -> async_output_switch == 1)
+	{
+		async_output = calloc(1, sizeof(Async_output));
+	}
 	// setting the implicit weight of the thermodynamic vertical time stepping
 	config -> impl_thermo_weight = 0.75;
 	// setting hte vertical swamp layer properties
@@ -130,6 +139,12 @@ int main(int argc, char *argv[])
     double radius_rescale = grid -> radius/RADIUS;
     config -> total_run_span = radius_rescale*config -> total_run_span;
     config_io -> write_out_interval = radius_rescale*config_io -> write_out_interval;
+    config_io -> mean_output_begin = radius_rescale*config_io -> mean_output_begin;
+    config_io -> mean_output_interval = radius_rescale*config_io -> mean_output_interval;
+    
+    // the output streams, every one of them is written by write_out on its own schedule
+    Config_io *output_streams = calloc(MAX_NO_OF_OUTPUT_STREAMS, sizeof(Config_io));
+    int no_of_output_streams = set_output_streams(config_io, output_streams, config, radius_rescale);
     
     /*
     Giving the user some additional information on the run to about to be executed.
@@ -261,18 +276,67 @@ int main(int argc, char *argv[])
     {
     	if (config -> rad_on == 1)
     	{
-    		radiation_init();
+    		int no_of_rad_workspaces = get_no_of_rad_workspaces(config);
+    		radiation_init(&no_of_rad_workspaces, &config -> rad_sw_full_gpoints, &config -> rad_lw_full_gpoints);
+    	}
+    	if (config -> rad_coarsening > 0)
+    	{
+    		radiation_grid = calloc(1, sizeof(Radiation_grid));
+    		set_radiation_grid(grid, config, radiation_grid);
     	}
-    	call_radiation(state_old, grid, dualgrid, state_tendency, diagnostics, forcings, irrev, config, delta_t, t_0);
+    	call_radiation(state_old, grid, radiation_grid, dualgrid, state_tendency, diagnostics, forcings, irrev, config, delta_t, t_0);
     	config -> rad_update = 1;
     	t_rad_update += config -> radiation_delta_t;
     }
     
-    // writing out the initial state of the model run
-    write_out(state_old, wind_h_lowest_layer, min_no_of_10m_wind_avg_steps, t_init, t_write,
-    diagnostics, forcings, grid, dualgrid, config_io, config, irrev);
+    // the GRIB template is read only once, the interpolation to the lat-lon grid of the GRIB output is computed only once
+    int grib_output_bool = 0;
+    for (int i = 0; i < no_of_output_streams; ++i)
+    {
+    	grib_output_bool = grib_output_bool || output_streams[i].grib_output_switch == 1;
+    }
+    if (grib_output_bool == 1)
+    {
+    	read_grib_template();
+    	set_latlon_grid(&grid -> latlon_grid, grid, config_io);
+    }
+    // the UGRID output file is created and the mesh is written only once
+    if (config_io -> ugrid_output_switch == 1)
+    {
+    	init_ugrid_output(grid_file, grid, dualgrid, config_io);
+    }
+    // the shared memory segment of the output is created and the coordinates are written only once
+    if (config_io -> shm_output_switch == 1)
+    {
+    	init_shm_output(grid, config_io);
+    }
+    // the station list is read and the station output file is created only once
+    if (config_io -> station_output_steps > 0)
+    {
+    	init_station_output(grid, config_io);
+    	write_station_output(0, state_old, forcings, grid, config, 1);
+    }
+    // the running sums of the time means and the latitude bins of the zonal means are set up only once
+    double t_write_means = t_init + config_io -> mean_output_begin + config_io -> mean_output_interval;
+    if (config_io -> mean_output_steps > 0)
+    {
+    	init_mean_output(grid, config_io);
+    }
     
-    t_write += config_io -> write_out_interval;
+    // writing out the initial state of the model run, all output streams begin with it
+    double t_write_streams[MAX_NO_OF_OUTPUT_STREAMS];
+    Config_io *due_output_streams[MAX_NO_OF_OUTPUT_STREAMS];
+    int no_of_due_output_streams;
+    for (int i = 0; i < no_of_output_streams; ++i)
+    {
+    	write_out(state_old, wind_h_lowest_layer, min_no_of_10m_wind_avg_steps, t_init, t_write,
+    	diagnostics, forcings, grid, dualgrid, &output_streams[i], config, irrev);
+    	t_write_streams[i] = t_init + output_streams[i].write_out_interval;
+    }
+    
+    // the next time at which at least one output stream is written, the wind in the lowest layer is collected for all streams together
+    double t_last_write = t_write;
+    t_write = get_next_output_time(t_write_streams, no_of_output_streams);
     printf("Run progress: %f h\n", (t_init - t_init)/3600);
     int time_step_counter = 0;
     clock_t first_time, second_time;
@@ -318,8 +382,26 @@ int main(int argc, char *argv[])
         	config -> rad_update = 0;
     	}
     	
+    	/*
+    	Asynchronous radiation:
+    	-----------------------
+    	*/
+    	if (config -> rad_on > 0 && config -> rad_async == 1)
+    	{
+    		// the results of a running radiation update are swapped in at the first step boundary after the radiation thread is done
+    		async_radiation_finished(async_radiation, forcings);
+    		// a new snapshot of the model state is handed over to the radiation thread
+    		if (config -> rad_update == 1)
+    		{
+    			// only now the model waits for a radiation update which is still running
+    			finish_async_radiation(async_radiation, forcings);
+    			temperature_diagnostics(state_old, grid, diagnostics);
+    			start_async_radiation(state_old, grid, radiation_grid, diagnostics, async_radiation, config, t_0);
+    		}
+    	}
+    	
     	// Time step integration.
-    	manage_rkhevi(state_old, state_new, grid, dualgrid, state_tendency, diagnostics, forcings, irrev, config, delta_t, t_0);
+    	manage_rkhevi(state_old, state_new, grid, radiation_grid, dualgrid, state_tendency, diagnostics, forcings, irrev, config, delta_t, t_0);
     	// This switch can be set to zero now and remains there.
     	config -> totally_first_step_bool = 0;
 		time_step_counter += 1;	
@@ -335,6 +417,33 @@ int main(int argc, char *argv[])
 			write_out_integral(state_new, t_0 + delta_t - t_init, grid, dualgrid, diagnostics, 2);
     	}
     	
+    	/*
+    	Writing the station output if requested by the user.
+    	----------------------------------------------------
+    	*/
+    	if (config_io -> station_output_steps > 0 && time_step_counter % config_io -> station_output_steps == 0)
+    	{
+    		// the records are only written to the file if the output thread is not using the netcdf library
+    		write_station_output(t_0 + delta_t - t_init, state_new, forcings, grid, config, async_output_finished(async_output));
+    	}
+    	
+    	/*
+    	Accumulating the time means if requested by the user.
+    	-----------------------------------------------------
+    	*/
+    	if (config_io -> mean_output_steps > 0 && time_step_counter % config_io -> mean_output_steps == 0
+    	&& t_0 + delta_t >= t_init + config_io -> mean_output_begin)
+    	{
+    		accumulate_mean_output(t_0 + delta_t - t_init, state_new, grid, config);
+    	}
+    	if (config_io -> mean_output_steps > 0 && config_io -> mean_output_interval > 0 && t_0 + delta_t >= t_write_means)
+    	{
+    		// the netcdf library must not be used by two threads at the same time
+    		finish_async_output(async_output);
+    		write_mean_output(t_0 + delta_t - t_init, grid, config_io);
+    		t_write_means += config_io -> mean_output_interval;
+    	}
+    	
     	/*
     	Writing the actual output.
     	--------------------------
@@ -361,19 +470,43 @@ int main(int argc, char *argv[])
         // 5 minutes after the output time, the 10 m wind diagnostics can be executed, so output can actually be written
         if(t_0 + delta_t >= t_write + radius_rescale*300 && t_0 <= t_write + radius_rescale*300)
         {
+        	// the output streams which are due at this output time, their next output times are set
+        	no_of_due_output_streams = 0;
+        	for (int i = 0; i < no_of_output_streams; ++i)
+        	{
+        		if (t_write_streams[i] == t_write)
+        		{
+        			due_output_streams[no_of_due_output_streams] = &output_streams[i];
+        			++no_of_due_output_streams;
+        			t_write_streams[i] += output_streams[i].write_out_interval;
+        		}
+        	}
         	// here, output is actually written
-            write_out(state_write, wind_h_lowest_layer, min_no_of_10m_wind_avg_steps, t_init, t_write, diagnostics, forcings,
-            grid, dualgrid, config_io, config, irrev);
-            // setting the next output time
-            t_write += config_io -> write_out_interval;
+        	if (config_io -> async_output_switch == 1)
+        	{
+        		start_async_output(state_write, wind_h_lowest_layer, min_no_of_10m_wind_avg_steps, t_init, t_write, diagnostics, forcings,
+        		grid, dualgrid, due_output_streams, no_of_due_output_streams, config, irrev, async_output);
+        	}
+        	else
+        	{
+        		for (int i = 0; i < no_of_due_output_streams; ++i)
+        		{
+        			write_out(state_write, wind_h_lowest_layer, min_no_of_10m_wind_avg_steps, t_init, t_write, diagnostics, forcings,
+        			grid, dualgrid, due_output_streams[i], config, irrev);
+        		}
+        	}
             
             // Calculating the speed of the model.
             second_time = clock();
-        	speed = CLOCKS_PER_SEC*config_io -> write_out_interval/((double) second_time - first_time);
+        	speed = CLOCKS_PER_SEC*(t_write - t_last_write)/((double) second_time - first_time);
             printf("Current speed: %lf\n", speed);
             first_time = clock();
             printf("Run progress: %f h\n", (t_0 + delta_t - t_init)/3600);
             
+            // setting the next output time
+            t_last_write = t_write;
+            t_write = get_next_output_time(t_write_streams, no_of_output_streams);
+            
             // resetting the wind in the lowest layer to zero
             #pragma omp parallel for
             for (int i = 0; i < min_no_of_10m_wind_avg_steps*NO_OF_VECTORS_H; ++i)
@@ -393,7 +526,27 @@ int main(int argc, char *argv[])
     Clean-up.
     ---------
     */
+    finish_async_radiation(async_radiation, NULL);
+    free(async_radiation);
+    if (config_io -> async_output_switch == 1)
+    {
+    	finish_async_output(async_output);
+    	free(async_output -> wind_h_lowest_layer);
+    	free(async_output);
+    }
+    free_grib_template();
+    free_latlon_grid(&grid -> latlon_grid);
+    close_netcdf_time_series();
+    close_ugrid_output();
+    close_shm_output();
+    close_station_output();
+    close_mean_output(t_0 - t_init, grid, config_io);
+    if (radiation_grid != NULL)
+    {
+    	free(radiation_grid);
+    }
     free(irrev);
+    free(output_streams);
     free(config_io);
     free(diagnostics);
     free(forcings);
@@ -473,6 +626,48 @@ int sanity_checker(Config *config, Config_io *config_io, Grid *grid)
     	printf("Aborting.\n");
 		exit(1);
 	}
+	if (config -> rad_async != 0 && config -> rad_async != 1)
+	{
+		printf("rad_async must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config -> rad_async == 1 && config -> no_of_rad_threads < 1)
+	{
+		printf("no_of_rad_threads must be at least 1 if rad_async is set to 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config -> rad_chunk_size < 0)
+	{
+		printf("rad_chunk_size must be >= 0.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config -> rad_coarsening != 0 && config -> rad_coarsening != 1 && config -> rad_coarsening != 2)
+	{
+		printf("rad_coarsening must be either 0, 1 or 2.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config -> rad_time_interpol != 0 && config -> rad_time_interpol != 1)
+	{
+		printf("rad_time_interpol must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config -> rad_sw_full_gpoints != 0 && config -> rad_sw_full_gpoints != 1)
+	{
+		printf("rad_sw_full_gpoints must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config -> rad_lw_full_gpoints != 0 && config -> rad_lw_full_gpoints != 1)
+	{
+		printf("rad_lw_full_gpoints must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
 	if (config -> prog_soil_temp != 0 && config -> prog_soil_temp != 1)
 	{
 		printf("prog_soil_temp must be either 0 or 1.\n");
@@ -521,9 +716,134 @@ int sanity_checker(Config *config, Config_io *config_io, Grid *grid)
     	printf("Aborting.\n");
 		exit(1);
 	}
-	if (config_io -> grib_output_switch == 0 && config_io -> netcdf_output_switch == 0)
+	if (config_io -> async_output_switch != 0 && config_io -> async_output_switch != 1)
+	{
+		printf("async_output_switch must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> async_output_switch == 1 && config_io -> no_of_output_threads < 1)
+	{
+		printf("no_of_output_threads must be at least 1 if async_output_switch is set to 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> grib_ccsds_switch != 0 && config_io -> grib_ccsds_switch != 1)
+	{
+		printf("grib_ccsds_switch must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	check_grib_bits_per_value(config_io -> grib_bits_per_value);
+	check_output_variables(config_io -> output_variables);
+	check_output_keepbits(config_io -> output_keepbits);
+	if (config_io -> netcdf4_switch != 0 && config_io -> netcdf4_switch != 1)
+	{
+		printf("netcdf4_switch must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> netcdf_compression != 0 && config_io -> netcdf_compression != 1 && config_io -> netcdf_compression != 2)
+	{
+		printf("netcdf_compression must be either 0, 1 or 2.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> netcdf_shuffle_switch != 0 && config_io -> netcdf_shuffle_switch != 1)
+	{
+		printf("netcdf_shuffle_switch must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> netcdf_time_series_switch != 0 && config_io -> netcdf_time_series_switch != 1)
+	{
+		printf("netcdf_time_series_switch must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> ugrid_output_switch != 0 && config_io -> ugrid_output_switch != 1)
+	{
+		printf("ugrid_output_switch must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> shm_output_switch != 0 && config_io -> shm_output_switch != 1)
+	{
+		printf("shm_output_switch must be either 0 or 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> shm_output_switch == 1 && config_io -> shm_output_slots < 1)
+	{
+		printf("shm_output_slots must be positive if shm_output_switch is 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> station_output_steps < 0)
+	{
+		printf("station_output_steps must not be negative.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> mean_output_steps < 0)
+	{
+		printf("mean_output_steps must not be negative.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> mean_output_begin < 0 || config_io -> mean_output_interval < 0)
+	{
+		printf("mean_output_begin and mean_output_interval must not be negative.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> zonal_mean_bins < 0)
+	{
+		printf("zonal_mean_bins must not be negative.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> latlon_resolution < 0)
+	{
+		printf("latlon_resolution must not be negative.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> latlon_lat_min < -90 || config_io -> latlon_lat_max > 90 || config_io -> latlon_lat_min >= config_io -> latlon_lat_max)
 	{
-		printf("Either grib_output_switch or netcdf_output_switch must be set to 1.\n");
+		printf("latlon_lat_min and latlon_lat_max must fulfill -90 <= latlon_lat_min < latlon_lat_max <= 90.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> latlon_lon_min < -180 || config_io -> latlon_lon_max > 360 || config_io -> latlon_lon_min >= config_io -> latlon_lon_max
+	|| config_io -> latlon_lon_max - config_io -> latlon_lon_min > 360)
+	{
+		printf("latlon_lon_min and latlon_lon_max must fulfill -180 <= latlon_lon_min < latlon_lon_max <= 360 and span at most 360 degrees.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> netcdf4_switch == 0 && (config_io -> netcdf_compression != 0 || config_io -> netcdf_shuffle_switch == 1))
+	{
+		printf("Compression and shuffling of the netcdf output require netcdf4_switch = 1.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> netcdf_compression == 1 && (config_io -> netcdf_compression_level < 1 || config_io -> netcdf_compression_level > 9))
+	{
+		printf("netcdf_compression_level must be between 1 and 9 for deflate.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> netcdf_compression == 2 && (config_io -> netcdf_compression_level < 1 || config_io -> netcdf_compression_level > 22))
+	{
+		printf("netcdf_compression_level must be between 1 and 22 for zstd.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+	if (config_io -> grib_output_switch == 0 && config_io -> netcdf_output_switch == 0 && config_io -> ugrid_output_switch == 0
+	&& config_io -> shm_output_switch == 0)
+	{
+		printf("Either grib_output_switch, netcdf_output_switch, ugrid_output_switch or shm_output_switch must be set to 1.\n");
     	printf("Aborting.\n");
 		exit(1);
 	}
@@ -634,6 +954,104 @@ int read_argv(int argc, char *argv[], Config *config, Config_io *config_io, Grid
 	config -> sfc_phase_trans = strtod(argv[agv_counter], NULL);
     argv++;
 	config -> sfc_sensible_heat_flux = strtod(argv[agv_counter], NULL);
+    argv++;
+	config -> rad_async = strtod(argv[agv_counter], NULL);
+    argv++;
+	config -> no_of_rad_threads = strtod(argv[agv_counter], NULL);
+    argv++;
+	config -> rad_chunk_size = strtod(argv[agv_counter], NULL);
+    argv++;
+	config -> rad_coarsening = strtod(argv[agv_counter], NULL);
+    argv++;
+	config -> rad_time_interpol = strtod(argv[agv_counter], NULL);
+    argv++;
+	config -> rad_sw_full_gpoints = strtod(argv[agv_counter], NULL);
+    argv++;
+	config -> rad_lw_full_gpoints = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> async_output_switch = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> grib_ccsds_switch = strtod(argv[agv_counter], NULL);
+    argv++;
+	if (strlen(argv[agv_counter]) >= sizeof(config_io -> grib_bits_per_value))
+	{
+		printf("grib_bits_per_value is too long.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+    strcpy(config_io -> grib_bits_per_value, argv[agv_counter]);
+    argv++;
+	config_io -> netcdf4_switch = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> netcdf_compression = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> netcdf_compression_level = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> netcdf_shuffle_switch = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> netcdf_time_series_switch = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> ugrid_output_switch = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> latlon_resolution = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> latlon_lat_min = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> latlon_lat_max = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> latlon_lon_min = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> latlon_lon_max = strtod(argv[agv_counter], NULL);
+    argv++;
+	if (strlen(argv[agv_counter]) >= sizeof(config_io -> station_file))
+	{
+		printf("station_file is too long.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+    strcpy(config_io -> station_file, argv[agv_counter]);
+    argv++;
+	config_io -> station_output_steps = strtod(argv[agv_counter], NULL);
+    argv++;
+	if (strlen(argv[agv_counter]) >= sizeof(config_io -> output_variables))
+	{
+		printf("output_variables is too long.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+    strcpy(config_io -> output_variables, argv[agv_counter]);
+    argv++;
+	config_io -> mean_output_steps = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> mean_output_begin = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> mean_output_interval = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> zonal_mean_bins = strtod(argv[agv_counter], NULL);
+    argv++;
+	set_pressure_levels(argv[agv_counter], config_io);
+    argv++;
+	if (strlen(argv[agv_counter]) >= sizeof(config_io -> output_keepbits))
+	{
+		printf("output_keepbits is too long.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+    strcpy(config_io -> output_keepbits, argv[agv_counter]);
+    argv++;
+	config_io -> shm_output_switch = strtod(argv[agv_counter], NULL);
+    argv++;
+	config_io -> shm_output_slots = strtod(argv[agv_counter], NULL);
+    argv++;
+	if (strlen(argv[agv_counter]) >= sizeof(config_io -> output_streams_file))
+	{
+		printf("output_streams_file is too long.\n");
+    	printf("Aborting.\n");
+		exit(1);
+	}
+    strcpy(config_io -> output_streams_file, argv[agv_counter]);
+    argv++;
+	config_io -> no_of_output_threads = strtod(argv[agv_counter], NULL);
     argv++;
 	return 0;
 }
@@ -743,6 +1161,42 @@ int readback_config(Config *config, Config_io *config_io, Grid *grid, char grid_
 	{
 		printf("Held-Suarez radiation forcing is turned on.\n");
 	}
+	if (config -> rad_on > 0 && config -> rad_async == 1)
+	{
+		printf("Radiation is computed asynchronously on %d threads.\n", config -> no_of_rad_threads);
+	}
+	if (config -> rad_on > 0 && config -> rad_chunk_size == 0)
+	{
+		printf("The number of columns per radiation chunk is determined automatically.\n");
+	}
+	if (config -> rad_on > 0 && config -> rad_chunk_size > 0)
+	{
+		printf("Number of columns per radiation chunk: %d\n", config -> rad_chunk_size);
+	}
+	if (config -> rad_on > 0 && config -> rad_coarsening > 0)
+	{
+		printf("Radiation is computed on a grid with resolution ID %d.\n", RES_ID - config -> rad_coarsening);
+	}
+	if (config -> rad_on == 1 && config -> rad_time_interpol == 1)
+	{
+		printf("The radiative heating is interpolated in time between radiation updates.\n");
+	}
+	if (config -> rad_on == 1 && config -> rad_sw_full_gpoints == 1)
+	{
+		printf("The full short wave k-distribution is used.\n");
+	}
+	if (config -> rad_on == 1 && config -> rad_sw_full_gpoints == 0)
+	{
+		printf("The reduced short wave k-distribution is used.\n");
+	}
+	if (config -> rad_on == 1 && config -> rad_lw_full_gpoints == 1)
+	{
+		printf("The full long wave k-distribution is used.\n");
+	}
+	if (config -> rad_on == 1 && config -> rad_lw_full_gpoints == 0)
+	{
+		printf("The reduced long wave k-distribution is used.\n");
+	}
 	if (config -> pbl_scheme == 0)
 	{
 		printf("Boundary layer friction is turned off.\n");
@@ -826,6 +1280,112 @@ int readback_config(Config *config, Config_io *config_io, Grid *grid, char grid_
 	else
 	{
 		printf("Pressure level output is turned on.\n");
+		printf("Pressure levels:\t\t\t");
+		for (int i = 0; i < config_io -> no_of_pressure_levels; ++i)
+		{
+			printf(" %lf", 0.01*config_io -> pressure_levels[i]);
+		}
+		printf(" hPa\n");
+	}
+	if (config_io -> async_output_switch == 0)
+	{
+		printf("Output is written synchronously.\n");
+	}
+	else
+	{
+		printf("Output is written asynchronously by a separate thread with %d OMP threads.\n", config_io -> no_of_output_threads);
+	}
+	if (strcmp(config_io -> output_keepbits, "off") == 0)
+	{
+		printf("The output is not rounded.\n");
+	}
+	else
+	{
+		printf("Mantissa bits of the output:\t\t%s\n", config_io -> output_keepbits);
+	}
+	if (config_io -> grib_output_switch == 1)
+	{
+		if (config_io -> grib_ccsds_switch == 0)
+		{
+			printf("GRIB output uses the packing of the GRIB template.\n");
+		}
+		else
+		{
+			printf("GRIB output uses CCSDS packing.\n");
+		}
+		printf("Bits per value of the GRIB output:\t%s\n", config_io -> grib_bits_per_value);
+		if (config_io -> latlon_resolution == 0)
+		{
+			printf("Resolution of the lat-lon output grid:\tdefault (%lf degrees)\n", 360.0/NO_OF_LON_IO_POINTS);
+		}
+		else
+		{
+			printf("Resolution of the lat-lon output grid:\t%lf degrees\n", config_io -> latlon_resolution);
+		}
+		printf("Lat-lon output domain:\t\t\t%lf to %lf degrees latitude, %lf to %lf degrees longitude\n", config_io -> latlon_lat_min,
+		config_io -> latlon_lat_max, config_io -> latlon_lon_min, config_io -> latlon_lon_max);
+	}
+	if (config_io -> netcdf_output_switch == 1)
+	{
+		if (config_io -> netcdf4_switch == 0)
+		{
+			printf("Netcdf output is written in the classic format.\n");
+		}
+		else
+		{
+			printf("Netcdf output is written in the NetCDF-4 format, chunked by layer.\n");
+			if (config_io -> netcdf_compression == 1)
+			{
+				printf("Netcdf output is compressed with deflate, level %d.\n", config_io -> netcdf_compression_level);
+			}
+			if (config_io -> netcdf_compression == 2)
+			{
+				printf("Netcdf output is compressed with zstd, level %d.\n", config_io -> netcdf_compression_level);
+			}
+			if (config_io -> netcdf_shuffle_switch == 1)
+			{
+				printf("The shuffle filter is applied to the netcdf output.\n");
+			}
+		}
+		if (config_io -> netcdf_time_series_switch == 1)
+		{
+			printf("Netcdf output is appended to one time series file per product.\n");
+		}
+	}
+	printf("Output variables:\t\t\t%s\n", config_io -> output_variables);
+	if (strcmp(config_io -> output_streams_file, "none") != 0)
+	{
+		printf("The output streams are read from %s, they replace the output interval, the products, the formats and the variables above.\n",
+		config_io -> output_streams_file);
+	}
+	if (config_io -> ugrid_output_switch == 1)
+	{
+		printf("Output on the native grid is written to a UGRID file.\n");
+	}
+	if (config_io -> shm_output_switch == 1)
+	{
+		printf("Output on the native grid is published to a shared memory segment with %d slots.\n", config_io -> shm_output_slots);
+	}
+	if (config_io -> station_output_steps > 0)
+	{
+		printf("Station output is written every %d time steps for the stations in %s.\n", config_io -> station_output_steps, config_io -> station_file);
+	}
+	if (config_io -> mean_output_steps > 0)
+	{
+		printf("Time means are accumulated every %d time steps, beginning %lf s after the initialization.\n", config_io -> mean_output_steps,
+		config_io -> mean_output_begin);
+		if (config_io -> mean_output_interval == 0)
+		{
+			printf("The means are written at the end of the run.\n");
+		}
+		else
+		{
+			printf("The means are written every %lf s.\n", config_io -> mean_output_interval);
+		}
+		if (config_io -> zonal_mean_bins > 0)
+		{
+			printf("Zonal means are computed in %d latitude bins.\n", config_io -> zonal_mean_bins);
+		}
 	}
 	printf("%s", stars);
 	printf("Model is fully configured now. Starting to read external data.\n");
@@ -8,6 +8,7 @@ In this file, integer constants and types are defined.
 */
 
 #include <math.h>
+#include <pthread.h>
 
 enum grid_integers {
 // This determines the horizontal resolution.
@@ -18,9 +19,6 @@ NO_OF_LAYERS = 26,
 MOISTURE_ON = 1,
 // the number of soil layers
 NO_OF_SOIL_LAYERS = 5,
-// the number of blocks into which the arrays will be split up for the radiation calculation
-// (NO_OF_SCALARS_H must be divisible by this number)
-NO_OF_RAD_BLOCKS = 18,
 
 /*
 Nothing should be changed by the user below this line.
@@ -43,8 +41,6 @@ NO_OF_VECTORS_PER_LAYER = NO_OF_VECTORS_H + NO_OF_SCALARS_H,
 NO_OF_TRIANGLES = (int) (NO_OF_BASIC_TRIANGLES*(pow(4, RES_ID))),
 NO_OF_SCALARS = NO_OF_SCALARS_H*NO_OF_LAYERS,
 NO_OF_VECTORS = NO_OF_H_VECTORS + NO_OF_V_VECTORS,
-NO_OF_SCALARS_RAD = NO_OF_SCALARS/NO_OF_RAD_BLOCKS,
-NO_OF_SCALARS_RAD_PER_LAYER = NO_OF_SCALARS_RAD/NO_OF_LAYERS,
 NO_OF_DUAL_SCALARS_H = NO_OF_TRIANGLES,
 NO_OF_DUAL_H_VECTORS = NO_OF_LEVELS*NO_OF_VECTORS_H,
 NO_OF_DUAL_V_VECTORS = NO_OF_LAYERS*NO_OF_DUAL_SCALARS_H,
@@ -57,7 +53,10 @@ NO_OF_LATLON_IO_POINTS = NO_OF_LON_IO_POINTS*NO_OF_LAT_IO_POINTS,
 POINTS_PER_EDGE = (int) (pow(2, RES_ID) - 1),
 TRIANGLES_PER_FACE = NO_OF_TRIANGLES/NO_OF_BASIC_TRIANGLES,
 SCALAR_POINTS_PER_INNER_FACE = (int) (0.5*(pow(2, RES_ID) - 2)*(pow(2, RES_ID) - 1)),
-VECTOR_POINTS_PER_INNER_FACE = (int) (1.5*(pow(2, RES_ID) - 1)*pow(2, RES_ID))};
+VECTOR_POINTS_PER_INNER_FACE = (int) (1.5*(pow(2, RES_ID) - 1)*pow(2, RES_ID)),
+// the maximum number of pressure levels of the pressure level output
+MAX_NO_OF_PRESSURE_LEVELS = 100,
+MAX_NO_OF_OUTPUT_STREAMS = 10};
 
 typedef double Scalar_field[NO_OF_SCALARS];
 typedef double Vector_field[NO_OF_VECTORS];
@@ -66,6 +65,18 @@ typedef double Curl_field[NO_OF_LAYERS*2*NO_OF_VECTORS_H + NO_OF_VECTORS_H];
 // all constituents have a mass density
 typedef double Mass_densities[NO_OF_CONSTITUENTS*NO_OF_SCALARS];
 
+// A lat-lon grid the output is interpolated to, it is set up at runtime.
+typedef struct latlon_grid {
+int no_of_lat_points;
+int no_of_lon_points;
+double lat_first; // latitude of the northernmost row of points (rad)
+double lon_first; // longitude of the westernmost column of points (rad)
+double delta_lat;
+double delta_lon;
+int *interpol_indices;
+double *interpol_weights;
+} Latlon_grid;
+
 // Contains properties of the primal grid.
 typedef struct grid {
 int no_of_oro_layers;
@@ -99,8 +110,7 @@ double sfc_rho_c[NO_OF_SCALARS_H];
 double t_conduc_soil[NO_OF_SCALARS_H];
 double roughness_length[NO_OF_SCALARS_H];
 int is_land[NO_OF_SCALARS_H];
-int latlon_interpol_indices[5*NO_OF_LATLON_IO_POINTS];
-double latlon_interpol_weights[5*NO_OF_LATLON_IO_POINTS];
+Latlon_grid latlon_grid;
 double z_soil_interface[NO_OF_SOIL_LAYERS + 1];
 double z_soil_center[NO_OF_SOIL_LAYERS];
 double mean_velocity_area;
@@ -161,21 +171,6 @@ double roughness_velocity[NO_OF_SCALARS_H];
 double monin_obukhov_length[NO_OF_SCALARS_H];
 } Diagnostics;
 
-// needed for the radiation calculation
-typedef struct radiation {
-double lat_scal[NO_OF_SCALARS_RAD_PER_LAYER];
-double lon_scal[NO_OF_SCALARS_RAD_PER_LAYER];
-double sfc_sw_in[NO_OF_SCALARS_RAD_PER_LAYER];
-double sfc_lw_out[NO_OF_SCALARS_RAD_PER_LAYER];
-double sfc_albedo[NO_OF_SCALARS_RAD_PER_LAYER];
-double temp_sfc[NO_OF_SCALARS_RAD_PER_LAYER];
-double z_scal[NO_OF_SCALARS_RAD];
-double z_vect[NO_OF_SCALARS_RAD + NO_OF_SCALARS_RAD_PER_LAYER];
-double rho[NO_OF_CONSTITUENTS*NO_OF_SCALARS_RAD];
-double temp[NO_OF_SCALARS_RAD];
-double rad_tend[NO_OF_SCALARS_RAD];
-} Radiation;
-
 // Collects forcings.
 typedef struct forcings {
 Vector_field pgrad_acc_old;
@@ -187,6 +182,20 @@ Vector_field pot_vort_tend;
 double sfc_sw_in[NO_OF_SCALARS_H];
 double sfc_lw_out[NO_OF_SCALARS_H];
 Scalar_field radiation_tendency;
+Scalar_field radiation_tendency_sw;
+// the latest two radiation updates, only used if rad_time_interpol is 1
+int no_of_rad_results;
+double t_rad;
+double t_rad_old;
+Scalar_field rad_tend_sw;
+Scalar_field rad_tend_lw;
+Scalar_field rad_tend_lw_old;
+double rad_sfc_sw_in[NO_OF_SCALARS_H];
+double rad_sfc_lw_out[NO_OF_SCALARS_H];
+double rad_sfc_lw_out_old[NO_OF_SCALARS_H];
+double rad_cos_zenith[NO_OF_SCALARS_H];
+// the column whose short wave heating per cosine of the zenith angle is used (the column itself or the nearest column that was lit at the latest update)
+int rad_sw_donor[NO_OF_SCALARS_H];
 } Forcings;
 
 // Info on the run configuration is collected here.
@@ -203,6 +212,13 @@ int prog_soil_temp;
 int sfc_phase_trans;
 int sfc_sensible_heat_flux;
 int rad_update;
+int rad_async;
+int no_of_rad_threads;
+int rad_chunk_size;
+int rad_coarsening;
+int rad_time_interpol;
+int rad_sw_full_gpoints;
+int rad_lw_full_gpoints;
 int time_to_next_analysis;
 int pbl_scheme;
 int total_run_span;
@@ -215,6 +231,44 @@ double snow_velocity;
 double radiation_delta_t;
 } Config;
 
+// a grid coarser than the model grid the radiation can be computed on (only the first no_of_columns columns of the fields are used)
+typedef struct radiation_grid {
+int no_of_columns;
+int coarse_index[NO_OF_SCALARS_H]; // the radiation column every cell of the model grid belongs to
+int fine_cells_start[NO_OF_SCALARS_H + 1];
+int fine_cells[NO_OF_SCALARS_H]; // the cells of the model grid belonging to a radiation column, ordered by radiation column
+double latitude_scalar[NO_OF_SCALARS_H];
+double longitude_scalar[NO_OF_SCALARS_H];
+double sfc_albedo[NO_OF_SCALARS_H];
+Scalar_field z_scalar;
+Vector_field z_vector;
+Mass_densities rho;
+Scalar_field temperature;
+double temperature_soil[NO_OF_SOIL_LAYERS*NO_OF_SCALARS_H];
+Scalar_field radiation_tendency;
+Scalar_field radiation_tendency_sw;
+double sfc_sw_in[NO_OF_SCALARS_H];
+double sfc_lw_out[NO_OF_SCALARS_H];
+} Radiation_grid;
+
+// snapshot of the model state handed over to the asynchronous radiation thread, as well as its results
+typedef struct async_radiation {
+Mass_densities rho;
+Scalar_field temperature;
+double temperature_soil[NO_OF_SOIL_LAYERS*NO_OF_SCALARS_H];
+double time_coordinate;
+Scalar_field radiation_tendency;
+Scalar_field radiation_tendency_sw;
+double sfc_sw_in[NO_OF_SCALARS_H];
+double sfc_lw_out[NO_OF_SCALARS_H];
+Grid *grid;
+Radiation_grid *radiation_grid;
+Config *config;
+pthread_t thread;
+int running_bool;
+int finished_bool; // set by the radiation thread when it is done, read with atomic loads
+} Async_radiation;
+
 // Contains everything on turbulence parametrizations as well as constituent-related quantities.
 typedef struct irreversible_quantities {
 Scalar_field temperature_diffusion_heating;
@@ -255,8 +309,58 @@ char month_string[3];
 char day_string[3];
 char hour_string[3];
 int ideal_input_id;
+int async_output_switch;
+int no_of_output_threads;
+int grib_ccsds_switch;
+char grib_bits_per_value[200];
+int netcdf4_switch;
+int netcdf_compression;
+int netcdf_compression_level;
+int netcdf_shuffle_switch;
+int netcdf_time_series_switch;
+int ugrid_output_switch;
+double latlon_resolution;
+double latlon_lat_min;
+double latlon_lat_max;
+double latlon_lon_min;
+double latlon_lon_max;
+char station_file[200];
+int station_output_steps;
+char output_variables[1000];
+int mean_output_steps;
+double mean_output_begin;
+double mean_output_interval;
+int zonal_mean_bins;
+int no_of_pressure_levels;
+double pressure_levels[MAX_NO_OF_PRESSURE_LEVELS];
+char output_keepbits[200];
+int shm_output_switch;
+int shm_output_slots;
+char output_streams_file[200];
+int output_stream_index;
+int da_background_stream_index;
 } Config_io;
 
+// snapshot of everything write_out reads, handed over to the asynchronous output thread
+typedef struct async_output {
+State state_write;
+double *wind_h_lowest_layer;
+int min_no_of_10m_wind_avg_steps;
+double t_init;
+double t_write;
+Diagnostics diagnostics;
+Forcings forcings;
+Irreversible_quantities irrev;
+Grid *grid;
+Dualgrid *dualgrid;
+Config_io *output_streams[MAX_NO_OF_OUTPUT_STREAMS];
+int no_of_output_streams;
+Config *config;
+pthread_t thread;
+int running_bool;
+int finished_bool; // set by the output thread when it is done, read with atomic loads
+} Async_output;
+
 
 
 
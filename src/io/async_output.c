@@ -0,0 +1,110 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the output is handed over to a separate thread, which writes it while the model is integrated further.
+The thread works on its own copy of everything write_out reads (the second buffer), so the model can go on modifying state_write.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+#include "../game_types.h"
+#include "io.h"
+
+void *async_output_thread(void *);
+
+int start_async_output(State *state_write, double wind_h_lowest_layer[], int min_no_of_10m_wind_avg_steps, double t_init, double t_write,
+Diagnostics *diagnostics, Forcings *forcings, Grid *grid, Dualgrid *dualgrid, Config_io *output_streams[], int no_of_output_streams, Config *config,
+Irreversible_quantities *irrev, Async_output *async_output)
+{
+	/*
+	This function copies the output fields to the buffer of the output thread, starts the thread and returns immediately.
+	The thread writes the output streams output_streams one after the other.
+	*/
+	// the previous output must have been written before the buffer can be overwritten
+	finish_async_output(async_output);
+	if (async_output -> wind_h_lowest_layer == NULL)
+	{
+		async_output -> wind_h_lowest_layer = malloc(min_no_of_10m_wind_avg_steps*NO_OF_VECTORS_H*sizeof(double));
+	}
+	// taking the snapshot, only the fields write_out reads without diagnosing them itself are copied
+	memcpy(&async_output -> state_write, state_write, sizeof(State));
+	memcpy(async_output -> wind_h_lowest_layer, wind_h_lowest_layer, min_no_of_10m_wind_avg_steps*NO_OF_VECTORS_H*sizeof(double));
+	memcpy(async_output -> diagnostics.v_squared, diagnostics -> v_squared, sizeof(Scalar_field));
+	memcpy(async_output -> diagnostics.roughness_velocity, diagnostics -> roughness_velocity, NO_OF_SCALARS_H*sizeof(double));
+	memcpy(async_output -> diagnostics.monin_obukhov_length, diagnostics -> monin_obukhov_length, NO_OF_SCALARS_H*sizeof(double));
+	memcpy(async_output -> forcings.sfc_sw_in, forcings -> sfc_sw_in, NO_OF_SCALARS_H*sizeof(double));
+	memcpy(async_output -> irrev.tke, irrev -> tke, sizeof(Scalar_field));
+	async_output -> min_no_of_10m_wind_avg_steps = min_no_of_10m_wind_avg_steps;
+	async_output -> t_init = t_init;
+	async_output -> t_write = t_write;
+	async_output -> grid = grid;
+	async_output -> dualgrid = dualgrid;
+	for (int i = 0; i < no_of_output_streams; ++i)
+	{
+		async_output -> output_streams[i] = output_streams[i];
+	}
+	async_output -> no_of_output_streams = no_of_output_streams;
+	async_output -> config = config;
+	async_output -> finished_bool = 0;
+	if (pthread_create(&async_output -> thread, NULL, async_output_thread, async_output) != 0)
+	{
+		printf("Could not start the output thread.\n");
+		printf("Aborting.\n");
+		exit(1);
+	}
+	async_output -> running_bool = 1;
+	return 0;
+}
+
+int finish_async_output(Async_output *async_output)
+{
+	/*
+	This function waits until the output thread has written its files. async_output is NULL if the output is written synchronously.
+	*/
+	if (async_output == NULL || async_output -> running_bool == 0)
+	{
+		return 0;
+	}
+	pthread_join(async_output -> thread, NULL);
+	async_output -> running_bool = 0;
+	return 0;
+}
+
+int async_output_finished(Async_output *async_output)
+{
+	/*
+	This function returns 1 if no output is being written, without waiting for the output thread. A thread which is done is joined.
+	*/
+	if (async_output == NULL)
+	{
+		return 1;
+	}
+	if (async_output -> running_bool == 1 && __atomic_load_n(&async_output -> finished_bool, __ATOMIC_ACQUIRE) == 1)
+	{
+		finish_async_output(async_output);
+	}
+	return async_output -> running_bool == 0;
+}
+
+void *async_output_thread(void *argument)
+{
+	/*
+	This is the function executed by the output thread.
+	*/
+	Async_output *async_output = (Async_output *) argument;
+	// the streams are copies of the I/O configuration, so all of them have the same number of threads
+	omp_set_num_threads(async_output -> output_streams[0] -> no_of_output_threads);
+	for (int i = 0; i < async_output -> no_of_output_streams; ++i)
+	{
+		write_out(&async_output -> state_write, async_output -> wind_h_lowest_layer, async_output -> min_no_of_10m_wind_avg_steps,
+		async_output -> t_init, async_output -> t_write, &async_output -> diagnostics, &async_output -> forcings,
+		async_output -> grid, async_output -> dualgrid, async_output -> output_streams[i], async_output -> config, &async_output -> irrev);
+	}
+	__atomic_store_n(&async_output -> finished_bool, 1, __ATOMIC_RELEASE);
+	return NULL;
+}
@@ -9,8 +9,43 @@ int set_ideal_init(State *, Grid *, Dualgrid *, Diagnostics *, Forcings *, Confi
 int read_init_data(char[], State *, Irreversible_quantities *, Grid *);
 int write_out(State *, double [], int, double, double, Diagnostics *, Forcings *, Grid *, Dualgrid *, Config_io *, Config *,
 Irreversible_quantities *);
+int start_async_output(State *, double [], int, double, double, Diagnostics *, Forcings *, Grid *, Dualgrid *, Config_io *[], int, Config *,
+Irreversible_quantities *, Async_output *);
+int finish_async_output(Async_output *);
+int async_output_finished(Async_output *);
+int read_grib_template();
+int free_grib_template();
+int check_grib_bits_per_value(char []);
+int check_output_variables(char []);
+int output_variable_requested(char [], char []);
+int check_output_keepbits(char []);
+int get_output_keepbits(char [], char []);
+int round_mantissa(double [], int, int);
+int set_pressure_levels(char [], Config_io *);
+int set_output_streams(Config_io *, Config_io [], Config *, double);
+double get_next_output_time(double [], int);
+int close_netcdf_time_series();
+int set_netcdf_var_storage(int, int, size_t [], Config_io *);
+int sort_edge_indices(double [], double [], int, int []);
+int init_ugrid_output(char [], Grid *, Dualgrid *, Config_io *);
+int write_ugrid_output(double, State *, Diagnostics *, Scalar_field, Scalar_field, Scalar_field, Scalar_field, Irreversible_quantities *, Config_io *);
+int close_ugrid_output();
+int init_shm_output(Grid *, Config_io *);
+int write_shm_output(double, State *, Diagnostics *, Scalar_field, Scalar_field, Scalar_field, Scalar_field, Irreversible_quantities *);
+int close_shm_output();
+int put_text_attribute(int, int, char [], char []);
+int init_station_output(Grid *, Config_io *);
+int write_station_output(double, State *, Forcings *, Grid *, Config *, int);
+int close_station_output();
+int init_mean_output(Grid *, Config_io *);
+int accumulate_mean_output(double, State *, Grid *, Config *);
+int write_mean_output(double, Grid *, Config_io *);
+int close_mean_output(double, Grid *, Config_io *);
+int set_latlon_grid(Latlon_grid *, Grid *, Config_io *);
+int free_latlon_grid(Latlon_grid *);
+int set_interpolation_stencils(int, double [], double [], Grid *, int [], double []);
 int write_out_integral(State *, double, Grid *, Dualgrid *, Diagnostics *, int);
 int interpolation_t(State *, State *, State *, double, double, double, Grid *);
 int epv_diagnostics(Curl_field, State *, Scalar_field, Grid *, Dualgrid *);
-int interpolate_to_ll(double [], double [], Grid *);
+int interpolate_to_ll(double *[], double [], int, Latlon_grid *);
 int edges_to_cells_lowest_layer(double [], double [], Grid *);
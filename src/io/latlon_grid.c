@@ -0,0 +1,237 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the lat-lon grid the output is interpolated to is set up at runtime. It can be global or a regional box of any resolution.
+Every output point (lat-lon point or station) is interpolated from the five nearest cells of the model grid. These are found with a spatial index,
+a uniform grid of cubic buckets the cell centers on the unit sphere are sorted into.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <geos95.h>
+#include "../game_types.h"
+#include "../game_constants.h"
+#include "io.h"
+
+int find_bucket(double, double, int);
+
+// the edge length of a bucket of the spatial index in units of the mean distance between two cell centers
+const double BUCKET_SIZE_FACTOR = 4.0;
+
+int set_latlon_grid(Latlon_grid *latlon_grid, Grid *grid, Config_io *config_io)
+{
+	/*
+	This function sets the geometry of the lat-lon grid from the configuration and computes the interpolation indices and weights.
+	The points are the centers of boxes in the latitudinal direction and start at the western boundary of the domain in the longitudinal direction.
+	*/
+	// a resolution of zero means the default resolution, which matches the resolution of the model grid
+	double resolution = config_io -> latlon_resolution;
+	if (resolution == 0)
+	{
+		resolution = 360.0/NO_OF_LON_IO_POINTS;
+	}
+	latlon_grid -> no_of_lat_points = (int) round((config_io -> latlon_lat_max - config_io -> latlon_lat_min)/resolution);
+	latlon_grid -> no_of_lon_points = (int) round((config_io -> latlon_lon_max - config_io -> latlon_lon_min)/resolution);
+	if (latlon_grid -> no_of_lat_points < 1 || latlon_grid -> no_of_lon_points < 1)
+	{
+		printf("The lat-lon output domain must be at least one grid point wide in each direction.\n");
+		printf("Aborting.\n");
+		exit(1);
+	}
+	latlon_grid -> delta_lat = deg2rad(resolution);
+	latlon_grid -> delta_lon = deg2rad(resolution);
+	latlon_grid -> lat_first = deg2rad(config_io -> latlon_lat_max) - 0.5*latlon_grid -> delta_lat;
+	latlon_grid -> lon_first = deg2rad(config_io -> latlon_lon_min);
+	int no_of_points = latlon_grid -> no_of_lat_points*latlon_grid -> no_of_lon_points;
+	latlon_grid -> interpol_indices = malloc(5*no_of_points*sizeof(int));
+	latlon_grid -> interpol_weights = malloc(5*no_of_points*sizeof(double));
+	double *lat_values = malloc(no_of_points*sizeof(double));
+	double *lon_values = malloc(no_of_points*sizeof(double));
+	int lat_index, lon_index;
+	#pragma omp parallel for private(lat_index, lon_index)
+	for (int i = 0; i < no_of_points; ++i)
+	{
+		lat_index = i/latlon_grid -> no_of_lon_points;
+		lon_index = i - lat_index*latlon_grid -> no_of_lon_points;
+		lat_values[i] = latlon_grid -> lat_first - lat_index*latlon_grid -> delta_lat;
+		lon_values[i] = latlon_grid -> lon_first + lon_index*latlon_grid -> delta_lon;
+	}
+	set_interpolation_stencils(no_of_points, lat_values, lon_values, grid, latlon_grid -> interpol_indices, latlon_grid -> interpol_weights);
+	free(lat_values);
+	free(lon_values);
+	return 0;
+}
+
+int set_interpolation_stencils(int no_of_points, double lat_values[], double lon_values[], Grid *grid, int interpol_indices[], double interpol_weights[])
+{
+	/*
+	This function computes the indices and weights of the five nearest cells for every point of lat_values and lon_values (rad).
+	*/
+	// the Cartesian coordinates of the cell centers on the unit sphere
+	double *x = malloc(NO_OF_SCALARS_H*sizeof(double));
+	double *y = malloc(NO_OF_SCALARS_H*sizeof(double));
+	double *z = malloc(NO_OF_SCALARS_H*sizeof(double));
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		x[i] = cos(grid -> latitude_scalar[i])*cos(grid -> longitude_scalar[i]);
+		y[i] = cos(grid -> latitude_scalar[i])*sin(grid -> longitude_scalar[i]);
+		z[i] = sin(grid -> latitude_scalar[i]);
+	}
+
+	// building the spatial index, the cells of a bucket are stored contiguously
+	double bucket_size = BUCKET_SIZE_FACTOR*sqrt(4*M_PI/NO_OF_SCALARS_H);
+	int no_of_buckets_1d = (int) (2/bucket_size) + 1;
+	int no_of_buckets = no_of_buckets_1d*no_of_buckets_1d*no_of_buckets_1d;
+	int *bucket_index = malloc(NO_OF_SCALARS_H*sizeof(int));
+	int *bucket_start = calloc(no_of_buckets + 1, sizeof(int));
+	int *bucket_cells = malloc(NO_OF_SCALARS_H*sizeof(int));
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		bucket_index[i] = (find_bucket(x[i], bucket_size, no_of_buckets_1d)*no_of_buckets_1d
+		+ find_bucket(y[i], bucket_size, no_of_buckets_1d))*no_of_buckets_1d + find_bucket(z[i], bucket_size, no_of_buckets_1d);
+		bucket_start[bucket_index[i] + 1] += 1;
+	}
+	for (int i = 0; i < no_of_buckets; ++i)
+	{
+		bucket_start[i + 1] += bucket_start[i];
+	}
+	int *counter = calloc(no_of_buckets, sizeof(int));
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		bucket_cells[bucket_start[bucket_index[i]] + counter[bucket_index[i]]] = i;
+		counter[bucket_index[i]] += 1;
+	}
+	free(counter);
+	free(bucket_index);
+
+	/*
+	Searching the five nearest cells of every lat-lon point. The buckets are visited in shells of growing size around the bucket of the point.
+	A cell outside of the shells visited so far is at least (shell_index - 1)*bucket_size away, the search stops when the fifth nearest cell is closer.
+	The chord distance is a monotonic function of the great circle distance, so it gives the same neighbours.
+	*/
+	int no_of_found, bucket_x, bucket_y, bucket_z, shell_index, bx, by, bz, bucket, cell, insert_index;
+	int min_indices_vector[5];
+	double lat_value, lon_value, x_point, y_point, z_point, distance, weights_sum;
+	double min_distances_vector[5], weights_vector[5];
+	#pragma omp parallel for private(no_of_found, bucket_x, bucket_y, bucket_z, shell_index, bx, by, bz, bucket, cell, insert_index, \
+	min_indices_vector, lat_value, lon_value, x_point, y_point, z_point, distance, weights_sum, min_distances_vector, weights_vector)
+	for (int i = 0; i < no_of_points; ++i)
+	{
+		lat_value = lat_values[i];
+		lon_value = lon_values[i];
+		x_point = cos(lat_value)*cos(lon_value);
+		y_point = cos(lat_value)*sin(lon_value);
+		z_point = sin(lat_value);
+		bucket_x = find_bucket(x_point, bucket_size, no_of_buckets_1d);
+		bucket_y = find_bucket(y_point, bucket_size, no_of_buckets_1d);
+		bucket_z = find_bucket(z_point, bucket_size, no_of_buckets_1d);
+		no_of_found = 0;
+		shell_index = 0;
+		while (no_of_found < 5 || min_distances_vector[4] > (shell_index - 1)*bucket_size)
+		{
+			for (bx = bucket_x - shell_index; bx <= bucket_x + shell_index; ++bx)
+			{
+				for (by = bucket_y - shell_index; by <= bucket_y + shell_index; ++by)
+				{
+					for (bz = bucket_z - shell_index; bz <= bucket_z + shell_index; ++bz)
+					{
+						// only the surface of the shell, the inside has been visited already
+						if (abs(bx - bucket_x) != shell_index && abs(by - bucket_y) != shell_index && abs(bz - bucket_z) != shell_index)
+						{
+							continue;
+						}
+						if (bx < 0 || bx >= no_of_buckets_1d || by < 0 || by >= no_of_buckets_1d || bz < 0 || bz >= no_of_buckets_1d)
+						{
+							continue;
+						}
+						bucket = (bx*no_of_buckets_1d + by)*no_of_buckets_1d + bz;
+						for (int j = bucket_start[bucket]; j < bucket_start[bucket + 1]; ++j)
+						{
+							cell = bucket_cells[j];
+							distance = sqrt(pow(x[cell] - x_point, 2) + pow(y[cell] - y_point, 2) + pow(z[cell] - z_point, 2));
+							// insertion into the sorted list of the nearest cells, ties are resolved in favour of the lower index
+							insert_index = no_of_found;
+							while (insert_index > 0 && (distance < min_distances_vector[insert_index - 1]
+							|| (distance == min_distances_vector[insert_index - 1] && cell < min_indices_vector[insert_index - 1])))
+							{
+								if (insert_index < 5)
+								{
+									min_distances_vector[insert_index] = min_distances_vector[insert_index - 1];
+									min_indices_vector[insert_index] = min_indices_vector[insert_index - 1];
+								}
+								--insert_index;
+							}
+							if (insert_index < 5)
+							{
+								min_distances_vector[insert_index] = distance;
+								min_indices_vector[insert_index] = cell;
+								if (no_of_found < 5)
+								{
+									++no_of_found;
+								}
+							}
+						}
+					}
+				}
+			}
+			++shell_index;
+			// all buckets have been visited
+			if (shell_index == no_of_buckets_1d)
+			{
+				break;
+			}
+		}
+		// the same inverse distance weighting as in the grid generator
+		weights_sum = 0;
+		for (int j = 0; j < 5; ++j)
+		{
+			distance = calculate_distance_h(lat_value, lon_value, grid -> latitude_scalar[min_indices_vector[j]], grid -> longitude_scalar[min_indices_vector[j]], 1);
+			weights_vector[j] = 1/(pow(distance, 2 + EPSILON_SECURITY) + EPSILON_SECURITY);
+			weights_sum += weights_vector[j];
+		}
+		for (int j = 0; j < 5; ++j)
+		{
+			interpol_indices[5*i + j] = min_indices_vector[j];
+			interpol_weights[5*i + j] = weights_vector[j]/weights_sum;
+		}
+	}
+	free(bucket_start);
+	free(bucket_cells);
+	free(x);
+	free(y);
+	free(z);
+	return 0;
+}
+
+int free_latlon_grid(Latlon_grid *latlon_grid)
+{
+	/*
+	This function frees the interpolation indices and weights of a lat-lon grid.
+	*/
+	free(latlon_grid -> interpol_indices);
+	free(latlon_grid -> interpol_weights);
+	latlon_grid -> interpol_indices = NULL;
+	latlon_grid -> interpol_weights = NULL;
+	return 0;
+}
+
+int find_bucket(double coordinate, double bucket_size, int no_of_buckets_1d)
+{
+	/*
+	This function returns the index of the bucket of the spatial index a Cartesian coordinate on the unit sphere belongs to.
+	*/
+	int bucket = (int) ((coordinate + 1)/bucket_size);
+	if (bucket < 0)
+	{
+		bucket = 0;
+	}
+	if (bucket > no_of_buckets_1d - 1)
+	{
+		bucket = no_of_buckets_1d - 1;
+	}
+	return bucket;
+}
@@ -0,0 +1,348 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the time means and the zonal means are accumulated during the model run. Every mean_output_steps time steps, the fields of the mean output
+which are in output_variables are added to running sums, the means over the averaging period are written at the end of the run or every mean_output_interval seconds.
+The zonal means are averages over latitude bins of the time means, so they do not need to be accumulated on their own.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <netcdf.h>
+#include <geos95.h>
+#include "../game_types.h"
+#include "io.h"
+#include "../constituents/constituents.h"
+#include "../spatial_operators/spatial_operators.h"
+#define NCERR(e) {printf("Error: %s\n", nc_strerror(e)); exit(2);}
+
+int zonal_mean(double [], double [], Grid *, Config_io *);
+
+// the number of fields which can be averaged
+#define NO_OF_MEAN_FIELDS 5
+
+// the names and the units of the fields which can be averaged, the indices below refer to them
+char *MEAN_FIELD_NAMES[NO_OF_MEAN_FIELDS] = {"temperature", "pressure", "rh", "wind_u", "wind_v"};
+char *MEAN_FIELD_UNITS[NO_OF_MEAN_FIELDS] = {"K", "Pa", "%", "m/s", "m/s"};
+const int MEAN_TEMPERATURE = 0;
+const int MEAN_PRESSURE = 1;
+const int MEAN_RH = 2;
+const int MEAN_WIND_U = 3;
+const int MEAN_WIND_V = 4;
+
+// the indices of the averaged fields (the ones in output_variables), the running sums are stored in this order
+int mean_field_indices[NO_OF_MEAN_FIELDS];
+int no_of_mean_fields = 0;
+// 1 if u and v have to be diagnozed
+int mean_wind_bool = 0;
+// the running sums of the averaged fields, no_of_mean_samples is the number of time steps added since the last output of the means
+double *mean_sums = NULL;
+int no_of_mean_samples = 0;
+// the time since the initialization of the first sample of the current averaging period
+double mean_period_begin;
+// work arrays of the diagnostics
+double *mean_u_at_edge = NULL;
+double *mean_v_at_edge = NULL;
+double *mean_u_at_cell = NULL;
+double *mean_v_at_cell = NULL;
+// the latitude bin of every cell and the volume of every bin in every layer (zonal means only)
+int *zonal_bin_indices = NULL;
+double *zonal_bin_volumes = NULL;
+
+int init_mean_output(Grid *grid, Config_io *config_io)
+{
+	/*
+	This function selects the averaged fields, allocates their running sums and sorts the cells into the latitude bins of the zonal means.
+	*/
+	no_of_mean_fields = 0;
+	for (int i = 0; i < NO_OF_MEAN_FIELDS; ++i)
+	{
+		if (output_variable_requested(config_io -> output_variables, MEAN_FIELD_NAMES[i]) == 1)
+		{
+			mean_field_indices[no_of_mean_fields] = i;
+			++no_of_mean_fields;
+		}
+	}
+	if (no_of_mean_fields == 0)
+	{
+		printf("output_variables contains none of the fields of the mean output (temperature, pressure, rh, wind_u, wind_v).\n");
+		printf("Aborting.\n");
+		exit(1);
+	}
+	mean_sums = calloc(no_of_mean_fields*NO_OF_SCALARS, sizeof(double));
+	no_of_mean_samples = 0;
+	mean_wind_bool = output_variable_requested(config_io -> output_variables, MEAN_FIELD_NAMES[MEAN_WIND_U])
+	|| output_variable_requested(config_io -> output_variables, MEAN_FIELD_NAMES[MEAN_WIND_V]);
+	if (mean_wind_bool == 1)
+	{
+		mean_u_at_edge = malloc(NO_OF_VECTORS*sizeof(double));
+		mean_v_at_edge = malloc(NO_OF_VECTORS*sizeof(double));
+		mean_u_at_cell = malloc(NO_OF_SCALARS*sizeof(double));
+		mean_v_at_cell = malloc(NO_OF_SCALARS*sizeof(double));
+	}
+	if (config_io -> zonal_mean_bins == 0)
+	{
+		return 0;
+	}
+	// the bins have the same width in latitude and are numbered from south to north
+	zonal_bin_indices = malloc(NO_OF_SCALARS_H*sizeof(int));
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		zonal_bin_indices[i] = (int) ((grid -> latitude_scalar[i] + 0.5*M_PI)/M_PI*config_io -> zonal_mean_bins);
+		if (zonal_bin_indices[i] > config_io -> zonal_mean_bins - 1)
+		{
+			zonal_bin_indices[i] = config_io -> zonal_mean_bins - 1;
+		}
+		if (zonal_bin_indices[i] < 0)
+		{
+			zonal_bin_indices[i] = 0;
+		}
+	}
+	// the cells are weighted with their volumes
+	zonal_bin_volumes = calloc(NO_OF_LAYERS*config_io -> zonal_mean_bins, sizeof(double));
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_LAYERS; ++i)
+	{
+		for (int j = 0; j < NO_OF_SCALARS_H; ++j)
+		{
+			zonal_bin_volumes[i*config_io -> zonal_mean_bins + zonal_bin_indices[j]] += grid -> volume[i*NO_OF_SCALARS_H + j];
+		}
+	}
+	for (int i = 0; i < NO_OF_LAYERS*config_io -> zonal_mean_bins; ++i)
+	{
+		if (zonal_bin_volumes[i] == 0)
+		{
+			printf("A latitude bin of the zonal means contains no grid cell, reduce zonal_mean_bins.\n");
+			printf("Aborting.\n");
+			exit(1);
+		}
+	}
+	return 0;
+}
+
+int accumulate_mean_output(double time_since_init, State *state, Grid *grid, Config *config)
+{
+	/*
+	This function adds the fields of a state to the running sums of the mean output.
+	*/
+	if (no_of_mean_samples == 0)
+	{
+		mean_period_begin = time_since_init;
+	}
+	// u and v are diagnozed at the edges and averaged to the cell centers like in the model level output
+	if (mean_wind_bool == 1)
+	{
+		calc_uv_at_edge(state -> wind, mean_u_at_edge, mean_v_at_edge, grid);
+		edges_to_cells(mean_u_at_edge, mean_u_at_cell, grid);
+		edges_to_cells(mean_v_at_edge, mean_v_at_cell, grid);
+	}
+	double temperature, value;
+	int field_index;
+	#pragma omp parallel for private(temperature, value, field_index)
+	for (int i = 0; i < NO_OF_SCALARS; ++i)
+	{
+		temperature = temperature_diagnostics_point(state, grid, i);
+		for (int j = 0; j < no_of_mean_fields; ++j)
+		{
+			field_index = mean_field_indices[j];
+			value = 0.0;
+			if (field_index == MEAN_TEMPERATURE)
+			{
+				value = temperature;
+			}
+			if (field_index == MEAN_PRESSURE)
+			{
+				value = state -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + i]*gas_constant_diagnostics(state, i, config)*temperature;
+			}
+			if (field_index == MEAN_RH && NO_OF_CONSTITUENTS >= 4)
+			{
+				value = 100.0*rel_humidity(state -> rho[(NO_OF_CONDENSED_CONSTITUENTS + 1)*NO_OF_SCALARS + i], temperature);
+			}
+			if (field_index == MEAN_WIND_U)
+			{
+				value = mean_u_at_cell[i];
+			}
+			if (field_index == MEAN_WIND_V)
+			{
+				value = mean_v_at_cell[i];
+			}
+			mean_sums[j*NO_OF_SCALARS + i] += value;
+		}
+	}
+	++no_of_mean_samples;
+	return 0;
+}
+
+int write_mean_output(double time_since_init, Grid *grid, Config_io *config_io)
+{
+	/*
+	This function writes the means since the last output of the means to a netcdf file and resets the running sums.
+	It must not be called while the output thread is running, because the netcdf library is not thread-safe.
+	*/
+	if (no_of_mean_samples == 0)
+	{
+		return 0;
+	}
+	// the sums are turned into means in place
+	#pragma omp parallel for
+	for (int i = 0; i < no_of_mean_fields*NO_OF_SCALARS; ++i)
+	{
+		mean_sums[i] = mean_sums[i]/no_of_mean_samples;
+	}
+
+	int retval, ncid, scalar_dimid, layer_dimid, bin_dimid, varid;
+	char OUTPUT_FILE[300];
+	sprintf(OUTPUT_FILE, "%s+%ds_means.nc", config_io -> run_id, (int) time_since_init);
+	int create_mode = NC_CLOBBER;
+	if (config_io -> netcdf4_switch == 1)
+	{
+		create_mode = NC_CLOBBER | NC_NETCDF4;
+	}
+	if ((retval = nc_create(OUTPUT_FILE, create_mode, &ncid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "scalar_index", NO_OF_SCALARS, &scalar_dimid)))
+		NCERR(retval);
+	// the averaging period
+	if ((retval = nc_put_att_double(ncid, NC_GLOBAL, "period_begin", NC_DOUBLE, 1, &mean_period_begin)))
+		NCERR(retval);
+	if ((retval = nc_put_att_double(ncid, NC_GLOBAL, "period_end", NC_DOUBLE, 1, &time_since_init)))
+		NCERR(retval);
+	if ((retval = nc_put_att_int(ncid, NC_GLOBAL, "no_of_samples", NC_INT, 1, &no_of_mean_samples)))
+		NCERR(retval);
+	put_text_attribute(ncid, NC_GLOBAL, "time_units", "s since init");
+	// one chunk per layer
+	size_t chunk_shape[1] = {NO_OF_SCALARS_H};
+	char var_name[100];
+	for (int i = 0; i < no_of_mean_fields; ++i)
+	{
+		if ((retval = nc_def_var(ncid, MEAN_FIELD_NAMES[mean_field_indices[i]], NC_DOUBLE, 1, &scalar_dimid, &varid)))
+			NCERR(retval);
+		set_netcdf_var_storage(ncid, varid, chunk_shape, config_io);
+		put_text_attribute(ncid, varid, "units", MEAN_FIELD_UNITS[mean_field_indices[i]]);
+	}
+	if (config_io -> zonal_mean_bins > 0)
+	{
+		if ((retval = nc_def_dim(ncid, "layer", NO_OF_LAYERS, &layer_dimid)))
+			NCERR(retval);
+		if ((retval = nc_def_dim(ncid, "latitude", config_io -> zonal_mean_bins, &bin_dimid)))
+			NCERR(retval);
+		int zonal_dimids[2] = {layer_dimid, bin_dimid};
+		if ((retval = nc_def_var(ncid, "latitude", NC_DOUBLE, 1, &bin_dimid, &varid)))
+			NCERR(retval);
+		put_text_attribute(ncid, varid, "units", "degrees_north");
+		if ((retval = nc_def_var(ncid, "z_zonal_mean", NC_DOUBLE, 2, zonal_dimids, &varid)))
+			NCERR(retval);
+		put_text_attribute(ncid, varid, "units", "m");
+		for (int i = 0; i < no_of_mean_fields; ++i)
+		{
+			sprintf(var_name, "%s_zonal_mean", MEAN_FIELD_NAMES[mean_field_indices[i]]);
+			if ((retval = nc_def_var(ncid, var_name, NC_DOUBLE, 2, zonal_dimids, &varid)))
+				NCERR(retval);
+			put_text_attribute(ncid, varid, "units", MEAN_FIELD_UNITS[mean_field_indices[i]]);
+		}
+	}
+	if ((retval = nc_enddef(ncid)))
+		NCERR(retval);
+
+	// the time means
+	for (int i = 0; i < no_of_mean_fields; ++i)
+	{
+		if ((retval = nc_inq_varid(ncid, MEAN_FIELD_NAMES[mean_field_indices[i]], &varid)))
+			NCERR(retval);
+		if ((retval = nc_put_var_double(ncid, varid, &mean_sums[i*NO_OF_SCALARS])))
+			NCERR(retval);
+	}
+	// the zonal means
+	if (config_io -> zonal_mean_bins > 0)
+	{
+		double *latitudes = malloc(config_io -> zonal_mean_bins*sizeof(double));
+		for (int i = 0; i < config_io -> zonal_mean_bins; ++i)
+		{
+			latitudes[i] = -90.0 + (i + 0.5)*180.0/config_io -> zonal_mean_bins;
+		}
+		if ((retval = nc_inq_varid(ncid, "latitude", &varid)))
+			NCERR(retval);
+		if ((retval = nc_put_var_double(ncid, varid, latitudes)))
+			NCERR(retval);
+		free(latitudes);
+		double *zonal_mean_field = malloc(NO_OF_LAYERS*config_io -> zonal_mean_bins*sizeof(double));
+		zonal_mean(grid -> z_scalar, zonal_mean_field, grid, config_io);
+		if ((retval = nc_inq_varid(ncid, "z_zonal_mean", &varid)))
+			NCERR(retval);
+		if ((retval = nc_put_var_double(ncid, varid, zonal_mean_field)))
+			NCERR(retval);
+		for (int i = 0; i < no_of_mean_fields; ++i)
+		{
+			zonal_mean(&mean_sums[i*NO_OF_SCALARS], zonal_mean_field, grid, config_io);
+			sprintf(var_name, "%s_zonal_mean", MEAN_FIELD_NAMES[mean_field_indices[i]]);
+			if ((retval = nc_inq_varid(ncid, var_name, &varid)))
+				NCERR(retval);
+			if ((retval = nc_put_var_double(ncid, varid, zonal_mean_field)))
+				NCERR(retval);
+		}
+		free(zonal_mean_field);
+	}
+	if ((retval = nc_close(ncid)))
+		NCERR(retval);
+
+	// starting a new averaging period
+	#pragma omp parallel for
+	for (int i = 0; i < no_of_mean_fields*NO_OF_SCALARS; ++i)
+	{
+		mean_sums[i] = 0;
+	}
+	no_of_mean_samples = 0;
+	printf("Means written.\n");
+	return 0;
+}
+
+int close_mean_output(double time_since_init, Grid *grid, Config_io *config_io)
+{
+	/*
+	This function writes the means of the last averaging period and frees the running sums at the end of the run.
+	*/
+	if (mean_sums == NULL)
+	{
+		return 0;
+	}
+	write_mean_output(time_since_init, grid, config_io);
+	free(mean_sums);
+	free(mean_u_at_edge);
+	free(mean_v_at_edge);
+	free(mean_u_at_cell);
+	free(mean_v_at_cell);
+	free(zonal_bin_indices);
+	free(zonal_bin_volumes);
+	mean_sums = NULL;
+	return 0;
+}
+
+int zonal_mean(double field[], double result[], Grid *grid, Config_io *config_io)
+{
+	/*
+	This function computes the volume-weighted means of a scalar field over the latitude bins in every layer (result has the shape layer x bin).
+	Every thread reduces whole layers, so no two threads write to the same bin.
+	*/
+	int no_of_bins = config_io -> zonal_mean_bins;
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_LAYERS; ++i)
+	{
+		for (int j = 0; j < no_of_bins; ++j)
+		{
+			result[i*no_of_bins + j] = 0;
+		}
+		for (int j = 0; j < NO_OF_SCALARS_H; ++j)
+		{
+			result[i*no_of_bins + zonal_bin_indices[j]] += grid -> volume[i*NO_OF_SCALARS_H + j]*field[i*NO_OF_SCALARS_H + j];
+		}
+		for (int j = 0; j < no_of_bins; ++j)
+		{
+			result[i*no_of_bins + j] = result[i*no_of_bins + j]/zonal_bin_volumes[i*no_of_bins + j];
+		}
+	}
+	return 0;
+}
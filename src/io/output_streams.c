@@ -0,0 +1,208 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the output streams are set up. A stream is a copy of the I/O configuration with its own output interval, products, format,
+pressure levels and output variables, write_out writes one stream at a time. Without a stream file, the run script settings are the only stream.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../game_types.h"
+#include "io.h"
+
+int list_contains(char [], char []);
+int set_da_background_stream(Config_io [], int, Config *);
+
+// the maximum length of the name of a stream
+#define MAX_STREAM_NAME_LENGTH 64
+
+int set_output_streams(Config_io *config_io, Config_io output_streams[], Config *config, double radius_rescale)
+{
+	/*
+	This function reads the output streams from config_io -> output_streams_file and returns the number of streams.
+	Every line of the stream file contains the name of a stream (without spaces), its output interval in seconds, its products
+	(comma-separated list of surface, pressure_levels and model_levels), its formats (comma-separated list of grib and netcdf),
+	its pressure levels in hPa (- for the levels of the run script) and its output variables (like output_variables in the run script).
+	*/
+	if (strcmp(config_io -> output_streams_file, "none") == 0)
+	{
+		memcpy(&output_streams[0], config_io, sizeof(Config_io));
+		output_streams[0].output_stream_index = 0;
+		set_da_background_stream(output_streams, 1, config);
+		return 1;
+	}
+	FILE *streams_file = fopen(config_io -> output_streams_file, "r");
+	if (streams_file == NULL)
+	{
+		printf("Could not open the output stream file %s.\n", config_io -> output_streams_file);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	char name[MAX_STREAM_NAME_LENGTH], products[100], formats[100], pressure_levels[1000], output_variables[1000];
+	double interval;
+	int no_of_output_streams = 0;
+	int no_of_entries;
+	while ((no_of_entries = fscanf(streams_file, "%63s %lf %99s %99s %999s %999s", name, &interval, products, formats, pressure_levels,
+	output_variables)) == 6)
+	{
+		if (no_of_output_streams == MAX_NO_OF_OUTPUT_STREAMS)
+		{
+			printf("At most %d output streams can be defined in %s.\n", MAX_NO_OF_OUTPUT_STREAMS, config_io -> output_streams_file);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		Config_io *output_stream = &output_streams[no_of_output_streams];
+		memcpy(output_stream, config_io, sizeof(Config_io));
+		output_stream -> output_stream_index = no_of_output_streams;
+		// the files of the streams are distinguished by the name of the stream
+		if (strlen(config_io -> run_id) + strlen(name) + 2 > sizeof(output_stream -> run_id))
+		{
+			printf("The run_id combined with the name of the output stream %s is too long.\n", name);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		sprintf(output_stream -> run_id, "%s_%s", config_io -> run_id, name);
+		if (interval < 900)
+		{
+			printf("The output interval of the output stream %s is smaller than 900 s.\n", name);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		output_stream -> write_out_interval = radius_rescale*interval;
+		output_stream -> surface_output_switch = list_contains(products, "surface");
+		output_stream -> pressure_level_output_switch = list_contains(products, "pressure_levels");
+		output_stream -> model_level_output_switch = list_contains(products, "model_levels");
+		if (output_stream -> surface_output_switch + output_stream -> pressure_level_output_switch + output_stream -> model_level_output_switch == 0)
+		{
+			printf("The output stream %s has no products, the products are surface, pressure_levels and model_levels.\n", name);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		output_stream -> grib_output_switch = list_contains(formats, "grib");
+		output_stream -> netcdf_output_switch = list_contains(formats, "netcdf");
+		if (output_stream -> grib_output_switch + output_stream -> netcdf_output_switch == 0)
+		{
+			printf("The output stream %s has no format, the formats are grib and netcdf.\n", name);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		if (strcmp(pressure_levels, "-") != 0)
+		{
+			set_pressure_levels(pressure_levels, output_stream);
+		}
+		check_output_variables(output_variables);
+		strcpy(output_stream -> output_variables, output_variables);
+		// the output on the native grid belongs to the first stream only
+		if (no_of_output_streams > 0)
+		{
+			output_stream -> ugrid_output_switch = 0;
+			output_stream -> shm_output_switch = 0;
+		}
+		printf("Output stream %s: every %d s, products %s, formats %s, pressure levels %s, variables %s\n", name, output_stream -> write_out_interval,
+		products, formats, pressure_levels, output_variables);
+		++no_of_output_streams;
+	}
+	if (no_of_entries != EOF || no_of_output_streams == 0)
+	{
+		printf("Could not read the output stream file %s, every line needs six entries.\n", config_io -> output_streams_file);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	fclose(streams_file);
+
+	// the output times of all streams have to be output times of the stream with the shortest interval, they share the collection of the 10 m wind
+	int shortest_interval = output_streams[0].write_out_interval;
+	for (int i = 1; i < no_of_output_streams; ++i)
+	{
+		if (output_streams[i].write_out_interval < shortest_interval)
+		{
+			shortest_interval = output_streams[i].write_out_interval;
+		}
+	}
+	for (int i = 0; i < no_of_output_streams; ++i)
+	{
+		if (output_streams[i].write_out_interval % shortest_interval != 0)
+		{
+			printf("The output intervals of all output streams have to be multiples of the shortest one.\n");
+			printf("Aborting.\n");
+			exit(1);
+		}
+	}
+	set_da_background_stream(output_streams, no_of_output_streams, config);
+	return no_of_output_streams;
+}
+
+int set_da_background_stream(Config_io output_streams[], int no_of_output_streams, Config *config)
+{
+	/*
+	This function selects the first output stream which is due at the time of the next analysis, its model level output is the background state
+	of the data assimilation. The run is aborted if no stream is due then, otherwise the data assimilation would silently lack its background state.
+	*/
+	int da_background_stream_index = -1;
+	if (output_streams[0].ideal_input_id == -1 && config -> time_to_next_analysis > 0 && config -> time_to_next_analysis <= config -> total_run_span)
+	{
+		for (int i = no_of_output_streams - 1; i >= 0; --i)
+		{
+			// all streams begin with the initial state
+			if (config -> time_to_next_analysis % output_streams[i].write_out_interval == 0)
+			{
+				da_background_stream_index = i;
+			}
+		}
+		if (da_background_stream_index == -1)
+		{
+			printf("No output stream is written at the time of the next analysis (%d s), so the background state of the data assimilation would be missing.\n",
+			config -> time_to_next_analysis);
+			printf("Aborting.\n");
+			exit(1);
+		}
+	}
+	for (int i = 0; i < no_of_output_streams; ++i)
+	{
+		output_streams[i].da_background_stream_index = da_background_stream_index;
+	}
+	return 0;
+}
+
+double get_next_output_time(double t_write_streams[], int no_of_output_streams)
+{
+	/*
+	This function returns the next time at which at least one output stream is written.
+	*/
+	double t_write = t_write_streams[0];
+	for (int i = 1; i < no_of_output_streams; ++i)
+	{
+		if (t_write_streams[i] < t_write)
+		{
+			t_write = t_write_streams[i];
+		}
+	}
+	return t_write;
+}
+
+int list_contains(char list[], char entry[])
+{
+	/*
+	This function returns 1 if entry is an entry of the comma-separated list list, 0 otherwise.
+	*/
+	char *begin = list;
+	char *end;
+	while (*begin != '\0')
+	{
+		end = strchr(begin, ',');
+		if (end == NULL)
+		{
+			end = begin + strlen(begin);
+		}
+		if ((size_t) (end - begin) == strlen(entry) && strncmp(begin, entry, end - begin) == 0)
+		{
+			return 1;
+		}
+		begin = *end == ',' ? end + 1 : end;
+	}
+	return 0;
+}
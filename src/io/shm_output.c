@@ -0,0 +1,230 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the output on the native grid is published to a POSIX shared memory segment, which a consumer process on the same node can map.
+The segment consists of a header, a table describing the fields, the fields which do not change during the run (coordinates) and a ring of slots,
+every output time is copied to the next slot. A consumer reads the fields directly from the mapping, there is no file I/O.
+The slots are protected by sequence numbers (a seqlock), so the model never waits for a consumer.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "../game_types.h"
+#include "io.h"
+
+// the header at the beginning of the shared memory segment
+typedef struct shm_output_header {
+char magic[8];
+int32_t version;
+int32_t no_of_fields;
+int32_t no_of_slots;
+int32_t run_finished;
+int32_t no_of_layers;
+int32_t no_of_scalars_h;
+int32_t no_of_vectors_h;
+int32_t no_of_vectors_per_layer;
+int64_t static_offset;
+int64_t slots_offset;
+int64_t slot_size;
+// written last when a state has been published, the newest state is in the slot (no_of_published_states - 1) % no_of_slots
+int64_t no_of_published_states;
+} Shm_output_header;
+
+// an entry of the field table, offset is in bytes relative to the static part (static_bool == 1) or to the beginning of a slot
+typedef struct shm_output_field {
+char name[32];
+char units[16];
+int32_t static_bool;
+int32_t padding;
+int64_t offset;
+int64_t no_of_values;
+} Shm_output_field;
+
+// the header of a slot, sequence is odd while the slot is written and 2*(n + 1) once it contains the state with the index n
+typedef struct shm_output_slot {
+int64_t sequence;
+double time_since_init;
+} Shm_output_slot;
+
+int set_shm_output_field(Shm_output_field *, char [], char [], int, int64_t *, int64_t);
+int64_t align_shm_offset(int64_t);
+
+// identifies the segment and the layout of the header and the field table, consumers have to check it
+const char SHM_OUTPUT_MAGIC[8] = "GAMESHM";
+const int SHM_OUTPUT_VERSION = 1;
+// the fields and slots are aligned to cache lines
+const int SHM_OUTPUT_ALIGNMENT = 64;
+// the number of fields which are published at every output time and of the fields which are written once
+#define NO_OF_SHM_DYNAMIC_FIELDS 9
+#define NO_OF_SHM_STATIC_FIELDS 4
+
+// the shared memory segment, it stays mapped for the whole run
+char shm_name[110];
+char *shm_segment = NULL;
+size_t shm_segment_size = 0;
+
+int init_shm_output(Grid *grid, Config_io *config_io)
+{
+	/*
+	This function creates the shared memory segment, writes the header, the field table and the coordinates.
+	*/
+	// the names of shared memory segments have to start with a slash and must not contain any other slashes
+	sprintf(shm_name, "/game_%s", config_io -> run_id);
+	for (int i = 1; i < (int) strlen(shm_name); ++i)
+	{
+		if (shm_name[i] == '/')
+		{
+			shm_name[i] = '_';
+		}
+	}
+
+	// the layout of the segment
+	Shm_output_field fields[NO_OF_SHM_STATIC_FIELDS + NO_OF_SHM_DYNAMIC_FIELDS];
+	int64_t static_size = 0;
+	int64_t slot_size = align_shm_offset(sizeof(Shm_output_slot));
+	set_shm_output_field(&fields[0], "latitude_scalar", "rad", 1, &static_size, NO_OF_SCALARS_H);
+	set_shm_output_field(&fields[1], "longitude_scalar", "rad", 1, &static_size, NO_OF_SCALARS_H);
+	set_shm_output_field(&fields[2], "z_scalar", "m", 1, &static_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[3], "z_vector", "m", 1, &static_size, NO_OF_VECTORS);
+	set_shm_output_field(&fields[4], "temperature", "K", 0, &slot_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[5], "pressure", "Pa", 0, &slot_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[6], "rh", "%", 0, &slot_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[7], "wind_u", "m/s", 0, &slot_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[8], "wind_v", "m/s", 0, &slot_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[9], "rel_vort", "1/s", 0, &slot_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[10], "divv_h_all_layers", "1/s", 0, &slot_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[11], "tke", "J/kg", 0, &slot_size, NO_OF_SCALARS);
+	set_shm_output_field(&fields[12], "wind", "m/s", 0, &slot_size, NO_OF_VECTORS);
+	int64_t static_offset = align_shm_offset(sizeof(Shm_output_header) + sizeof(fields));
+	int64_t slots_offset = static_offset + static_size;
+	shm_segment_size = slots_offset + config_io -> shm_output_slots*slot_size;
+
+	// creating and mapping the segment, an old segment of the same run is replaced
+	shm_unlink(shm_name);
+	int shm_fd = shm_open(shm_name, O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (shm_fd == -1)
+	{
+		printf("Could not create the shared memory segment %s.\n", shm_name);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	if (ftruncate(shm_fd, shm_segment_size) != 0)
+	{
+		printf("Could not allocate %ld bytes of shared memory for %s.\n", (long) shm_segment_size, shm_name);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	shm_segment = mmap(NULL, shm_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+	if (shm_segment == MAP_FAILED)
+	{
+		printf("Could not map the shared memory segment %s.\n", shm_name);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	// the mapping stays valid after the file descriptor has been closed
+	close(shm_fd);
+
+	// the segment is filled with zeros by ftruncate, so all slots are marked as empty
+	Shm_output_header *header = (Shm_output_header *) shm_segment;
+	memcpy(header -> magic, SHM_OUTPUT_MAGIC, sizeof(header -> magic));
+	header -> version = SHM_OUTPUT_VERSION;
+	header -> no_of_fields = NO_OF_SHM_STATIC_FIELDS + NO_OF_SHM_DYNAMIC_FIELDS;
+	header -> no_of_slots = config_io -> shm_output_slots;
+	header -> run_finished = 0;
+	header -> no_of_layers = NO_OF_LAYERS;
+	header -> no_of_scalars_h = NO_OF_SCALARS_H;
+	header -> no_of_vectors_h = NO_OF_VECTORS_H;
+	header -> no_of_vectors_per_layer = NO_OF_VECTORS_PER_LAYER;
+	header -> static_offset = static_offset;
+	header -> slots_offset = slots_offset;
+	header -> slot_size = slot_size;
+	memcpy(shm_segment + sizeof(Shm_output_header), fields, sizeof(fields));
+	double *static_fields[NO_OF_SHM_STATIC_FIELDS] = {grid -> latitude_scalar, grid -> longitude_scalar, grid -> z_scalar, grid -> z_vector};
+	for (int i = 0; i < NO_OF_SHM_STATIC_FIELDS; ++i)
+	{
+		memcpy(shm_segment + static_offset + fields[i].offset, static_fields[i], fields[i].no_of_values*sizeof(double));
+	}
+	// consumers must not see the header before it is complete
+	__atomic_store_n(&header -> no_of_published_states, 0, __ATOMIC_RELEASE);
+	return 0;
+}
+
+int write_shm_output(double time_since_init, State *state_write_out, Diagnostics *diagnostics, Scalar_field pressure, Scalar_field rh,
+Scalar_field rel_vort, Scalar_field divv_h_all_layers, Irreversible_quantities *irrev)
+{
+	/*
+	This function copies the fields of one output time to the next slot of the ring and publishes it.
+	*/
+	Shm_output_header *header = (Shm_output_header *) shm_segment;
+	Shm_output_field *fields = (Shm_output_field *) (shm_segment + sizeof(Shm_output_header));
+	int64_t state_index = header -> no_of_published_states;
+	char *slot = shm_segment + header -> slots_offset + (state_index % header -> no_of_slots)*header -> slot_size;
+	Shm_output_slot *slot_header = (Shm_output_slot *) slot;
+
+	// an odd sequence number tells consumers that the slot is being overwritten
+	__atomic_store_n(&slot_header -> sequence, 2*state_index + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	slot_header -> time_since_init = time_since_init;
+	double *dynamic_fields[NO_OF_SHM_DYNAMIC_FIELDS] = {diagnostics -> temperature, pressure, rh, diagnostics -> u_at_cell, diagnostics -> v_at_cell, rel_vort,
+	divv_h_all_layers, irrev -> tke, state_write_out -> wind};
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_SHM_DYNAMIC_FIELDS; ++i)
+	{
+		Shm_output_field *field = &fields[NO_OF_SHM_STATIC_FIELDS + i];
+		memcpy(slot + field -> offset, dynamic_fields[i], field -> no_of_values*sizeof(double));
+	}
+
+	// publishing the state
+	__atomic_store_n(&slot_header -> sequence, 2*state_index + 2, __ATOMIC_RELEASE);
+	__atomic_store_n(&header -> no_of_published_states, state_index + 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+int close_shm_output()
+{
+	/*
+	This function marks the run as finished, unmaps the shared memory segment and removes its name.
+	Consumers which have mapped the segment can still read it.
+	*/
+	if (shm_segment == NULL)
+	{
+		return 0;
+	}
+	Shm_output_header *header = (Shm_output_header *) shm_segment;
+	__atomic_store_n(&header -> run_finished, 1, __ATOMIC_RELEASE);
+	munmap(shm_segment, shm_segment_size);
+	shm_unlink(shm_name);
+	shm_segment = NULL;
+	return 0;
+}
+
+int set_shm_output_field(Shm_output_field *field, char name[], char units[], int static_bool, int64_t *offset, int64_t no_of_values)
+{
+	/*
+	This function sets an entry of the field table and advances offset behind the field.
+	*/
+	memset(field, 0, sizeof(Shm_output_field));
+	strncpy(field -> name, name, sizeof(field -> name) - 1);
+	strncpy(field -> units, units, sizeof(field -> units) - 1);
+	field -> static_bool = static_bool;
+	field -> offset = *offset;
+	field -> no_of_values = no_of_values;
+	*offset = align_shm_offset(*offset + no_of_values*sizeof(double));
+	return 0;
+}
+
+int64_t align_shm_offset(int64_t offset)
+{
+	/*
+	This function rounds offset up to a multiple of SHM_OUTPUT_ALIGNMENT.
+	*/
+	return ((offset + SHM_OUTPUT_ALIGNMENT - 1)/SHM_OUTPUT_ALIGNMENT)*SHM_OUTPUT_ALIGNMENT;
+}
@@ -165,32 +165,69 @@ int inner_product_tangential(Vector_field in_field_0, Vector_field in_field_1, S
     return 0;
 }
 
-int interpolate_to_ll(double in_field[], double out_field[], Grid *grid)
+int interpolate_to_ll(double *in_fields[], double out_fields[], int no_of_fields, Latlon_grid *latlon_grid)
 {
 	/*
-	This function interpolates a single-layer scalar field to a lat-lon grid.
+	This function interpolates no_of_fields single-layer scalar fields to a lat-lon grid, out_fields contains the results one after the other.
+	The stencil of an output point is read once for all fields. A point is missing (9999) if one of the cells of its stencil is missing,
+	this is handled in a separate pass, only for the fields which contain missing values at all.
 	*/
+	int no_of_points = latlon_grid -> no_of_lat_points*latlon_grid -> no_of_lon_points;
 	
-	// loop over all output points
+	// finding the fields which contain missing values
+	int *missing_bools = calloc(no_of_fields, sizeof(int));
 	#pragma omp parallel for
-	for (int i = 0; i < NO_OF_LATLON_IO_POINTS; ++i)
+	for (int i = 0; i < no_of_fields; ++i)
+	{
+		for (int j = 0; j < NO_OF_SCALARS_H; ++j)
+		{
+			if (in_fields[i][j] == 9999)
+			{
+				missing_bools[i] = 1;
+				break;
+			}
+		}
+	}
+	
+	// 1/r-average of all fields, without branches in the inner loop
+	int indices[5];
+	double weights[5];
+	#pragma omp parallel for private(indices, weights)
+	for (int i = 0; i < no_of_points; ++i)
 	{
-		// initializing the result with zero
-		out_field[i] = 0;
-		// 1/r-average
 		for (int j = 0; j < 5; ++j)
 		{
-			if (in_field[grid -> latlon_interpol_indices[5*i + j]] != 9999)
+			indices[j] = latlon_grid -> interpol_indices[5*i + j];
+			weights[j] = latlon_grid -> interpol_weights[5*i + j];
+		}
+		for (int j = 0; j < no_of_fields; ++j)
+		{
+			out_fields[j*no_of_points + i] = weights[0]*in_fields[j][indices[0]] + weights[1]*in_fields[j][indices[1]] + weights[2]*in_fields[j][indices[2]]
+			+ weights[3]*in_fields[j][indices[3]] + weights[4]*in_fields[j][indices[4]];
+		}
+	}
+	
+	// the missing values
+	#pragma omp parallel for
+	for (int i = 0; i < no_of_points; ++i)
+	{
+		for (int j = 0; j < no_of_fields; ++j)
+		{
+			if (missing_bools[j] == 0)
 			{
-				out_field[i] += grid -> latlon_interpol_weights[5*i + j]*in_field[grid -> latlon_interpol_indices[5*i + j]];
+				continue;
 			}
-			else
+			for (int k = 0; k < 5; ++k)
 			{
-				out_field[i] = 9999;
-				break;
+				if (in_fields[j][latlon_grid -> interpol_indices[5*i + k]] == 9999)
+				{
+					out_fields[j*no_of_points + i] = 9999;
+					break;
+				}
 			}
 		}
 	}
+	free(missing_bools);
 	
 	// returning 0 indicating success
 	return 0;
@@ -0,0 +1,346 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the station output is written. A list of points is read at startup, the interpolation stencils are computed once,
+and the surface and profile values at these points are appended to one file every station_output_steps time steps.
+While the output thread is writing, the records are kept in memory, because the netcdf library is not thread-safe.
+Only the cells of the stencils are diagnozed, so this is much cheaper than writing global fields.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <netcdf.h>
+#include <geos95.h>
+#include "../game_types.h"
+#include "../game_constants.h"
+#include "io.h"
+#include "../constituents/constituents.h"
+#include "../spatial_operators/spatial_operators.h"
+#define NCERR(e) {printf("Error: %s\n", nc_strerror(e)); exit(2);}
+
+int flush_station_output();
+
+// the maximum length of a station name (including the terminating null character)
+#define MAX_STATION_NAME_LENGTH 64
+
+// the stations and their interpolation stencils, no_of_stations is zero as long as the station output is not initialized
+int no_of_stations = 0;
+char (*station_names)[MAX_STATION_NAME_LENGTH] = NULL;
+int *station_interpol_indices = NULL;
+double *station_interpol_weights = NULL;
+
+// the names and the units of the surface values and of the profiles
+char *STATION_SURFACE_NAMES[3] = {"rprate", "sprate", "sfc_sw_down"};
+char *STATION_SURFACE_UNITS[3] = {"kg/(m^2s)", "kg/(m^2s)", "W/m^2"};
+char *STATION_PROFILE_NAMES[5] = {"temperature", "pressure", "rh", "wind_u", "wind_v"};
+char *STATION_PROFILE_UNITS[5] = {"K", "Pa", "%", "m/s", "m/s"};
+
+// the station output file, it stays open for the whole run, ncid is -1 as long as the file has not been created
+int station_ncid = -1;
+int station_no_of_records = 0;
+// the IDs of the variables which are written at every output time
+int station_surface_varids[3];
+int station_profile_varids[5];
+int station_time_varid;
+
+// the records which have not been written yet
+double *station_buffer = NULL;
+double *station_buffer_times = NULL;
+int no_of_buffered_records = 0;
+int buffer_capacity = 0;
+
+int init_station_output(Grid *grid, Config_io *config_io)
+{
+	/*
+	This function reads the station list, computes the interpolation stencils and creates the station output file.
+	Every line of the station list contains the name (without spaces), the latitude and the longitude (degrees) of a station.
+	*/
+	FILE *station_file = fopen(config_io -> station_file, "r");
+	if (station_file == NULL)
+	{
+		printf("Could not open the station list %s.\n", config_io -> station_file);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	char name[MAX_STATION_NAME_LENGTH];
+	double lat_value, lon_value;
+	int no_of_stations_read = 0;
+	while (fscanf(station_file, "%63s %lf %lf", name, &lat_value, &lon_value) == 3)
+	{
+		++no_of_stations_read;
+	}
+	if (no_of_stations_read == 0)
+	{
+		printf("The station list %s contains no stations.\n", config_io -> station_file);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	station_names = calloc(no_of_stations_read, sizeof(char[MAX_STATION_NAME_LENGTH]));
+	double *latitudes = malloc(no_of_stations_read*sizeof(double));
+	double *longitudes = malloc(no_of_stations_read*sizeof(double));
+	rewind(station_file);
+	for (int i = 0; i < no_of_stations_read; ++i)
+	{
+		if (fscanf(station_file, "%63s %lf %lf", station_names[i], &latitudes[i], &longitudes[i]) != 3)
+		{
+			printf("Could not read the station list %s.\n", config_io -> station_file);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		if (latitudes[i] < -90 || latitudes[i] > 90)
+		{
+			printf("The latitude of station %s is out of range.\n", station_names[i]);
+			printf("Aborting.\n");
+			exit(1);
+		}
+	}
+	fclose(station_file);
+	no_of_stations = no_of_stations_read;
+
+	// the interpolation stencils are the same as for the lat-lon grid
+	double *lat_values = malloc(no_of_stations*sizeof(double));
+	double *lon_values = malloc(no_of_stations*sizeof(double));
+	for (int i = 0; i < no_of_stations; ++i)
+	{
+		lat_values[i] = deg2rad(latitudes[i]);
+		lon_values[i] = deg2rad(longitudes[i]);
+	}
+	station_interpol_indices = malloc(5*no_of_stations*sizeof(int));
+	station_interpol_weights = malloc(5*no_of_stations*sizeof(double));
+	set_interpolation_stencils(no_of_stations, lat_values, lon_values, grid, station_interpol_indices, station_interpol_weights);
+	free(lat_values);
+	free(lon_values);
+
+	// the heights of the layer centers at the stations
+	double *z_station = malloc(no_of_stations*NO_OF_LAYERS*sizeof(double));
+	for (int i = 0; i < no_of_stations; ++i)
+	{
+		for (int j = 0; j < NO_OF_LAYERS; ++j)
+		{
+			z_station[i*NO_OF_LAYERS + j] = 0;
+			for (int k = 0; k < 5; ++k)
+			{
+				z_station[i*NO_OF_LAYERS + j] += station_interpol_weights[5*i + k]*grid -> z_scalar[j*NO_OF_SCALARS_H + station_interpol_indices[5*i + k]];
+			}
+		}
+	}
+
+	// creating the file
+	char OUTPUT_FILE[300];
+	sprintf(OUTPUT_FILE, "%s_stations.nc", config_io -> run_id);
+	int retval, ncid;
+	// the classic format needs 64 bit offsets for files that grow beyond 2 GB
+	int create_mode = NC_CLOBBER | NC_64BIT_OFFSET;
+	if (config_io -> netcdf4_switch == 1)
+	{
+		create_mode = NC_CLOBBER | NC_NETCDF4;
+	}
+	if ((retval = nc_create(OUTPUT_FILE, create_mode, &station_ncid)))
+		NCERR(retval);
+	ncid = station_ncid;
+	station_no_of_records = 0;
+	int station_dimid, name_length_dimid, layer_dimid, time_dimid;
+	if ((retval = nc_def_dim(ncid, "station", no_of_stations, &station_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "name_length", MAX_STATION_NAME_LENGTH, &name_length_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "layer", NO_OF_LAYERS, &layer_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "time", NC_UNLIMITED, &time_dimid)))
+		NCERR(retval);
+	int name_id, latitude_id, longitude_id, z_id;
+	int name_dimids[2] = {station_dimid, name_length_dimid};
+	if ((retval = nc_def_var(ncid, "station_name", NC_CHAR, 2, name_dimids, &name_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "latitude", NC_DOUBLE, 1, &station_dimid, &latitude_id)))
+		NCERR(retval);
+	put_text_attribute(ncid, latitude_id, "units", "degrees_north");
+	if ((retval = nc_def_var(ncid, "longitude", NC_DOUBLE, 1, &station_dimid, &longitude_id)))
+		NCERR(retval);
+	put_text_attribute(ncid, longitude_id, "units", "degrees_east");
+	int profile_dimids[3] = {time_dimid, station_dimid, layer_dimid};
+	if ((retval = nc_def_var(ncid, "z", NC_DOUBLE, 2, &profile_dimids[1], &z_id)))
+		NCERR(retval);
+	put_text_attribute(ncid, z_id, "long_name", "height of the layer centers");
+	put_text_attribute(ncid, z_id, "units", "m");
+	if ((retval = nc_def_var(ncid, "time", NC_DOUBLE, 1, &time_dimid, &station_time_varid)))
+		NCERR(retval);
+	put_text_attribute(ncid, station_time_varid, "units", "s since init");
+	// one chunk per output time
+	size_t chunk_shape[3] = {1, no_of_stations, NO_OF_LAYERS};
+	// the surface values
+	for (int i = 0; i < 3; ++i)
+	{
+		if ((retval = nc_def_var(ncid, STATION_SURFACE_NAMES[i], NC_DOUBLE, 2, profile_dimids, &station_surface_varids[i])))
+			NCERR(retval);
+		set_netcdf_var_storage(ncid, station_surface_varids[i], chunk_shape, config_io);
+		put_text_attribute(ncid, station_surface_varids[i], "units", STATION_SURFACE_UNITS[i]);
+	}
+	// the profiles
+	for (int i = 0; i < 5; ++i)
+	{
+		if ((retval = nc_def_var(ncid, STATION_PROFILE_NAMES[i], NC_DOUBLE, 3, profile_dimids, &station_profile_varids[i])))
+			NCERR(retval);
+		set_netcdf_var_storage(ncid, station_profile_varids[i], chunk_shape, config_io);
+		put_text_attribute(ncid, station_profile_varids[i], "units", STATION_PROFILE_UNITS[i]);
+	}
+	if ((retval = nc_enddef(ncid)))
+		NCERR(retval);
+	if ((retval = nc_put_var_text(ncid, name_id, &station_names[0][0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, latitude_id, &latitudes[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, longitude_id, &longitudes[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, z_id, &z_station[0])))
+		NCERR(retval);
+	if ((retval = nc_sync(ncid)))
+		NCERR(retval);
+	free(latitudes);
+	free(longitudes);
+	free(z_station);
+	return 0;
+}
+
+int write_station_output(double time_since_init, State *state, Forcings *forcings, Grid *grid, Config *config, int flush_bool)
+{
+	/*
+	This function diagnozes the values at the stations and appends them to the record buffer.
+	Only the cells of the interpolation stencils are diagnozed, the values are averaged with the interpolation weights.
+	The buffered records are only written if flush_bool is 1 (the netcdf library must not be used by two threads at the same time).
+	*/
+	int record_size = 3*no_of_stations + 5*no_of_stations*NO_OF_LAYERS;
+	if (no_of_buffered_records == buffer_capacity)
+	{
+		buffer_capacity = 2*buffer_capacity + 1;
+		station_buffer = realloc(station_buffer, buffer_capacity*record_size*sizeof(double));
+		station_buffer_times = realloc(station_buffer_times, buffer_capacity*sizeof(double));
+	}
+	station_buffer_times[no_of_buffered_records] = time_since_init;
+	double *surface_values = &station_buffer[no_of_buffered_records*record_size];
+	double *profile_values = &surface_values[3*no_of_stations];
+	for (int i = 0; i < record_size; ++i)
+	{
+		surface_values[i] = 0;
+	}
+	++no_of_buffered_records;
+	int cell, scalar_index, no_of_edges, vector_index;
+	double weight, temperature, wind_0, wind_1, wind_u_value, wind_v_value;
+	#pragma omp parallel for private(cell, scalar_index, no_of_edges, vector_index, weight, temperature, wind_0, wind_1, wind_u_value, wind_v_value)
+	for (int i = 0; i < no_of_stations; ++i)
+	{
+		for (int j = 0; j < 5; ++j)
+		{
+			cell = station_interpol_indices[5*i + j];
+			weight = station_interpol_weights[5*i + j];
+			// surface values
+			if (NO_OF_CONDENSED_CONSTITUENTS == 4)
+			{
+				surface_values[i] += weight*config -> rain_velocity*state -> rho[NO_OF_SCALARS + (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + cell];
+				surface_values[no_of_stations + i] += weight*config -> snow_velocity*state -> rho[(NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + cell];
+			}
+			surface_values[2*no_of_stations + i] += weight*forcings -> sfc_sw_in[cell]/(1.0 - grid -> sfc_albedo[cell] + EPSILON_SECURITY);
+			// profiles
+			no_of_edges = 6;
+			if (cell < NO_OF_PENTAGONS)
+			{
+				no_of_edges = 5;
+			}
+			for (int k = 0; k < NO_OF_LAYERS; ++k)
+			{
+				scalar_index = k*NO_OF_SCALARS_H + cell;
+				temperature = temperature_diagnostics_point(state, grid, scalar_index);
+				profile_values[i*NO_OF_LAYERS + k] += weight*temperature;
+				profile_values[(no_of_stations + i)*NO_OF_LAYERS + k] += weight*state -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + scalar_index]
+				*gas_constant_diagnostics(state, scalar_index, config)*temperature;
+				if (NO_OF_CONSTITUENTS >= 4)
+				{
+					profile_values[(2*no_of_stations + i)*NO_OF_LAYERS + k] += weight*100.0
+					*rel_humidity(state -> rho[(NO_OF_CONDENSED_CONSTITUENTS + 1)*NO_OF_SCALARS + scalar_index], temperature);
+				}
+				// u and v are diagnozed at the edges of the cell and averaged to its center like in edges_to_cells
+				for (int l = 0; l < no_of_edges; ++l)
+				{
+					vector_index = grid -> adjacent_vector_indices_h[6*cell + l];
+					wind_0 = state -> wind[NO_OF_SCALARS_H + k*NO_OF_VECTORS_PER_LAYER + vector_index];
+					tangential_wind(state -> wind, k, vector_index, &wind_1, grid);
+					passive_turn(wind_0, wind_1, -grid -> direction[vector_index], &wind_u_value, &wind_v_value);
+					profile_values[(3*no_of_stations + i)*NO_OF_LAYERS + k] += weight*0.5*grid -> inner_product_weights[8*scalar_index + l]*wind_u_value;
+					profile_values[(4*no_of_stations + i)*NO_OF_LAYERS + k] += weight*0.5*grid -> inner_product_weights[8*scalar_index + l]*wind_v_value;
+				}
+			}
+		}
+	}
+	if (flush_bool == 1)
+	{
+		flush_station_output();
+	}
+	return 0;
+}
+
+int flush_station_output()
+{
+	/*
+	This function writes the buffered records to the station output file.
+	*/
+	int retval;
+	int ncid = station_ncid;
+	int record_size = 3*no_of_stations + 5*no_of_stations*NO_OF_LAYERS;
+	size_t start[3] = {0, 0, 0};
+	size_t count[3] = {1, no_of_stations, NO_OF_LAYERS};
+	size_t record;
+	for (int i = 0; i < no_of_buffered_records; ++i)
+	{
+		record = station_no_of_records;
+		start[0] = record;
+		for (int j = 0; j < 3; ++j)
+		{
+			if ((retval = nc_put_vara_double(ncid, station_surface_varids[j], start, count, &station_buffer[i*record_size + j*no_of_stations])))
+				NCERR(retval);
+		}
+		for (int j = 0; j < 5; ++j)
+		{
+			if ((retval = nc_put_vara_double(ncid, station_profile_varids[j], start, count, &station_buffer[i*record_size + 3*no_of_stations + j*no_of_stations*NO_OF_LAYERS])))
+				NCERR(retval);
+		}
+		if ((retval = nc_put_var1_double(ncid, station_time_varid, &record, &station_buffer_times[i])))
+			NCERR(retval);
+		++station_no_of_records;
+	}
+	no_of_buffered_records = 0;
+	// the file can be read while the model is still running
+	if ((retval = nc_sync(ncid)))
+		NCERR(retval);
+	return 0;
+}
+
+int close_station_output()
+{
+	/*
+	This function writes the remaining records, closes the station output file at the end of the run and frees the stencils.
+	*/
+	int retval;
+	if (station_ncid != -1)
+	{
+		flush_station_output();
+		if ((retval = nc_close(station_ncid)))
+			NCERR(retval);
+		station_ncid = -1;
+	}
+	free(station_names);
+	free(station_interpol_indices);
+	free(station_interpol_weights);
+	station_names = NULL;
+	station_interpol_indices = NULL;
+	station_interpol_weights = NULL;
+	no_of_stations = 0;
+	free(station_buffer);
+	free(station_buffer_times);
+	station_buffer = NULL;
+	station_buffer_times = NULL;
+	buffer_capacity = 0;
+	return 0;
+}
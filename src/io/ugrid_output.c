@@ -0,0 +1,494 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the output on the native grid is written following the UGRID conventions.
+There is one file per model run, the mesh (coordinates and connectivity) is written once when the file is created,
+every output time appends one record. The fields are written directly from the model arrays, nothing is interpolated.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <netcdf.h>
+#include <geos95.h>
+#include "../game_types.h"
+#include "io.h"
+#define NCERR(e) {printf("Error: %s\n", nc_strerror(e)); exit(2);}
+
+int def_ugrid_field(int, char [], int, int, int, char [], char [], size_t, Config_io *);
+double *round_ugrid_field(double [], int, double [], char [], Config_io *);
+
+// the maximum number of edges (and nodes) of a cell
+const int MAX_NO_OF_FACE_NODES = 6;
+
+// the UGRID output file, it stays open for the whole run, ncid is -1 as long as the file has not been created
+int ugrid_ncid = -1;
+int ugrid_no_of_records = 0;
+
+int init_ugrid_output(char grid_file[], Grid *grid, Dualgrid *dualgrid, Config_io *config_io)
+{
+	/*
+	This function creates the UGRID output file and writes the mesh, which is read from the grid file.
+	*/
+	int ncid, retval;
+	// the coordinates of the vertices and edges are not needed by the model, so they are read here
+	double *latitude_vertices = malloc(NO_OF_DUAL_SCALARS_H*sizeof(double));
+	double *longitude_vertices = malloc(NO_OF_DUAL_SCALARS_H*sizeof(double));
+	double *latitude_edges = malloc(NO_OF_VECTORS_H*sizeof(double));
+	double *longitude_edges = malloc(NO_OF_VECTORS_H*sizeof(double));
+	int latitude_vertices_id, longitude_vertices_id, latitude_edges_id, longitude_edges_id;
+	if ((retval = nc_open(grid_file, NC_NOWRITE, &ncid)))
+		NCERR(retval);
+	if ((retval = nc_inq_varid(ncid, "latitude_scalar_dual", &latitude_vertices_id)))
+		NCERR(retval);
+	if ((retval = nc_inq_varid(ncid, "longitude_scalar_dual", &longitude_vertices_id)))
+		NCERR(retval);
+	if ((retval = nc_inq_varid(ncid, "latitude_vector", &latitude_edges_id)))
+		NCERR(retval);
+	if ((retval = nc_inq_varid(ncid, "longitude_vector", &longitude_edges_id)))
+		NCERR(retval);
+	if ((retval = nc_get_var_double(ncid, latitude_vertices_id, &latitude_vertices[0])))
+		NCERR(retval);
+	if ((retval = nc_get_var_double(ncid, longitude_vertices_id, &longitude_vertices[0])))
+		NCERR(retval);
+	if ((retval = nc_get_var_double(ncid, latitude_edges_id, &latitude_edges[0])))
+		NCERR(retval);
+	if ((retval = nc_get_var_double(ncid, longitude_edges_id, &longitude_edges[0])))
+		NCERR(retval);
+	if ((retval = nc_close(ncid)))
+		NCERR(retval);
+
+	// the nodes and edges of every cell in counter-clockwise order, pentagons are filled up with -1
+	int *face_nodes = malloc(MAX_NO_OF_FACE_NODES*NO_OF_SCALARS_H*sizeof(int));
+	int *face_edges = malloc(MAX_NO_OF_FACE_NODES*NO_OF_SCALARS_H*sizeof(int));
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		int no_of_edges = 6;
+		if (i < NO_OF_PENTAGONS)
+		{
+			no_of_edges = 5;
+		}
+		int vertex_indices[6], indices_resorted[6], counter, edge_index, vertex_index_candidate, found_bool;
+		double latitude_points[6], longitude_points[6];
+		counter = 0;
+		for (int j = 0; j < no_of_edges; ++j)
+		{
+			edge_index = grid -> adjacent_vector_indices_h[6*i + j];
+			for (int k = 0; k < 2; ++k)
+			{
+				vertex_index_candidate = dualgrid -> from_index[edge_index];
+				if (k == 1)
+				{
+					vertex_index_candidate = dualgrid -> to_index[edge_index];
+				}
+				found_bool = 0;
+				for (int l = 0; l < counter; ++l)
+				{
+					if (vertex_indices[l] == vertex_index_candidate)
+					{
+						found_bool = 1;
+					}
+				}
+				if (found_bool == 0 && counter < no_of_edges)
+				{
+					vertex_indices[counter] = vertex_index_candidate;
+					latitude_points[counter] = latitude_vertices[vertex_index_candidate];
+					longitude_points[counter] = longitude_vertices[vertex_index_candidate];
+					++counter;
+				}
+			}
+		}
+		sort_edge_indices(latitude_points, longitude_points, no_of_edges, indices_resorted);
+		for (int j = 0; j < MAX_NO_OF_FACE_NODES; ++j)
+		{
+			face_nodes[MAX_NO_OF_FACE_NODES*i + j] = -1;
+			face_edges[MAX_NO_OF_FACE_NODES*i + j] = -1;
+		}
+		for (int j = 0; j < no_of_edges; ++j)
+		{
+			face_nodes[MAX_NO_OF_FACE_NODES*i + j] = vertex_indices[indices_resorted[j]];
+		}
+		// the edge j connects the nodes j and j + 1
+		for (int j = 0; j < no_of_edges; ++j)
+		{
+			for (int k = 0; k < no_of_edges; ++k)
+			{
+				edge_index = grid -> adjacent_vector_indices_h[6*i + k];
+				if ((dualgrid -> from_index[edge_index] == face_nodes[MAX_NO_OF_FACE_NODES*i + j]
+				&& dualgrid -> to_index[edge_index] == face_nodes[MAX_NO_OF_FACE_NODES*i + (j + 1)%no_of_edges])
+				|| (dualgrid -> to_index[edge_index] == face_nodes[MAX_NO_OF_FACE_NODES*i + j]
+				&& dualgrid -> from_index[edge_index] == face_nodes[MAX_NO_OF_FACE_NODES*i + (j + 1)%no_of_edges]))
+				{
+					face_edges[MAX_NO_OF_FACE_NODES*i + j] = edge_index;
+				}
+			}
+		}
+	}
+	int *edge_nodes = malloc(2*NO_OF_VECTORS_H*sizeof(int));
+	int *edge_faces = malloc(2*NO_OF_VECTORS_H*sizeof(int));
+	for (int i = 0; i < NO_OF_VECTORS_H; ++i)
+	{
+		edge_nodes[2*i] = dualgrid -> from_index[i];
+		edge_nodes[2*i + 1] = dualgrid -> to_index[i];
+		edge_faces[2*i] = grid -> from_index[i];
+		edge_faces[2*i + 1] = grid -> to_index[i];
+	}
+	// the coordinates in degrees
+	double *node_x = malloc(NO_OF_DUAL_SCALARS_H*sizeof(double));
+	double *node_y = malloc(NO_OF_DUAL_SCALARS_H*sizeof(double));
+	double *face_x = malloc(NO_OF_SCALARS_H*sizeof(double));
+	double *face_y = malloc(NO_OF_SCALARS_H*sizeof(double));
+	double *edge_x = malloc(NO_OF_VECTORS_H*sizeof(double));
+	double *edge_y = malloc(NO_OF_VECTORS_H*sizeof(double));
+	for (int i = 0; i < NO_OF_DUAL_SCALARS_H; ++i)
+	{
+		node_x[i] = rad2deg(longitude_vertices[i]);
+		node_y[i] = rad2deg(latitude_vertices[i]);
+	}
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		face_x[i] = rad2deg(grid -> longitude_scalar[i]);
+		face_y[i] = rad2deg(grid -> latitude_scalar[i]);
+	}
+	for (int i = 0; i < NO_OF_VECTORS_H; ++i)
+	{
+		edge_x[i] = rad2deg(longitude_edges[i]);
+		edge_y[i] = rad2deg(latitude_edges[i]);
+	}
+	free(latitude_vertices);
+	free(longitude_vertices);
+	free(latitude_edges);
+	free(longitude_edges);
+
+	// creating the file
+	char OUTPUT_FILE[300];
+	sprintf(OUTPUT_FILE, "%s_ugrid.nc", config_io -> run_id);
+	// the classic format needs 64 bit offsets for files that grow beyond 2 GB
+	int create_mode = NC_CLOBBER | NC_64BIT_OFFSET;
+	if (config_io -> netcdf4_switch == 1)
+	{
+		create_mode = NC_CLOBBER | NC_NETCDF4;
+	}
+	if ((retval = nc_create(OUTPUT_FILE, create_mode, &ugrid_ncid)))
+		NCERR(retval);
+	ncid = ugrid_ncid;
+	ugrid_no_of_records = 0;
+	int node_dimid, edge_dimid, face_dimid, max_face_nodes_dimid, two_dimid, layer_dimid, level_dimid, time_dimid;
+	if ((retval = nc_def_dim(ncid, "nMesh_node", NO_OF_DUAL_SCALARS_H, &node_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "nMesh_edge", NO_OF_VECTORS_H, &edge_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "nMesh_face", NO_OF_SCALARS_H, &face_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "nMaxMesh_face_nodes", MAX_NO_OF_FACE_NODES, &max_face_nodes_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "Two", 2, &two_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "layer", NO_OF_LAYERS, &layer_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "level", NO_OF_LEVELS, &level_dimid)))
+		NCERR(retval);
+	if ((retval = nc_def_dim(ncid, "time", NC_UNLIMITED, &time_dimid)))
+		NCERR(retval);
+
+	// the mesh topology
+	int mesh_id, topology_dimension = 2, fill_value = -1, start_index = 0;
+	if ((retval = nc_def_var(ncid, "mesh", NC_INT, 0, NULL, &mesh_id)))
+		NCERR(retval);
+	put_text_attribute(ncid, mesh_id, "cf_role", "mesh_topology");
+	put_text_attribute(ncid, mesh_id, "long_name", "topology of the hexagonal model grid");
+	if ((retval = nc_put_att_int(ncid, mesh_id, "topology_dimension", NC_INT, 1, &topology_dimension)))
+		NCERR(retval);
+	put_text_attribute(ncid, mesh_id, "node_coordinates", "mesh_node_x mesh_node_y");
+	put_text_attribute(ncid, mesh_id, "face_coordinates", "mesh_face_x mesh_face_y");
+	put_text_attribute(ncid, mesh_id, "edge_coordinates", "mesh_edge_x mesh_edge_y");
+	put_text_attribute(ncid, mesh_id, "face_node_connectivity", "mesh_face_nodes");
+	put_text_attribute(ncid, mesh_id, "edge_node_connectivity", "mesh_edge_nodes");
+	put_text_attribute(ncid, mesh_id, "face_edge_connectivity", "mesh_face_edges");
+	put_text_attribute(ncid, mesh_id, "edge_face_connectivity", "mesh_edge_faces");
+	put_text_attribute(ncid, mesh_id, "face_dimension", "nMesh_face");
+	put_text_attribute(ncid, mesh_id, "edge_dimension", "nMesh_edge");
+
+	// the coordinates
+	int node_x_id, node_y_id, face_x_id, face_y_id, edge_x_id, edge_y_id;
+	if ((retval = nc_def_var(ncid, "mesh_node_x", NC_DOUBLE, 1, &node_dimid, &node_x_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "mesh_node_y", NC_DOUBLE, 1, &node_dimid, &node_y_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "mesh_face_x", NC_DOUBLE, 1, &face_dimid, &face_x_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "mesh_face_y", NC_DOUBLE, 1, &face_dimid, &face_y_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "mesh_edge_x", NC_DOUBLE, 1, &edge_dimid, &edge_x_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "mesh_edge_y", NC_DOUBLE, 1, &edge_dimid, &edge_y_id)))
+		NCERR(retval);
+	int x_ids[3] = {node_x_id, face_x_id, edge_x_id};
+	int y_ids[3] = {node_y_id, face_y_id, edge_y_id};
+	for (int i = 0; i < 3; ++i)
+	{
+		put_text_attribute(ncid, x_ids[i], "standard_name", "longitude");
+		put_text_attribute(ncid, x_ids[i], "units", "degrees_east");
+		put_text_attribute(ncid, y_ids[i], "standard_name", "latitude");
+		put_text_attribute(ncid, y_ids[i], "units", "degrees_north");
+	}
+
+	// the connectivity
+	int face_nodes_id, face_edges_id, edge_nodes_id, edge_faces_id;
+	int face_connectivity_dimids[2] = {face_dimid, max_face_nodes_dimid};
+	int edge_connectivity_dimids[2] = {edge_dimid, two_dimid};
+	if ((retval = nc_def_var(ncid, "mesh_face_nodes", NC_INT, 2, face_connectivity_dimids, &face_nodes_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "mesh_face_edges", NC_INT, 2, face_connectivity_dimids, &face_edges_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "mesh_edge_nodes", NC_INT, 2, edge_connectivity_dimids, &edge_nodes_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "mesh_edge_faces", NC_INT, 2, edge_connectivity_dimids, &edge_faces_id)))
+		NCERR(retval);
+	put_text_attribute(ncid, face_nodes_id, "cf_role", "face_node_connectivity");
+	put_text_attribute(ncid, face_edges_id, "cf_role", "face_edge_connectivity");
+	put_text_attribute(ncid, edge_nodes_id, "cf_role", "edge_node_connectivity");
+	put_text_attribute(ncid, edge_faces_id, "cf_role", "edge_face_connectivity");
+	int connectivity_ids[4] = {face_nodes_id, face_edges_id, edge_nodes_id, edge_faces_id};
+	for (int i = 0; i < 4; ++i)
+	{
+		if ((retval = nc_put_att_int(ncid, connectivity_ids[i], "start_index", NC_INT, 1, &start_index)))
+			NCERR(retval);
+	}
+	// pentagons have only five nodes and edges
+	if ((retval = nc_put_att_int(ncid, face_nodes_id, "_FillValue", NC_INT, 1, &fill_value)))
+		NCERR(retval);
+	if ((retval = nc_put_att_int(ncid, face_edges_id, "_FillValue", NC_INT, 1, &fill_value)))
+		NCERR(retval);
+
+	// the vertical coordinates and the time
+	int z_face_id, z_face_level_id, z_edge_id, time_id;
+	int layer_face_dimids[2] = {layer_dimid, face_dimid};
+	int level_face_dimids[2] = {level_dimid, face_dimid};
+	int layer_edge_dimids[2] = {layer_dimid, edge_dimid};
+	if ((retval = nc_def_var(ncid, "z_face", NC_DOUBLE, 2, layer_face_dimids, &z_face_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "z_face_level", NC_DOUBLE, 2, level_face_dimids, &z_face_level_id)))
+		NCERR(retval);
+	if ((retval = nc_def_var(ncid, "z_edge", NC_DOUBLE, 2, layer_edge_dimids, &z_edge_id)))
+		NCERR(retval);
+	put_text_attribute(ncid, z_face_id, "long_name", "height of the layer centers");
+	put_text_attribute(ncid, z_face_level_id, "long_name", "height of the level centers");
+	put_text_attribute(ncid, z_edge_id, "long_name", "height of the horizontal vector points");
+	int z_ids[3] = {z_face_id, z_face_level_id, z_edge_id};
+	for (int i = 0; i < 3; ++i)
+	{
+		put_text_attribute(ncid, z_ids[i], "units", "m");
+		put_text_attribute(ncid, z_ids[i], "mesh", "mesh");
+	}
+	put_text_attribute(ncid, z_face_id, "location", "face");
+	put_text_attribute(ncid, z_face_level_id, "location", "face");
+	put_text_attribute(ncid, z_edge_id, "location", "edge");
+	if ((retval = nc_def_var(ncid, "time", NC_DOUBLE, 1, &time_dimid, &time_id)))
+		NCERR(retval);
+	put_text_attribute(ncid, time_id, "units", "s since init");
+
+	// the fields
+	def_ugrid_field(ncid, "temperature", time_dimid, layer_dimid, face_dimid, "face", "K", NO_OF_SCALARS_H, config_io);
+	def_ugrid_field(ncid, "pressure", time_dimid, layer_dimid, face_dimid, "face", "Pa", NO_OF_SCALARS_H, config_io);
+	def_ugrid_field(ncid, "rh", time_dimid, layer_dimid, face_dimid, "face", "%", NO_OF_SCALARS_H, config_io);
+	def_ugrid_field(ncid, "wind_u", time_dimid, layer_dimid, face_dimid, "face", "m/s", NO_OF_SCALARS_H, config_io);
+	def_ugrid_field(ncid, "wind_v", time_dimid, layer_dimid, face_dimid, "face", "m/s", NO_OF_SCALARS_H, config_io);
+	def_ugrid_field(ncid, "rel_vort", time_dimid, layer_dimid, face_dimid, "face", "1/s", NO_OF_SCALARS_H, config_io);
+	def_ugrid_field(ncid, "divv_h_all_layers", time_dimid, layer_dimid, face_dimid, "face", "1/s", NO_OF_SCALARS_H, config_io);
+	def_ugrid_field(ncid, "tke", time_dimid, layer_dimid, face_dimid, "face", "J/kg", NO_OF_SCALARS_H, config_io);
+	def_ugrid_field(ncid, "wind_h", time_dimid, layer_dimid, edge_dimid, "edge", "m/s", NO_OF_VECTORS_H, config_io);
+	def_ugrid_field(ncid, "wind_w", time_dimid, level_dimid, face_dimid, "face", "m/s", NO_OF_SCALARS_H, config_io);
+	if ((retval = nc_enddef(ncid)))
+		NCERR(retval);
+
+	// writing the mesh
+	if ((retval = nc_put_var_double(ncid, node_x_id, &node_x[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, node_y_id, &node_y[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, face_x_id, &face_x[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, face_y_id, &face_y[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, edge_x_id, &edge_x[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, edge_y_id, &edge_y[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_int(ncid, face_nodes_id, &face_nodes[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_int(ncid, face_edges_id, &face_edges[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_int(ncid, edge_nodes_id, &edge_nodes[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_int(ncid, edge_faces_id, &edge_faces[0])))
+		NCERR(retval);
+	if ((retval = nc_put_var_double(ncid, z_face_id, &grid -> z_scalar[0])))
+		NCERR(retval);
+	// the vertical and horizontal vector points of a layer alternate in the model arrays
+	size_t start[2], count[2];
+	for (int i = 0; i < NO_OF_LEVELS; ++i)
+	{
+		start[0] = i;
+		start[1] = 0;
+		count[0] = 1;
+		count[1] = NO_OF_SCALARS_H;
+		if ((retval = nc_put_vara_double(ncid, z_face_level_id, start, count, &grid -> z_vector[i*NO_OF_VECTORS_PER_LAYER])))
+			NCERR(retval);
+	}
+	for (int i = 0; i < NO_OF_LAYERS; ++i)
+	{
+		start[0] = i;
+		start[1] = 0;
+		count[0] = 1;
+		count[1] = NO_OF_VECTORS_H;
+		if ((retval = nc_put_vara_double(ncid, z_edge_id, start, count, &grid -> z_vector[i*NO_OF_VECTORS_PER_LAYER + NO_OF_SCALARS_H])))
+			NCERR(retval);
+	}
+	if ((retval = nc_sync(ncid)))
+		NCERR(retval);
+	free(face_nodes);
+	free(face_edges);
+	free(edge_nodes);
+	free(edge_faces);
+	free(node_x);
+	free(node_y);
+	free(face_x);
+	free(face_y);
+	free(edge_x);
+	free(edge_y);
+	return 0;
+}
+
+int write_ugrid_output(double time_since_init, State *state_write_out, Diagnostics *diagnostics, Scalar_field pressure, Scalar_field rh,
+Scalar_field rel_vort, Scalar_field divv_h_all_layers, Irreversible_quantities *irrev, Config_io *config_io)
+{
+	/*
+	This function appends the fields of one output time to the UGRID output file, rounded according to output_keepbits.
+	*/
+	int retval, varid;
+	int ncid = ugrid_ncid;
+	size_t record = ugrid_no_of_records;
+	// the model fields must not be changed, so they are rounded in a copy, which holds a scalar field or one layer of the horizontal wind
+	int no_of_rounded_values = NO_OF_SCALARS > NO_OF_VECTORS_H ? NO_OF_SCALARS : NO_OF_VECTORS_H;
+	double *rounded_field = malloc(no_of_rounded_values*sizeof(double));
+	// the scalar fields are stored layer by layer, exactly like in the file
+	char *scalar_names[8] = {"temperature", "pressure", "rh", "wind_u", "wind_v", "rel_vort", "divv_h_all_layers", "tke"};
+	double *scalar_fields[8] = {diagnostics -> temperature, pressure, rh, diagnostics -> u_at_cell, diagnostics -> v_at_cell, rel_vort,
+	divv_h_all_layers, irrev -> tke};
+	size_t start[3] = {record, 0, 0};
+	size_t count[3] = {1, NO_OF_LAYERS, NO_OF_SCALARS_H};
+	for (int i = 0; i < 8; ++i)
+	{
+		if ((retval = nc_inq_varid(ncid, scalar_names[i], &varid)))
+			NCERR(retval);
+		if ((retval = nc_put_vara_double(ncid, varid, start, count, round_ugrid_field(scalar_fields[i], NO_OF_SCALARS, rounded_field, scalar_names[i],
+		config_io))))
+			NCERR(retval);
+	}
+	// the horizontal and vertical wind are written layer by layer (level by level) from the wind field
+	count[1] = 1;
+	count[2] = NO_OF_VECTORS_H;
+	if ((retval = nc_inq_varid(ncid, "wind_h", &varid)))
+		NCERR(retval);
+	for (int i = 0; i < NO_OF_LAYERS; ++i)
+	{
+		start[1] = i;
+		if ((retval = nc_put_vara_double(ncid, varid, start, count, round_ugrid_field(&state_write_out -> wind[i*NO_OF_VECTORS_PER_LAYER + NO_OF_SCALARS_H],
+		NO_OF_VECTORS_H, rounded_field, "wind_h", config_io))))
+			NCERR(retval);
+	}
+	count[2] = NO_OF_SCALARS_H;
+	if ((retval = nc_inq_varid(ncid, "wind_w", &varid)))
+		NCERR(retval);
+	for (int i = 0; i < NO_OF_LEVELS; ++i)
+	{
+		start[1] = i;
+		if ((retval = nc_put_vara_double(ncid, varid, start, count, round_ugrid_field(&state_write_out -> wind[i*NO_OF_VECTORS_PER_LAYER],
+		NO_OF_SCALARS_H, rounded_field, "wind_w", config_io))))
+			NCERR(retval);
+	}
+	free(rounded_field);
+	if ((retval = nc_inq_varid(ncid, "time", &varid)))
+		NCERR(retval);
+	if ((retval = nc_put_var1_double(ncid, varid, &record, &time_since_init)))
+		NCERR(retval);
+	// the file can be read while the model is still running
+	if ((retval = nc_sync(ncid)))
+		NCERR(retval);
+	++ugrid_no_of_records;
+	return 0;
+}
+
+double *round_ugrid_field(double field[], int no_of_values, double rounded_field[], char name[], Config_io *config_io)
+{
+	/*
+	This function returns field rounded according to output_keepbits, the rounded values are written to rounded_field.
+	If the variable name is not rounded, field itself is returned.
+	*/
+	int keepbits = get_output_keepbits(config_io -> output_keepbits, name);
+	if (keepbits <= 0)
+	{
+		return field;
+	}
+	memcpy(rounded_field, field, no_of_values*sizeof(double));
+	round_mantissa(rounded_field, no_of_values, keepbits);
+	return rounded_field;
+}
+
+int close_ugrid_output()
+{
+	/*
+	This function closes the UGRID output file at the end of the run.
+	*/
+	int retval;
+	if (ugrid_ncid != -1)
+	{
+		if ((retval = nc_close(ugrid_ncid)))
+			NCERR(retval);
+		ugrid_ncid = -1;
+	}
+	return 0;
+}
+
+int def_ugrid_field(int ncid, char var_name[], int time_dimid, int vertical_dimid, int horizontal_dimid, char location[], char units[],
+size_t chunk_length, Config_io *config_io)
+{
+	/*
+	This function defines a field of the UGRID output file.
+	*/
+	int retval, varid;
+	int dimids[3] = {time_dimid, vertical_dimid, horizontal_dimid};
+	if ((retval = nc_def_var(ncid, var_name, NC_DOUBLE, 3, dimids, &varid)))
+		NCERR(retval);
+	// one chunk per layer and output time
+	size_t chunk_shape[3] = {1, 1, chunk_length};
+	set_netcdf_var_storage(ncid, varid, chunk_shape, config_io);
+	put_text_attribute(ncid, varid, "units", units);
+	put_text_attribute(ncid, varid, "mesh", "mesh");
+	put_text_attribute(ncid, varid, "location", location);
+	if (strcmp(location, "face") == 0)
+	{
+		put_text_attribute(ncid, varid, "coordinates", "mesh_face_x mesh_face_y");
+	}
+	else
+	{
+		put_text_attribute(ncid, varid, "coordinates", "mesh_edge_x mesh_edge_y");
+	}
+	return 0;
+}
+
+int put_text_attribute(int ncid, int varid, char att_name[], char value[])
+{
+	/*
+	This function sets a text attribute of a netcdf variable.
+	*/
+	int retval;
+	if ((retval = nc_put_att_text(ncid, varid, att_name, strlen(value), value)))
+		NCERR(retval);
+	return 0;
+}
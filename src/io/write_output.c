@@ -10,8 +10,15 @@ In addition to that, some postprocessing diagnostics are also calculated here.
 
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
 #include <time.h>
+#include <sys/stat.h>
 #include <netcdf.h>
+#include <netcdf_meta.h>
+#if defined(NC_HAS_ZSTD) && NC_HAS_ZSTD
+#include <netcdf_filter.h>
+#endif
 #include <eccodes.h>
 #include <geos95.h>
 #include "../game_types.h"
@@ -24,29 +31,164 @@ In addition to that, some postprocessing diagnostics are also calculated here.
 #define ECCERR(e) {printf("Error: Eccodes failed with error code %d. See http://download.ecmwf.int/test-data/eccodes/html/group__errors.html for meaning of the error codes.\n", e); exit(ERRCODE);}
 #define NCERR(e) {printf("Error: %s\n", nc_strerror(e)); exit(2);}
 
-int set_basic_props2grib(codes_handle *, long, long, long, long, long, long);
+// everything needed to encode one GRIB message of a horizontal field
+typedef struct grib_message {
+double *field;
+char *name;
+long parameter_category;
+long parameter_number;
+long type_of_first_fixed_surface;
+long scaled_value_of_first_fixed_surface;
+long level;
+char *short_name;
+} Grib_message;
+
+// a file of the netcdf time series output, it stays open for the whole run and every output time appends one record
+typedef struct netcdf_time_series {
+int open_bool;
+int ncid;
+int no_of_records;
+} Netcdf_time_series;
+
+// the output products
+enum output_products {SURFACE_PRODUCT, PRESSURE_LEVEL_PRODUCT, MODEL_LEVEL_PRODUCT};
+
+// the shared intermediates output variables are diagnosed from, every one is computed at most once per output time
+enum output_inputs {
+PRESSURE_INPUT = 1,
+REL_VORT_INPUT = 2,
+UV_AT_CELL_INPUT = 4,
+RH_INPUT = 8,
+DIVV_H_INPUT = 16,
+EPV_INPUT = 32};
+
+// an entry of the registry of output variables, inputs is a combination of the bits of output_inputs
+typedef struct output_variable {
+char *name;
+int product;
+int inputs;
+} Output_variable;
+
+// the number of mantissa bits an output variable is rounded to by default
+typedef struct output_keepbits {
+char *name;
+int keepbits;
+} Output_keepbits;
+
+codes_handle *new_grib_base_handle(long, long, long, long, Latlon_grid *, Config_io *);
+FILE *open_grib_file(char []);
+int set_grib_message(Grib_message *, char [], double [], long, long, long, long, long, char []);
+int encode_grib_messages(codes_handle *, FILE *, Grib_message [], int, Grid *, Config_io *);
+int get_grib_bits_per_value(char [], char []);
+char *get_list_entry(char [], char []);
+int report_compression_ratio(char [], double);
+int close_netcdf_output_file(int);
+int get_netcdf_create_mode(Config_io *);
+int open_netcdf_output(char [], Netcdf_time_series *, Config_io *, int *, int *, int *);
+int get_netcdf_dimids(int, int, int []);
+int put_netcdf_field(int, char [], int, double [], int);
+int finish_netcdf_output(int, Netcdf_time_series *, int, double);
+int def_netcdf_output_variable(int, char [], int, int [], size_t [], char [], char [], Config_io *);
+int put_netcdf_output_variable(int, char [], int, double [], char [], char []);
+int write_model_level_netcdf(char [], Netcdf_time_series *, double, State *, Diagnostics *, Scalar_field, Scalar_field, Scalar_field,
+Irreversible_quantities *, char [], char [], Config_io *);
+int output_product_requested(char [], int);
+int get_output_inputs(Config_io *, int);
+int select_grib_messages(Grib_message [], int, char []);
 double global_scalar_integrator(Scalar_field, Grid *);
 double pseudopotential_temperature(State *, Diagnostics *, Grid *, int);
 
-// the number of pressure levels for the pressure level output
-const int NO_OF_PRESSURE_LEVELS = 6;
+// the template all GRIB messages are derived from
+const char GRIB_TEMPLATE_FILE[] = "../../src/io/grib_template.grb2";
+// the range of bits per value accepted in grib_bits_per_value
+const int MIN_GRIB_BITS_PER_VALUE = 1;
+const int MAX_GRIB_BITS_PER_VALUE = 32;
+// the number of GRIB messages which are interpolated to the lat-lon grid at once, this bounds the memory of the interpolated fields
+const int GRIB_BATCH_SIZE = 64;
+// the number of explicit mantissa bits of a double, more bits cannot be kept by the bit rounding
+const int MAX_OUTPUT_KEEPBITS = 52;
+// the number of decimal digits accepted in output_keepbits
+const int MAX_OUTPUT_KEEPDIGITS = 15;
 
-int get_pressure_levels(double pressure_levels[])
-{
-	/*
-	This function returns the pressure levels for the pressure level output.
-	Can be modified by the user (before compiling). Unit is Pa.
-	Remember to adjust NO_OF_PRESSURE_LEVELS adequately.
-	*/
-	
-	pressure_levels[0] = 20000;
-	pressure_levels[1] = 30000;
-	pressure_levels[2] = 50000;
-	pressure_levels[3] = 70000;
-	pressure_levels[4] = 85000;
-	pressure_levels[5] = 92500;
-	return 0;
-}
+/*
+the registry of the output variables, a variable is only diagnosed and written if its name is in the output list (output_variables)
+names that exist in several products (like temperature) select the variable in all of them
+*/
+const Output_variable OUTPUT_VARIABLES[] = {
+{"surface_p", SURFACE_PRODUCT, 0},
+{"mslp", SURFACE_PRODUCT, 0},
+{"t2", SURFACE_PRODUCT, 0},
+{"rprate", SURFACE_PRODUCT, 0},
+{"cape", SURFACE_PRODUCT, 0},
+{"sfc_sw_down", SURFACE_PRODUCT, 0},
+{"sprate", SURFACE_PRODUCT, 0},
+{"tcdc", SURFACE_PRODUCT, 0},
+{"10u", SURFACE_PRODUCT, 0},
+{"10v", SURFACE_PRODUCT, 0},
+{"10gusts", SURFACE_PRODUCT, 0},
+{"geopotential_height", PRESSURE_LEVEL_PRODUCT, PRESSURE_INPUT},
+{"temperature", PRESSURE_LEVEL_PRODUCT, PRESSURE_INPUT},
+{"relative_humidity", PRESSURE_LEVEL_PRODUCT, PRESSURE_INPUT | RH_INPUT},
+{"relative_vorticity", PRESSURE_LEVEL_PRODUCT, PRESSURE_INPUT | REL_VORT_INPUT},
+{"ertels_potential_vorticity", PRESSURE_LEVEL_PRODUCT, PRESSURE_INPUT | EPV_INPUT},
+{"wind_u", PRESSURE_LEVEL_PRODUCT, PRESSURE_INPUT | UV_AT_CELL_INPUT},
+{"wind_v", PRESSURE_LEVEL_PRODUCT, PRESSURE_INPUT | UV_AT_CELL_INPUT},
+{"temperature", MODEL_LEVEL_PRODUCT, 0},
+{"pressure", MODEL_LEVEL_PRODUCT, PRESSURE_INPUT},
+{"rh", MODEL_LEVEL_PRODUCT, RH_INPUT},
+{"wind_u", MODEL_LEVEL_PRODUCT, UV_AT_CELL_INPUT},
+{"wind_v", MODEL_LEVEL_PRODUCT, UV_AT_CELL_INPUT},
+{"rel_vort", MODEL_LEVEL_PRODUCT, REL_VORT_INPUT},
+{"divv_h_all_layers", MODEL_LEVEL_PRODUCT, DIVV_H_INPUT},
+{"wind_w", MODEL_LEVEL_PRODUCT, 0},
+{"densities", MODEL_LEVEL_PRODUCT, 0},
+{"wind", MODEL_LEVEL_PRODUCT, 0},
+{"tke", MODEL_LEVEL_PRODUCT, 0},
+{"t_soil", MODEL_LEVEL_PRODUCT, 0}};
+const int NO_OF_OUTPUT_VARIABLES = sizeof(OUTPUT_VARIABLES)/sizeof(Output_variable);
+
+/*
+the numbers of mantissa bits the output variables are rounded to with output_keepbits = "default", chosen from the precision of the model and of observations,
+variables which are not listed are not rounded
+*/
+const Output_keepbits DEFAULT_OUTPUT_KEEPBITS[] = {
+{"surface_p", 16},
+{"mslp", 16},
+{"t2", 12},
+{"rprate", 6},
+{"cape", 8},
+{"sfc_sw_down", 8},
+{"sprate", 6},
+{"tcdc", 6},
+{"10u", 8},
+{"10v", 8},
+{"10gusts", 8},
+{"geopotential_height", 14},
+{"temperature", 12},
+{"relative_humidity", 6},
+{"relative_vorticity", 8},
+{"ertels_potential_vorticity", 8},
+{"wind_u", 8},
+{"wind_v", 8},
+{"pressure", 16},
+{"rh", 6},
+{"rel_vort", 8},
+{"divv_h_all_layers", 8},
+{"wind_w", 8},
+{"densities", 14},
+{"wind", 8},
+{"wind_h", 8},
+{"tke", 8},
+{"t_soil", 12}};
+const int NO_OF_DEFAULT_OUTPUT_KEEPBITS = sizeof(DEFAULT_OUTPUT_KEEPBITS)/sizeof(Output_keepbits);
+
+// the GRIB template, read only once per model run by read_grib_template
+codes_handle *grib_template = NULL;
+
+// the files of the netcdf time series output (netcdf_time_series_switch == 1) of every output stream, open_bool is 0 as long as a file has not been created
+Netcdf_time_series surface_time_series[MAX_NO_OF_OUTPUT_STREAMS];
+Netcdf_time_series pressure_level_time_series[MAX_NO_OF_OUTPUT_STREAMS];
+Netcdf_time_series model_level_time_series[MAX_NO_OF_OUTPUT_STREAMS];
 
 int write_out(State *state_write_out, double wind_h_lowest_layer_array[], int min_no_of_output_steps, double t_init, double t_write, Diagnostics *diagnostics, Forcings *forcings, Grid *grid, Dualgrid *dualgrid, Config_io *config_io, Config *config, Irreversible_quantities *irrev)
 {
@@ -71,24 +213,42 @@ int write_out(State *state_write_out, double wind_h_lowest_layer_array[], int mi
 	
 	// Needed for netcdf.
     int retval;
-	int err = 0;
 	
 	int layer_index, closest_index, second_closest_index;
 	double cloud_water_content;
 	double vector_to_minimize[NO_OF_LAYERS];
 	
-	double *grib_output_field = malloc(NO_OF_LATLON_IO_POINTS*sizeof(double));
 	
 	// diagnosing the temperature
 	temperature_diagnostics(state_write_out, grid, diagnostics);
 	
+	/*
+	at the time of the next analysis the model level output (of the first output stream which is due then) is the background state of the data assimilation,
+	which always contains all its variables
+	*/
+	int da_background_bool = config_io -> output_stream_index == config_io -> da_background_stream_index && config_io -> ideal_input_id == -1
+	&& (int) (t_write - t_init) == config -> time_to_next_analysis;
+	
 	/*
 	Surface output including diagnostics.
 	-------------------------------------
 	*/
 	
-	if (config_io -> surface_output_switch == 1)
+	if (config_io -> surface_output_switch == 1 && output_product_requested(config_io -> output_variables, SURFACE_PRODUCT) == 1)
 	{
+		// only the requested diagnostics are computed
+		int mslp_bool = output_variable_requested(config_io -> output_variables, "mslp");
+		int surface_p_bool = output_variable_requested(config_io -> output_variables, "surface_p");
+		int t2_bool = output_variable_requested(config_io -> output_variables, "t2");
+		int cape_bool = output_variable_requested(config_io -> output_variables, "cape");
+		int sfc_sw_down_bool = output_variable_requested(config_io -> output_variables, "sfc_sw_down");
+		int tcdc_bool = output_variable_requested(config_io -> output_variables, "tcdc");
+		int sprate_bool = output_variable_requested(config_io -> output_variables, "sprate");
+		int rprate_bool = output_variable_requested(config_io -> output_variables, "rprate");
+		int gusts_bool = output_variable_requested(config_io -> output_variables, "10gusts");
+		// the gusts are diagnosed from the mean 10 m wind
+		int wind_10_m_bool = output_variable_requested(config_io -> output_variables, "10u") == 1
+		|| output_variable_requested(config_io -> output_variables, "10v") == 1 || gusts_bool == 1;
 		double *mslp = malloc(NO_OF_SCALARS_H*sizeof(double));
 		double *surface_p = malloc(NO_OF_SCALARS_H*sizeof(double));
 		double *t2 = malloc(NO_OF_SCALARS_H*sizeof(double));
@@ -109,123 +269,147 @@ int write_out(State *state_write_out, double wind_h_lowest_layer_array[], int mi
 		    pressure_value = state_write_out -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i]
 		    *gas_constant_diagnostics(state_write_out, (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i, config)
 		    *temp_lowest_layer;
-		    temp_mslp = temp_lowest_layer + standard_vert_lapse_rate*grid -> z_scalar[i + (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H];
-		    mslp_factor = pow(1 - (temp_mslp - temp_lowest_layer)/temp_mslp, grid -> gravity_m[(NO_OF_LAYERS - 1)*NO_OF_VECTORS_PER_LAYER + i]/
-		    (gas_constant_diagnostics(state_write_out, (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i, config)*standard_vert_lapse_rate));
-		    mslp[i] = pressure_value/mslp_factor;
+		    if (mslp_bool == 1)
+		    {
+			    temp_mslp = temp_lowest_layer + standard_vert_lapse_rate*grid -> z_scalar[i + (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H];
+			    mslp_factor = pow(1 - (temp_mslp - temp_lowest_layer)/temp_mslp, grid -> gravity_m[(NO_OF_LAYERS - 1)*NO_OF_VECTORS_PER_LAYER + i]/
+			    (gas_constant_diagnostics(state_write_out, (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i, config)*standard_vert_lapse_rate));
+			    mslp[i] = pressure_value/mslp_factor;
+		    }
 		    
 			// Now the aim is to determine the value of the surface pressure.
-			temp_surface = temp_lowest_layer + standard_vert_lapse_rate*(grid -> z_scalar[i + (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H] - grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i]);
-		    surface_p_factor = pow(1.0 - (temp_surface - temp_lowest_layer)/temp_surface, grid -> gravity_m[(NO_OF_LAYERS - 1)*NO_OF_VECTORS_PER_LAYER + i]/
-		    (gas_constant_diagnostics(state_write_out, (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i, config)*standard_vert_lapse_rate));
-			surface_p[i] = pressure_value/surface_p_factor;
-			
-			// Now the aim is to calculate the 2 m temperature.
-			for (int j = 0; j < NO_OF_LAYERS; ++j)
+			if (surface_p_bool == 1)
 			{
-				vector_to_minimize[j] = fabs(grid -> z_vector[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i] + 2 - grid -> z_scalar[i + j*NO_OF_SCALARS_H]);
+				temp_surface = temp_lowest_layer + standard_vert_lapse_rate*(grid -> z_scalar[i + (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H] - grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i]);
+			    surface_p_factor = pow(1.0 - (temp_surface - temp_lowest_layer)/temp_surface, grid -> gravity_m[(NO_OF_LAYERS - 1)*NO_OF_VECTORS_PER_LAYER + i]/
+			    (gas_constant_diagnostics(state_write_out, (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i, config)*standard_vert_lapse_rate));
+				surface_p[i] = pressure_value/surface_p_factor;
 			}
-			closest_index = find_min_index(vector_to_minimize, NO_OF_LAYERS);
-		    temp_closest = diagnostics -> temperature[closest_index*NO_OF_SCALARS_H + i];
-			delta_z_temp = grid -> z_vector[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i] + 2 - grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H];
-		    // real radiation
-		    if (config -> prog_soil_temp == 1)
-		    {
-		    	temperature_gradient = (temp_closest - state_write_out -> temperature_soil[i])
-		    	/(grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] - grid -> z_vector[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i]);
-		    }
-			// no real radiation
-		    else
+			
+			// Now the aim is to calculate the 2 m temperature.
+			if (t2_bool == 1)
 			{
-				second_closest_index = closest_index - 1;
-				if (grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] > grid -> z_vector[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i] + 2 && closest_index < NO_OF_LAYERS - 1)
+				for (int j = 0; j < NO_OF_LAYERS; ++j)
 				{
-					second_closest_index = closest_index + 1;
+					vector_to_minimize[j] = fabs(grid -> z_vector[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i] + 2 - grid -> z_scalar[i + j*NO_OF_SCALARS_H]);
 				}
-				temp_second_closest = diagnostics -> temperature[second_closest_index*NO_OF_SCALARS_H + i];
-				// calculating the vertical temperature gradient that will be used for the extrapolation
-				temperature_gradient = (temp_closest - temp_second_closest)/(grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] - grid -> z_scalar[i + second_closest_index*NO_OF_SCALARS_H]);
-		    }
-		    // performing the interpolation / extrapolation to two meters above the surface
-		    t2[i] = temp_closest + delta_z_temp*temperature_gradient;
+				closest_index = find_min_index(vector_to_minimize, NO_OF_LAYERS);
+			    temp_closest = diagnostics -> temperature[closest_index*NO_OF_SCALARS_H + i];
+				delta_z_temp = grid -> z_vector[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i] + 2 - grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H];
+			    // real radiation
+			    if (config -> prog_soil_temp == 1)
+			    {
+			    	temperature_gradient = (temp_closest - state_write_out -> temperature_soil[i])
+			    	/(grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] - grid -> z_vector[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i]);
+			    }
+				// no real radiation
+			    else
+				{
+					second_closest_index = closest_index - 1;
+					if (grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] > grid -> z_vector[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i] + 2 && closest_index < NO_OF_LAYERS - 1)
+					{
+						second_closest_index = closest_index + 1;
+					}
+					temp_second_closest = diagnostics -> temperature[second_closest_index*NO_OF_SCALARS_H + i];
+					// calculating the vertical temperature gradient that will be used for the extrapolation
+					temperature_gradient = (temp_closest - temp_second_closest)/(grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] - grid -> z_scalar[i + second_closest_index*NO_OF_SCALARS_H]);
+			    }
+			    // performing the interpolation / extrapolation to two meters above the surface
+			    t2[i] = temp_closest + delta_z_temp*temperature_gradient;
+			}
 		    
 		    // diagnozing CAPE
-			// initializing CAPE with zero
-			cape[i] = 0.0;
-			layer_index = NO_OF_LAYERS - 1;
-		    z_height = grid -> z_scalar[layer_index*NO_OF_SCALARS_H + i];
-		    // pseduovirtual potential temperature of the particle in the lowest layer
-		    theta_e = pseudopotential_temperature(state_write_out, diagnostics, grid, layer_index*NO_OF_SCALARS_H + i);
-			while (z_height < z_tropopause)
-			{
-				// full virtual potential temperature in the grid box
-			    theta_v = grid -> theta_v_bg[layer_index*NO_OF_SCALARS_H + i] + state_write_out -> theta_v_pert[layer_index*NO_OF_SCALARS_H + i];
-			    // thickness of the gridbox
-				delta_z = grid -> layer_thickness[layer_index*NO_OF_SCALARS_H + i];
-				// this is the candidate that we might want to add to the integral
-				cape_integrand
-				= grid -> gravity_m[layer_index*NO_OF_VECTORS_PER_LAYER + i]*(theta_e - theta_v)/theta_v;
-				// we do not add negative values to CAPE (see the definition of CAPE)
-				if (cape_integrand > 0.0)
+		    if (cape_bool == 1)
+		    {
+				// initializing CAPE with zero
+				cape[i] = 0.0;
+				layer_index = NO_OF_LAYERS - 1;
+			    z_height = grid -> z_scalar[layer_index*NO_OF_SCALARS_H + i];
+			    // pseduovirtual potential temperature of the particle in the lowest layer
+			    theta_e = pseudopotential_temperature(state_write_out, diagnostics, grid, layer_index*NO_OF_SCALARS_H + i);
+				while (z_height < z_tropopause)
 				{
-					cape[i] += cape_integrand*delta_z;
+					// full virtual potential temperature in the grid box
+				    theta_v = grid -> theta_v_bg[layer_index*NO_OF_SCALARS_H + i] + state_write_out -> theta_v_pert[layer_index*NO_OF_SCALARS_H + i];
+				    // thickness of the gridbox
+					delta_z = grid -> layer_thickness[layer_index*NO_OF_SCALARS_H + i];
+					// this is the candidate that we might want to add to the integral
+					cape_integrand
+					= grid -> gravity_m[layer_index*NO_OF_VECTORS_PER_LAYER + i]*(theta_e - theta_v)/theta_v;
+					// we do not add negative values to CAPE (see the definition of CAPE)
+					if (cape_integrand > 0.0)
+					{
+						cape[i] += cape_integrand*delta_z;
+					}
+					--layer_index;
+					z_height = grid -> z_scalar[layer_index*NO_OF_SCALARS_H + i];
 				}
-				--layer_index;
-				z_height = grid -> z_scalar[layer_index*NO_OF_SCALARS_H + i];
 			}
 			
-			sfc_sw_down[i] = forcings -> sfc_sw_in[i]/(1.0 - grid -> sfc_albedo[i] + EPSILON_SECURITY);
+			if (sfc_sw_down_bool == 1)
+			{
+				sfc_sw_down[i] = forcings -> sfc_sw_in[i]/(1.0 - grid -> sfc_albedo[i] + EPSILON_SECURITY);
+			}
 		    
 		    // Now come the hydrometeors.
 		    // Calculation of the total cloud cover
-		    if (NO_OF_CONDENSED_CONSTITUENTS == 4)
+		    if (tcdc_bool == 1)
 		    {
-		    	// calculating the cloud water content in this column
-        		cloud_water_content = 0.0;
-    	        for (int k = 0; k < NO_OF_LAYERS; ++k)
+			    if (NO_OF_CONDENSED_CONSTITUENTS == 4)
 			    {
-			    	if (grid -> z_scalar[k*NO_OF_SCALARS_H + i] < z_tropopause)
-			    	{
-			    		cloud_water_content += (state_write_out -> rho[2*NO_OF_SCALARS + k*NO_OF_SCALARS_H + i]
-			    		+ state_write_out -> rho[3*NO_OF_SCALARS + k*NO_OF_SCALARS_H + i])
-			    		*(grid -> z_vector[i + k*NO_OF_VECTORS_PER_LAYER] - grid -> z_vector[i + (k + 1)*NO_OF_VECTORS_PER_LAYER]);
-			    	}
-			    }
-			    // some heuristic ansatz for the total cloud cover
-            	tcdc[i] = fmin(cloud_water2cloudiness*cloud_water_content, 1.0);
-            	// conversion of the total cloud cover into a percentage
-            	tcdc[i] = 100.0*tcdc[i];
-            	// setting too small values to zero to not confuse users
-            	if (tcdc[i] < 0.5)
-            	{
-            		tcdc[i] = 0.0;
-            	}
-            }
-            else
-            {
-            	tcdc[i] = 0.0;
-            }
+			    	// calculating the cloud water content in this column
+	        		cloud_water_content = 0.0;
+	    	        for (int k = 0; k < NO_OF_LAYERS; ++k)
+				    {
+				    	if (grid -> z_scalar[k*NO_OF_SCALARS_H + i] < z_tropopause)
+				    	{
+				    		cloud_water_content += (state_write_out -> rho[2*NO_OF_SCALARS + k*NO_OF_SCALARS_H + i]
+				    		+ state_write_out -> rho[3*NO_OF_SCALARS + k*NO_OF_SCALARS_H + i])
+				    		*(grid -> z_vector[i + k*NO_OF_VECTORS_PER_LAYER] - grid -> z_vector[i + (k + 1)*NO_OF_VECTORS_PER_LAYER]);
+				    	}
+				    }
+				    // some heuristic ansatz for the total cloud cover
+	            	tcdc[i] = fmin(cloud_water2cloudiness*cloud_water_content, 1.0);
+	            	// conversion of the total cloud cover into a percentage
+	            	tcdc[i] = 100.0*tcdc[i];
+	            	// setting too small values to zero to not confuse users
+	            	if (tcdc[i] < 0.5)
+	            	{
+	            		tcdc[i] = 0.0;
+	            	}
+	            }
+	            else
+	            {
+	            	tcdc[i] = 0.0;
+	            }
+			}
             // solid precipitation rate
-		    sprate[i] = 0.0;
-			if (NO_OF_CONDENSED_CONSTITUENTS == 4)
-		    {
-		        sprate[i] = config -> snow_velocity*state_write_out -> rho[(NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i];
+            if (sprate_bool == 1)
+            {
+			    sprate[i] = 0.0;
+				if (NO_OF_CONDENSED_CONSTITUENTS == 4)
+			    {
+			        sprate[i] = config -> snow_velocity*state_write_out -> rho[(NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i];
+		        }
+		        // setting very small values to zero
+		        if (sprate[i] < min_precip_rate)
+		        {
+		        	sprate[i] = 0.0;
+		        }
 	        }
 	        // liquid precipitation rate
-		    rprate[i] = 0.0;
-			if (NO_OF_CONDENSED_CONSTITUENTS == 4)
-		    {
-		        rprate[i] = config -> rain_velocity*state_write_out -> rho[NO_OF_SCALARS + (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i];
-	        }
-	        // setting very small values to zero
-	        if (rprate[i] < min_precip_rate)
-	        {
-	        	rprate[i] = 0.0;
-	        }
-	        // setting very small values to zero
-	        if (sprate[i] < min_precip_rate)
-	        {
-	        	sprate[i] = 0.0;
+            if (rprate_bool == 1)
+            {
+			    rprate[i] = 0.0;
+				if (NO_OF_CONDENSED_CONSTITUENTS == 4)
+			    {
+			        rprate[i] = config -> rain_velocity*state_write_out -> rho[NO_OF_SCALARS + (NO_OF_LAYERS - 1)*NO_OF_SCALARS_H + i];
+		        }
+		        // setting very small values to zero
+		        if (rprate[i] < min_precip_rate)
+		        {
+		        	rprate[i] = 0.0;
+		        }
 	        }
 		}
 		
@@ -233,473 +417,213 @@ int write_out(State *state_write_out, double wind_h_lowest_layer_array[], int mi
 		10 m wind diagnostics
 		---------------------
 		*/
-		double wind_tangential, wind_u_value, wind_v_value;
-		int j;
-		double *wind_10_m_mean_u = malloc(NO_OF_VECTORS_H*sizeof(double));
-		double *wind_10_m_mean_v = malloc(NO_OF_VECTORS_H*sizeof(double));
-		// temporal average over the ten minutes output interval
-		#pragma omp parallel for private(j, wind_tangential, wind_u_value, wind_v_value)
-		for (int h_index = 0; h_index < NO_OF_VECTORS_H; ++h_index)
+		double *wind_10_m_mean_u_at_cell = malloc(NO_OF_SCALARS_H*sizeof(double));
+		double *wind_10_m_mean_v_at_cell = malloc(NO_OF_SCALARS_H*sizeof(double));
+		double *wind_10_m_gusts_speed_at_cell = malloc(NO_OF_SCALARS_H*sizeof(double));
+		if (wind_10_m_bool == 1)
 		{
-			// initializing the means with zero
-			wind_10_m_mean_u[h_index] = 0.0;
-			wind_10_m_mean_v[h_index] = 0.0;
-			// loop over the time steps
-			for (int time_step_10_m_wind = 0; time_step_10_m_wind < min_no_of_output_steps; ++time_step_10_m_wind)
+			double wind_tangential, wind_u_value, wind_v_value;
+			int j;
+			double *wind_10_m_mean_u = malloc(NO_OF_VECTORS_H*sizeof(double));
+			double *wind_10_m_mean_v = malloc(NO_OF_VECTORS_H*sizeof(double));
+			// temporal average over the ten minutes output interval
+			#pragma omp parallel for private(j, wind_tangential, wind_u_value, wind_v_value)
+			for (int h_index = 0; h_index < NO_OF_VECTORS_H; ++h_index)
 			{
-				j = time_step_10_m_wind*NO_OF_VECTORS_H + h_index;
-				wind_tangential = 0.0;
-				for (int i = 0; i < 10; ++i)
+				// initializing the means with zero
+				wind_10_m_mean_u[h_index] = 0.0;
+				wind_10_m_mean_v[h_index] = 0.0;
+				// loop over the time steps
+				for (int time_step_10_m_wind = 0; time_step_10_m_wind < min_no_of_output_steps; ++time_step_10_m_wind)
 				{
-					wind_tangential += grid -> trsk_weights[10*h_index + i]*wind_h_lowest_layer_array[time_step_10_m_wind*NO_OF_VECTORS_H + grid -> trsk_indices[10*h_index + i]];
+					j = time_step_10_m_wind*NO_OF_VECTORS_H + h_index;
+					wind_tangential = 0.0;
+					for (int i = 0; i < 10; ++i)
+					{
+						wind_tangential += grid -> trsk_weights[10*h_index + i]*wind_h_lowest_layer_array[time_step_10_m_wind*NO_OF_VECTORS_H + grid -> trsk_indices[10*h_index + i]];
+					}
+					wind_10_m_mean_u[h_index] += 1.0/min_no_of_output_steps*wind_h_lowest_layer_array[j];
+					wind_10_m_mean_v[h_index] += 1.0/min_no_of_output_steps*wind_tangential;
 				}
-				wind_10_m_mean_u[h_index] += 1.0/min_no_of_output_steps*wind_h_lowest_layer_array[j];
-				wind_10_m_mean_v[h_index] += 1.0/min_no_of_output_steps*wind_tangential;
+				// passive turn to obtain the u- and v-components of the wind
+				passive_turn(wind_10_m_mean_u[h_index], wind_10_m_mean_v[h_index], -grid -> direction[h_index], &wind_u_value, &wind_v_value);
+				wind_10_m_mean_u[h_index] = wind_u_value;
+				wind_10_m_mean_v[h_index] = wind_v_value;
 			}
-			// passive turn to obtain the u- and v-components of the wind
-			passive_turn(wind_10_m_mean_u[h_index], wind_10_m_mean_v[h_index], -grid -> direction[h_index], &wind_u_value, &wind_v_value);
-			wind_10_m_mean_u[h_index] = wind_u_value;
-			wind_10_m_mean_v[h_index] = wind_v_value;
-		}
-		// vertically extrapolating to ten meters above the surface
-		double roughness_length_extrapolation, actual_roughness_length, z_sfc, z_agl, rescale_factor;
-		#pragma omp parallel for private(roughness_length_extrapolation, actual_roughness_length, z_sfc, z_agl, rescale_factor)
-		for (int i = 0; i < NO_OF_VECTORS_H; ++i)
-		{
-			actual_roughness_length = 0.5*(grid -> roughness_length[grid -> from_index[i]] + grid -> roughness_length[grid -> to_index[i]]);
-			// roughness length of grass according to WMO
-			roughness_length_extrapolation = 0.02;
-			if (grid -> is_land[grid -> from_index[i]] == 0)
+			// vertically extrapolating to ten meters above the surface
+			double roughness_length_extrapolation, actual_roughness_length, z_sfc, z_agl, rescale_factor;
+			#pragma omp parallel for private(roughness_length_extrapolation, actual_roughness_length, z_sfc, z_agl, rescale_factor)
+			for (int i = 0; i < NO_OF_VECTORS_H; ++i)
 			{
-				roughness_length_extrapolation = actual_roughness_length;
-			}
-			z_sfc = 0.5*(grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + grid -> from_index[i]] + grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + grid -> to_index[i]]);
-			z_agl = grid -> z_vector[NO_OF_VECTORS - NO_OF_VECTORS_PER_LAYER + i] - z_sfc;
+				actual_roughness_length = 0.5*(grid -> roughness_length[grid -> from_index[i]] + grid -> roughness_length[grid -> to_index[i]]);
+				// roughness length of grass according to WMO
+				roughness_length_extrapolation = 0.02;
+				if (grid -> is_land[grid -> from_index[i]] == 0)
+				{
+					roughness_length_extrapolation = actual_roughness_length;
+				}
+				z_sfc = 0.5*(grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + grid -> from_index[i]] + grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + grid -> to_index[i]]);
+				z_agl = grid -> z_vector[NO_OF_VECTORS - NO_OF_VECTORS_PER_LAYER + i] - z_sfc;
 			
-			// rescale factor for computing the wind in a height of 10 m
-			rescale_factor = log(10.0/roughness_length_extrapolation)/log(z_agl/actual_roughness_length);
+				// rescale factor for computing the wind in a height of 10 m
+				rescale_factor = log(10.0/roughness_length_extrapolation)/log(z_agl/actual_roughness_length);
 			
-			wind_10_m_mean_u[i] = rescale_factor*wind_10_m_mean_u[i];
-			wind_10_m_mean_v[i] = rescale_factor*wind_10_m_mean_v[i];
-		}
+				wind_10_m_mean_u[i] = rescale_factor*wind_10_m_mean_u[i];
+				wind_10_m_mean_v[i] = rescale_factor*wind_10_m_mean_v[i];
+			}
 		
-		// averaging the wind quantities to cell centers for output
-		double *wind_10_m_mean_u_at_cell = malloc(NO_OF_SCALARS_H*sizeof(double));
-		edges_to_cells_lowest_layer(wind_10_m_mean_u, wind_10_m_mean_u_at_cell, grid);
-		free(wind_10_m_mean_u);
-		double *wind_10_m_mean_v_at_cell = malloc(NO_OF_SCALARS_H*sizeof(double));
-		edges_to_cells_lowest_layer(wind_10_m_mean_v, wind_10_m_mean_v_at_cell, grid);
-		free(wind_10_m_mean_v);
+			// averaging the wind quantities to cell centers for output
+			edges_to_cells_lowest_layer(wind_10_m_mean_u, wind_10_m_mean_u_at_cell, grid);
+			free(wind_10_m_mean_u);
+			edges_to_cells_lowest_layer(wind_10_m_mean_v, wind_10_m_mean_v_at_cell, grid);
+			free(wind_10_m_mean_v);
+		}
 		
-		// gust diagnostics
-		double u_850_surrogate, u_950_surrogate;
-		double u_850_proxy_height = 8000.0*log(1000.0/850.0);
-		double u_950_proxy_height = 8000.0*log(1000.0/950.0);
-		double *wind_10_m_gusts_speed_at_cell = malloc(NO_OF_SCALARS_H*sizeof(double));
-		#pragma omp parallel for private(closest_index, second_closest_index, u_850_surrogate, u_950_surrogate)
-		for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+		if (gusts_bool == 1)
 		{
-			// This is the normal case.
-			if ((config -> sfc_sensible_heat_flux == 1 || config -> sfc_phase_trans == 1 || config -> pbl_scheme == 1)
-			&& fabs(diagnostics -> monin_obukhov_length[i]) > EPSILON_SECURITY)
+			// gust diagnostics
+			double u_850_surrogate, u_950_surrogate;
+			double u_850_proxy_height = 8000.0*log(1000.0/850.0);
+			double u_950_proxy_height = 8000.0*log(1000.0/950.0);
+			#pragma omp parallel for private(closest_index, second_closest_index, u_850_surrogate, u_950_surrogate)
+			for (int i = 0; i < NO_OF_SCALARS_H; ++i)
 			{
-				// This follows IFS DOCUMENTATION – Cy43r1 - Operational implementation 22 Nov 2016 - PART IV: PHYSICAL PROCESSES.
-				wind_10_m_gusts_speed_at_cell[i] = pow(pow(wind_10_m_mean_u_at_cell[i], 2) + pow(wind_10_m_mean_v_at_cell[i], 2), 0.5)
-				+ 7.71*diagnostics -> roughness_velocity[i]*pow(fmax(1.0 - 0.5/12.0*1000.0/diagnostics -> monin_obukhov_length[i], 0.0), 1.0/3.0);
-				// calculating the wind speed in a height representing 850 hPa
-				for (int j = 0; j < NO_OF_LAYERS; ++j)
-				{
-					vector_to_minimize[j] = fabs(grid -> z_scalar[j*NO_OF_SCALARS_H + i] - (grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] + u_850_proxy_height));
-				}
-				closest_index = find_min_index(vector_to_minimize, NO_OF_LAYERS);
-				second_closest_index = closest_index - 1;
-				if (closest_index < NO_OF_LAYERS - 1
-				&& grid -> z_scalar[closest_index*NO_OF_SCALARS_H + i] - grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] > u_850_proxy_height)
-				{
-					second_closest_index = closest_index + 1;
-				}
-				u_850_surrogate = pow(diagnostics -> v_squared[i + closest_index*NO_OF_SCALARS_H], 0.5)
-				+ (pow(diagnostics -> v_squared[i + closest_index*NO_OF_SCALARS_H], 0.5) - pow(diagnostics -> v_squared[i + second_closest_index*NO_OF_SCALARS_H], 0.5))
-				/(grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] - grid -> z_scalar[i + second_closest_index*NO_OF_SCALARS_H])
-				*(grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] + u_850_proxy_height - grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H]);
-				// calculating the wind speed in a height representing 950 hPa
-				for (int j = 0; j < NO_OF_LAYERS; ++j)
+				// This is the normal case.
+				if ((config -> sfc_sensible_heat_flux == 1 || config -> sfc_phase_trans == 1 || config -> pbl_scheme == 1)
+				&& fabs(diagnostics -> monin_obukhov_length[i]) > EPSILON_SECURITY)
 				{
-					vector_to_minimize[j] = fabs(grid -> z_scalar[j*NO_OF_SCALARS_H + i] - (grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] + u_950_proxy_height));
+					// This follows IFS DOCUMENTATION – Cy43r1 - Operational implementation 22 Nov 2016 - PART IV: PHYSICAL PROCESSES.
+					wind_10_m_gusts_speed_at_cell[i] = pow(pow(wind_10_m_mean_u_at_cell[i], 2) + pow(wind_10_m_mean_v_at_cell[i], 2), 0.5)
+					+ 7.71*diagnostics -> roughness_velocity[i]*pow(fmax(1.0 - 0.5/12.0*1000.0/diagnostics -> monin_obukhov_length[i], 0.0), 1.0/3.0);
+					// calculating the wind speed in a height representing 850 hPa
+					for (int j = 0; j < NO_OF_LAYERS; ++j)
+					{
+						vector_to_minimize[j] = fabs(grid -> z_scalar[j*NO_OF_SCALARS_H + i] - (grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] + u_850_proxy_height));
+					}
+					closest_index = find_min_index(vector_to_minimize, NO_OF_LAYERS);
+					second_closest_index = closest_index - 1;
+					if (closest_index < NO_OF_LAYERS - 1
+					&& grid -> z_scalar[closest_index*NO_OF_SCALARS_H + i] - grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] > u_850_proxy_height)
+					{
+						second_closest_index = closest_index + 1;
+					}
+					u_850_surrogate = pow(diagnostics -> v_squared[i + closest_index*NO_OF_SCALARS_H], 0.5)
+					+ (pow(diagnostics -> v_squared[i + closest_index*NO_OF_SCALARS_H], 0.5) - pow(diagnostics -> v_squared[i + second_closest_index*NO_OF_SCALARS_H], 0.5))
+					/(grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] - grid -> z_scalar[i + second_closest_index*NO_OF_SCALARS_H])
+					*(grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] + u_850_proxy_height - grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H]);
+					// calculating the wind speed in a height representing 950 hPa
+					for (int j = 0; j < NO_OF_LAYERS; ++j)
+					{
+						vector_to_minimize[j] = fabs(grid -> z_scalar[j*NO_OF_SCALARS_H + i] - (grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] + u_950_proxy_height));
+					}
+					closest_index = find_min_index(vector_to_minimize, NO_OF_LAYERS);
+					second_closest_index = closest_index - 1;
+					if (closest_index < NO_OF_LAYERS - 1
+					&& grid -> z_scalar[closest_index*NO_OF_SCALARS_H + i] - grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] > u_950_proxy_height)
+					{
+						second_closest_index = closest_index + 1;
+					}
+					u_950_surrogate = pow(diagnostics -> v_squared[i + closest_index*NO_OF_SCALARS_H], 0.5)
+					+ (pow(diagnostics -> v_squared[i + closest_index*NO_OF_SCALARS_H], 0.5) - pow(diagnostics -> v_squared[i + second_closest_index*NO_OF_SCALARS_H], 0.5))
+					/(grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] - grid -> z_scalar[i + second_closest_index*NO_OF_SCALARS_H])
+					*(grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] + u_950_proxy_height - grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H]);
+					// adding the baroclinic and convective component to the gusts
+					wind_10_m_gusts_speed_at_cell[i] += 0.6*fmax(0.0, u_850_surrogate - u_950_surrogate);
+					wind_10_m_gusts_speed_at_cell[i] = fmin(wind_10_m_gusts_speed_at_cell[i], 3.0*pow(pow(wind_10_m_mean_u_at_cell[i], 2) + pow(wind_10_m_mean_v_at_cell[i], 2), 0.5));
 				}
-				closest_index = find_min_index(vector_to_minimize, NO_OF_LAYERS);
-				second_closest_index = closest_index - 1;
-				if (closest_index < NO_OF_LAYERS - 1
-				&& grid -> z_scalar[closest_index*NO_OF_SCALARS_H + i] - grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] > u_950_proxy_height)
+				// This is used if the turbulence quantities are not populated.
+				else
 				{
-					second_closest_index = closest_index + 1;
+					wind_10_m_gusts_speed_at_cell[i] = 1.67*pow(pow(wind_10_m_mean_u_at_cell[i], 2) + pow(wind_10_m_mean_v_at_cell[i], 2), 0.5);
 				}
-				u_950_surrogate = pow(diagnostics -> v_squared[i + closest_index*NO_OF_SCALARS_H], 0.5)
-				+ (pow(diagnostics -> v_squared[i + closest_index*NO_OF_SCALARS_H], 0.5) - pow(diagnostics -> v_squared[i + second_closest_index*NO_OF_SCALARS_H], 0.5))
-				/(grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H] - grid -> z_scalar[i + second_closest_index*NO_OF_SCALARS_H])
-				*(grid -> z_vector[NO_OF_VECTORS - NO_OF_SCALARS_H + i] + u_950_proxy_height - grid -> z_scalar[i + closest_index*NO_OF_SCALARS_H]);
-				// adding the baroclinic and convective component to the gusts
-				wind_10_m_gusts_speed_at_cell[i] += 0.6*fmax(0.0, u_850_surrogate - u_950_surrogate);
-				wind_10_m_gusts_speed_at_cell[i] = fmin(wind_10_m_gusts_speed_at_cell[i], 3.0*pow(pow(wind_10_m_mean_u_at_cell[i], 2) + pow(wind_10_m_mean_v_at_cell[i], 2), 0.5));
-			}
-			// This is used if the turbulence quantities are not populated.
-			else
-			{
-				wind_10_m_gusts_speed_at_cell[i] = 1.67*pow(pow(wind_10_m_mean_u_at_cell[i], 2) + pow(wind_10_m_mean_v_at_cell[i], 2), 0.5);
 			}
 		}
 		
 		// Netcdf output.
 		if (config_io -> netcdf_output_switch == 1)
 		{
-			char OUTPUT_FILE_PRE[300];
-			sprintf(OUTPUT_FILE_PRE, "%s+%ds_surface.nc", config_io -> run_id, (int) (t_write - t_init));
-			char OUTPUT_FILE[strlen(OUTPUT_FILE_PRE) + 1];
-			sprintf(OUTPUT_FILE, "%s+%ds_surface.nc", config_io -> run_id, (int) (t_write - t_init));
-			int scalar_h_dimid, mslp_id, ncid, retval, surface_p_id, rprate_id, sprate_id, cape_id, tcdc_id, t2_id, u10_id, v10_id, gusts_id, sfc_sw_down_id;
+			char OUTPUT_FILE[300];
+			Netcdf_time_series *time_series = NULL;
+			if (config_io -> netcdf_time_series_switch == 1)
+			{
+				sprintf(OUTPUT_FILE, "%s_surface.nc", config_io -> run_id);
+				time_series = &surface_time_series[config_io -> output_stream_index];
+			}
+			else
+			{
+				sprintf(OUTPUT_FILE, "%s+%ds_surface.nc", config_io -> run_id, (int) (t_write - t_init));
+			}
+			int scalar_h_dimid, ncid, record, time_dimid, retval;
 			
-			if ((retval = nc_create(OUTPUT_FILE, NC_CLOBBER, &ncid)))
-				NCERR(retval);
-			if ((retval = nc_def_dim(ncid, "scalar_index_h", NO_OF_SCALARS_H, &scalar_h_dimid)))
-				NCERR(retval);
+			// the variables are only defined when the file is created
+			if (open_netcdf_output(OUTPUT_FILE, time_series, config_io, &ncid, &record, &time_dimid) == 1)
+			{
+				if ((retval = nc_def_dim(ncid, "scalar_index_h", NO_OF_SCALARS_H, &scalar_h_dimid)))
+					NCERR(retval);
+				int dimids[2];
+				int no_of_dims = get_netcdf_dimids(time_dimid, scalar_h_dimid, dimids);
+				// one chunk per field (and output time)
+				size_t chunk_shape[2] = {1, NO_OF_SCALARS_H};
 			
-			// Defining the variables.
-			if ((retval = nc_def_var(ncid, "mslp", NC_DOUBLE, 1, &scalar_h_dimid, &mslp_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, mslp_id, "units", strlen("Pa"), "Pa")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "surface_p", NC_DOUBLE, 1, &scalar_h_dimid, &surface_p_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, surface_p_id, "units", strlen("Pa"), "Pa")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "t2", NC_DOUBLE, 1, &scalar_h_dimid, &t2_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, t2_id, "units", strlen("K"), "K")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "tcdc", NC_DOUBLE, 1, &scalar_h_dimid, &tcdc_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, tcdc_id, "units", strlen("%"), "%")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "rprate", NC_DOUBLE, 1, &scalar_h_dimid, &rprate_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, rprate_id, "units", strlen("kg/(m^2s)"), "kg/(m^2s)")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "sprate", NC_DOUBLE, 1, &scalar_h_dimid, &sprate_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, sprate_id, "units", strlen("kg/(m^2s)"), "kg/(m^2s)")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "cape", NC_DOUBLE, 1, &scalar_h_dimid, &cape_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, cape_id, "units", strlen("J/kg"), "J/kg")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "sfc_sw_down", NC_DOUBLE, 1, &scalar_h_dimid, &sfc_sw_down_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, sfc_sw_down_id, "units", strlen("W/m^2"), "W/m^2")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "10u", NC_DOUBLE, 1, &scalar_h_dimid, &u10_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, u10_id, "units", strlen("m/s"), "m/s")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "10v", NC_DOUBLE, 1, &scalar_h_dimid, &v10_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, v10_id, "units", strlen("m/s"), "m/s")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid, "10gusts", NC_DOUBLE, 1, &scalar_h_dimid, &gusts_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid, gusts_id, "units", strlen("m/s"), "m/s")))
-				NCERR(retval);
-			if ((retval = nc_enddef(ncid)))
-				NCERR(retval);
+				// Defining the variables.
+				def_netcdf_output_variable(ncid, "mslp", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "Pa", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "surface_p", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "Pa", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "t2", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "K", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "tcdc", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "%", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "rprate", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "kg/(m^2s)", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "sprate", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "kg/(m^2s)", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "cape", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "J/kg", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "sfc_sw_down", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "W/m^2", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "10u", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "m/s", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "10v", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "m/s", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid, "10gusts", no_of_dims, dimids, &chunk_shape[2 - no_of_dims], "m/s", config_io -> output_variables, config_io);
+				if ((retval = nc_enddef(ncid)))
+					NCERR(retval);
+			}
 			
-			if ((retval = nc_put_var_double(ncid, mslp_id, &mslp[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, surface_p_id, &surface_p[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, t2_id, &t2[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, tcdc_id, &tcdc[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, rprate_id, &rprate[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, sprate_id, &sprate[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, cape_id, &cape[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, sfc_sw_down_id, &sfc_sw_down[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, u10_id, &wind_10_m_mean_u_at_cell[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, v10_id, &wind_10_m_mean_v_at_cell[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid, gusts_id, &wind_10_m_gusts_speed_at_cell[0])))
-				NCERR(retval);
+			put_netcdf_output_variable(ncid, "mslp", record, mslp, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "surface_p", record, surface_p, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "t2", record, t2, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "tcdc", record, tcdc, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "rprate", record, rprate, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "sprate", record, sprate, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "cape", record, cape, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "sfc_sw_down", record, sfc_sw_down, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "10u", record, wind_10_m_mean_u_at_cell, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "10v", record, wind_10_m_mean_v_at_cell, config_io -> output_variables, config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid, "10gusts", record, wind_10_m_gusts_speed_at_cell, config_io -> output_variables, config_io -> output_keepbits);
 			
-			// Closing the netcdf file.
-			if ((retval = nc_close(ncid)))
-				NCERR(retval);
+			// closing the netcdf file or appending the time of the record
+			finish_netcdf_output(ncid, time_series, record, t_write - t_init);
 		}
 		
 		// Grib output.
 		if (config_io -> grib_output_switch == 1)
 		{
-			long unsigned tcc_string_length = 4;
-			long unsigned cape_string_length = 5;
 			char OUTPUT_FILE_PRE[300];
 			sprintf(OUTPUT_FILE_PRE, "%s+%ds_surface.grb2", config_io -> run_id, (int) (t_write - t_init));
 			char OUTPUT_FILE[strlen(OUTPUT_FILE_PRE) + 1];
 			sprintf(OUTPUT_FILE, "%s+%ds_surface.grb2", config_io -> run_id, (int) (t_write - t_init));
-			char *SAMPLE_FILENAME = "../../src/io/grib_template.grb2";
-			FILE *SAMPLE_FILE;
-			if (t_init < 0)
-				exit(1);
-			FILE *OUT_GRIB;
-			OUT_GRIB = fopen(OUTPUT_FILE, "w+");
-			codes_handle *handle_wind_u_10m_mean = NULL;
-			codes_handle *handle_wind_v_10m_mean = NULL;
-			codes_handle *handle_mslp = NULL;
-			codes_handle *handle_surface_p = NULL;
-			codes_handle *handle_t2 = NULL;
-			codes_handle *handle_tcdc = NULL;
-			codes_handle *handle_rprate = NULL;
-			codes_handle *handle_sprate = NULL;
-			codes_handle *handle_wind_10m_gusts = NULL;
-			codes_handle *handle_cape = NULL;
-			codes_handle *handle_sfc_sw_down = NULL;
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_surface_p = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_surface_p, data_date, data_time, t_write, t_init, 3, 0);
-		    if ((retval = codes_set_long(handle_surface_p, "typeOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_surface_p, "scaledValueOfFirstFixedSurface", 0)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_surface_p, "scaleFactorOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_surface_p, "level", 0)))
-		        ECCERR(retval);
-		    interpolate_to_ll(surface_p, grib_output_field, grid);
-		    if ((retval = codes_set_double_array(handle_surface_p, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-		        ECCERR(retval);
-		    if ((retval = codes_write_message(handle_surface_p, OUTPUT_FILE, "w")))
-		        ECCERR(retval);
-			codes_handle_delete(handle_surface_p);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_mslp = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_mslp, data_date, data_time, t_write, t_init, 3, 1);
-		    if ((retval = codes_set_long(handle_mslp, "typeOfFirstFixedSurface", 102)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_mslp, "scaledValueOfFirstFixedSurface", 0)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_mslp, "scaleFactorOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_mslp, "level", 0)))
-		        ECCERR(retval);
-		    interpolate_to_ll(mslp, grib_output_field, grid);
-		    if ((retval = codes_set_double_array(handle_mslp, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-		        ECCERR(retval);
-		    if ((retval = codes_write_message(handle_mslp, OUTPUT_FILE, "a")))
-		        ECCERR(retval);
-			codes_handle_delete(handle_mslp);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_t2 = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_t2, data_date, data_time, t_write, t_init, 0, 0);
-		    if ((retval = codes_set_long(handle_t2, "typeOfFirstFixedSurface", 103)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_t2, "scaledValueOfFirstFixedSurface", 2)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_t2, "scaleFactorOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_t2, "level", 2)))
-		        ECCERR(retval);
-		    interpolate_to_ll(t2, grib_output_field, grid);
-		    if ((retval = codes_set_double_array(handle_t2, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-		        ECCERR(retval);
-		    if ((retval = codes_write_message(handle_t2, OUTPUT_FILE, "a")))
-		        ECCERR(retval);
-			codes_handle_delete(handle_t2);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_rprate = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_rprate, data_date, data_time, t_write, t_init, 1, 65);
-		    if ((retval = codes_set_long(handle_rprate, "typeOfFirstFixedSurface", 103)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_rprate, "scaledValueOfFirstFixedSurface", 0)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_rprate, "scaleFactorOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_rprate, "level", 0)))
-		        ECCERR(retval);
-		    interpolate_to_ll(rprate, grib_output_field, grid);
-		    if ((retval = codes_set_double_array(handle_rprate, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-		        ECCERR(retval);
-		    if ((retval = codes_write_message(handle_rprate, OUTPUT_FILE, "a")))
-		        ECCERR(retval);
-			codes_handle_delete(handle_rprate);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_cape = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_cape, data_date, data_time, t_write, t_init, 7, 6);
-		    if ((retval = codes_set_long(handle_cape, "typeOfFirstFixedSurface", 103)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_cape, "scaledValueOfFirstFixedSurface", 0)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_cape, "scaleFactorOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_string(handle_cape, "shortName", "cape", &cape_string_length)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_cape, "level", 0)))
-		        ECCERR(retval);
-		    interpolate_to_ll(cape, grib_output_field, grid);
-		    if ((retval = codes_set_double_array(handle_cape, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-		        ECCERR(retval);
-		    if ((retval = codes_write_message(handle_cape, OUTPUT_FILE, "a")))
-		        ECCERR(retval);
-			codes_handle_delete(handle_cape);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_sfc_sw_down = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_sfc_sw_down, data_date, data_time, t_write, t_init, 4, 7);
-		    if ((retval = codes_set_long(handle_sfc_sw_down, "typeOfFirstFixedSurface", 103)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_sfc_sw_down, "scaledValueOfFirstFixedSurface", 0)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_sfc_sw_down, "scaleFactorOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_sfc_sw_down, "level", 0)))
-		        ECCERR(retval);
-		    interpolate_to_ll(sfc_sw_down, grib_output_field, grid);
-		    if ((retval = codes_set_double_array(handle_sfc_sw_down, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-		        ECCERR(retval);
-		    if ((retval = codes_write_message(handle_sfc_sw_down, OUTPUT_FILE, "a")))
-		        ECCERR(retval);
-			codes_handle_delete(handle_sfc_sw_down);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_sprate = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_sprate, data_date, data_time, t_write, t_init, 1, 66);
-		    if ((retval = codes_set_long(handle_sprate, "typeOfFirstFixedSurface", 103)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_sprate, "scaledValueOfFirstFixedSurface", 0)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_sprate, "scaleFactorOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_sprate, "level", 0)))
-		        ECCERR(retval);
-		    interpolate_to_ll(sprate, grib_output_field, grid);
-		    if ((retval = codes_set_double_array(handle_sprate, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-		        ECCERR(retval);
-		    if ((retval = codes_write_message(handle_sprate, OUTPUT_FILE, "a")))
-		        ECCERR(retval);
-			codes_handle_delete(handle_sprate);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_tcdc = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_tcdc, data_date, data_time, t_write, t_init, 6, 1);
-		    if ((retval = codes_set_long(handle_tcdc, "typeOfFirstFixedSurface", 103)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_tcdc, "scaledValueOfFirstFixedSurface", 0)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_tcdc, "scaleFactorOfFirstFixedSurface", 1)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_long(handle_tcdc, "level", 0)))
-		        ECCERR(retval);
-		    if ((retval = codes_set_string(handle_tcdc, "shortName", "tcc", &tcc_string_length)))
-		        ECCERR(retval);
-		    interpolate_to_ll(tcdc, grib_output_field, grid);
-		    if ((retval = codes_set_double_array(handle_tcdc, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-		        ECCERR(retval);
-		    if ((retval = codes_write_message(handle_tcdc, OUTPUT_FILE, "a")))
-		        ECCERR(retval);
-			codes_handle_delete(handle_tcdc);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_wind_u_10m_mean = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_wind_u_10m_mean, data_date, data_time, t_write, t_init, 2, 2);
-			if ((retval = codes_set_long(handle_wind_u_10m_mean, "typeOfFirstFixedSurface", 103)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_u_10m_mean, "scaledValueOfFirstFixedSurface", 10)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_u_10m_mean, "scaleFactorOfFirstFixedSurface", 1)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_u_10m_mean, "level", 10)))
-				ECCERR(retval);
-		    interpolate_to_ll(wind_10_m_mean_u_at_cell, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_wind_u_10m_mean, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-				ECCERR(retval);
-			if ((retval = codes_write_message(handle_wind_u_10m_mean, OUTPUT_FILE, "a")))
-				ECCERR(retval);
-			codes_handle_delete(handle_wind_u_10m_mean);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_wind_v_10m_mean = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_wind_v_10m_mean, data_date, data_time, t_write, t_init, 2, 3);
-			if ((retval = codes_set_long(handle_wind_v_10m_mean, "typeOfFirstFixedSurface", 103)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_v_10m_mean, "scaledValueOfFirstFixedSurface", 10)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_v_10m_mean, "scaleFactorOfFirstFixedSurface", 1)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_v_10m_mean, "level", 10)))
-				ECCERR(retval);
-		    interpolate_to_ll(wind_10_m_mean_v_at_cell, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_wind_v_10m_mean, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-				ECCERR(retval);
-			if ((retval = codes_write_message(handle_wind_v_10m_mean, OUTPUT_FILE, "a")))
-				ECCERR(retval);
-			codes_handle_delete(handle_wind_v_10m_mean);
-			
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_wind_10m_gusts = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_wind_10m_gusts, data_date, data_time, t_write, t_init, 2, 22);
-			if ((retval = codes_set_long(handle_wind_10m_gusts, "typeOfFirstFixedSurface", 103)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_10m_gusts, "scaledValueOfFirstFixedSurface", 10)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_10m_gusts, "scaleFactorOfFirstFixedSurface", 1)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_10m_gusts, "level", 10)))
-				ECCERR(retval);
-		    interpolate_to_ll(wind_10_m_gusts_speed_at_cell, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_wind_10m_gusts, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-				ECCERR(retval);
-			if ((retval = codes_write_message(handle_wind_10m_gusts, OUTPUT_FILE, "a")))
-				ECCERR(retval);
-			codes_handle_delete(handle_wind_10m_gusts);
+			FILE *OUT_GRIB = open_grib_file(OUTPUT_FILE);
+			// the properties all fields of this file share
+			codes_handle *base_handle = new_grib_base_handle(data_date, data_time, t_write, t_init, &grid -> latlon_grid, config_io);
+			Grib_message grib_messages[11];
+			set_grib_message(&grib_messages[0], "surface_p", surface_p, 3, 0, 1, 0, 0, NULL);
+			set_grib_message(&grib_messages[1], "mslp", mslp, 3, 1, 102, 0, 0, NULL);
+			set_grib_message(&grib_messages[2], "t2", t2, 0, 0, 103, 2, 2, NULL);
+			set_grib_message(&grib_messages[3], "rprate", rprate, 1, 65, 103, 0, 0, NULL);
+			set_grib_message(&grib_messages[4], "cape", cape, 7, 6, 103, 0, 0, "cape");
+			set_grib_message(&grib_messages[5], "sfc_sw_down", sfc_sw_down, 4, 7, 103, 0, 0, NULL);
+			set_grib_message(&grib_messages[6], "sprate", sprate, 1, 66, 103, 0, 0, NULL);
+			set_grib_message(&grib_messages[7], "tcdc", tcdc, 6, 1, 103, 0, 0, "tcc");
+			set_grib_message(&grib_messages[8], "10u", wind_10_m_mean_u_at_cell, 2, 2, 103, 10, 10, NULL);
+			set_grib_message(&grib_messages[9], "10v", wind_10_m_mean_v_at_cell, 2, 3, 103, 10, 10, NULL);
+			set_grib_message(&grib_messages[10], "10gusts", wind_10_m_gusts_speed_at_cell, 2, 22, 103, 10, 10, NULL);
+			int no_of_surface_messages = select_grib_messages(grib_messages, 11, config_io -> output_variables);
+			encode_grib_messages(base_handle, OUT_GRIB, grib_messages, no_of_surface_messages, grid, config_io);
+			codes_handle_delete(base_handle);
 			fclose(OUT_GRIB);
+			report_compression_ratio(OUTPUT_FILE, (double) no_of_surface_messages*grid -> latlon_grid.no_of_lat_points*grid -> latlon_grid.no_of_lon_points*sizeof(double));
 		}
 		
 		free(wind_10_m_mean_u_at_cell);
@@ -715,80 +639,108 @@ int write_out(State *state_write_out, double wind_h_lowest_layer_array[], int mi
 		free(sfc_sw_down);
 	}
     
-    // Diagnostics of quantities that are not surface-specific.    
+    /*
+    Diagnostics of quantities that are not surface-specific.
+    Only the intermediates needed by the requested variables are computed, every one of them once.
+    */
+	int output_inputs = get_output_inputs(config_io, da_background_bool);
     Scalar_field *divv_h_all_layers = calloc(1, sizeof(Scalar_field));
-	divv_h(state_write_out -> wind, *divv_h_all_layers, grid);
-	calc_rel_vort(state_write_out -> wind, diagnostics, grid, dualgrid);
+    if (output_inputs & DIVV_H_INPUT)
+    {
+		divv_h(state_write_out -> wind, *divv_h_all_layers, grid);
+	}
     Scalar_field *rel_vort = calloc(1, sizeof(Scalar_field));
-	curl_field_to_cells(diagnostics -> rel_vort, *rel_vort, grid);
+    if (output_inputs & REL_VORT_INPUT)
+    {
+		calc_rel_vort(state_write_out -> wind, diagnostics, grid, dualgrid);
+		curl_field_to_cells(diagnostics -> rel_vort, *rel_vort, grid);
+	}
 	
-	// Diagnozing the u and v wind components at the vector points.
-	calc_uv_at_edge(state_write_out -> wind, diagnostics -> u_at_edge, diagnostics -> v_at_edge, grid);
-	// Averaging to cell centers for output.
-	edges_to_cells(diagnostics -> u_at_edge, diagnostics -> u_at_cell, grid);
-	edges_to_cells(diagnostics -> v_at_edge, diagnostics -> v_at_cell, grid);
+	if (output_inputs & UV_AT_CELL_INPUT)
+	{
+		// Diagnozing the u and v wind components at the vector points.
+		calc_uv_at_edge(state_write_out -> wind, diagnostics -> u_at_edge, diagnostics -> v_at_edge, grid);
+		// Averaging to cell centers for output.
+		edges_to_cells(diagnostics -> u_at_edge, diagnostics -> u_at_cell, grid);
+		edges_to_cells(diagnostics -> v_at_edge, diagnostics -> v_at_cell, grid);
+	}
     Scalar_field *rh = calloc(1, sizeof(Scalar_field));
     Scalar_field *epv = calloc(1, sizeof(Scalar_field));
     Scalar_field *pressure = calloc(1, sizeof(Scalar_field));
-	#pragma omp parallel for
-    for (int i = 0; i < NO_OF_SCALARS; ++i)
-    {    
-	    if (NO_OF_CONSTITUENTS >= 4)
-	    {
-    		(*rh)[i] = 100.0*rel_humidity(state_write_out -> rho[(NO_OF_CONDENSED_CONSTITUENTS + 1)*NO_OF_SCALARS + i], diagnostics -> temperature[i]);
-    	}
-    	(*pressure)[i] = state_write_out -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + i]*gas_constant_diagnostics(state_write_out, i, config)*diagnostics -> temperature[i];
+    if (output_inputs & (RH_INPUT | PRESSURE_INPUT))
+    {
+		#pragma omp parallel for
+	    for (int i = 0; i < NO_OF_SCALARS; ++i)
+	    {    
+		    if (NO_OF_CONSTITUENTS >= 4 && (output_inputs & RH_INPUT))
+		    {
+	    		(*rh)[i] = 100.0*rel_humidity(state_write_out -> rho[(NO_OF_CONDENSED_CONSTITUENTS + 1)*NO_OF_SCALARS + i], diagnostics -> temperature[i]);
+	    	}
+	    	if (output_inputs & PRESSURE_INPUT)
+	    	{
+	    		(*pressure)[i] = state_write_out -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + i]*gas_constant_diagnostics(state_write_out, i, config)*diagnostics -> temperature[i];
+	    	}
+	    }
     }
     
-	#pragma omp parallel for
-	for (int i = 0; i < NO_OF_SCALARS; ++i)
-	{
-		diagnostics -> scalar_field_placeholder[i] = state_write_out -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + i];
-	}
-    calc_pot_vort(state_write_out -> wind, diagnostics -> scalar_field_placeholder, diagnostics, grid, dualgrid);
-    epv_diagnostics(diagnostics -> pot_vort, state_write_out, *epv, grid, dualgrid);
+    if (output_inputs & EPV_INPUT)
+    {
+		#pragma omp parallel for
+		for (int i = 0; i < NO_OF_SCALARS; ++i)
+		{
+			diagnostics -> scalar_field_placeholder[i] = state_write_out -> rho[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + i];
+		}
+	    calc_pot_vort(state_write_out -> wind, diagnostics -> scalar_field_placeholder, diagnostics, grid, dualgrid);
+	    epv_diagnostics(diagnostics -> pot_vort, state_write_out, *epv, grid, dualgrid);
+    }
     
 	// Pressure level output.
-	double closest_weight;
-    if (config_io -> pressure_level_output_switch == 1)
+    if (config_io -> pressure_level_output_switch == 1 && output_product_requested(config_io -> output_variables, PRESSURE_LEVEL_PRODUCT) == 1)
     {
-    	double *pressure_levels = malloc(sizeof(double)*NO_OF_PRESSURE_LEVELS);
-    	get_pressure_levels(pressure_levels);
+    	// only the requested variables are interpolated
+		int geopotential_height_bool = output_variable_requested(config_io -> output_variables, "geopotential_height");
+		int t_bool = output_variable_requested(config_io -> output_variables, "temperature");
+		int rh_bool = output_variable_requested(config_io -> output_variables, "relative_humidity");
+		int epv_bool = output_variable_requested(config_io -> output_variables, "ertels_potential_vorticity");
+		int rel_vort_bool = output_variable_requested(config_io -> output_variables, "relative_vorticity");
+		int u_bool = output_variable_requested(config_io -> output_variables, "wind_u");
+		int v_bool = output_variable_requested(config_io -> output_variables, "wind_v");
+		// the pressure levels are set in the run script
+		int no_of_pressure_levels = config_io -> no_of_pressure_levels;
+    	double *pressure_levels = config_io -> pressure_levels;
     	// Allocating memory for the variables on pressure levels.
-    	double (*geopotential_height)[NO_OF_PRESSURE_LEVELS] = malloc(sizeof(double[NO_OF_SCALARS_H][NO_OF_PRESSURE_LEVELS]));
-    	double (*t_on_pressure_levels)[NO_OF_PRESSURE_LEVELS] = malloc(sizeof(double[NO_OF_SCALARS_H][NO_OF_PRESSURE_LEVELS]));
-    	double (*rh_on_pressure_levels)[NO_OF_PRESSURE_LEVELS] = malloc(sizeof(double[NO_OF_SCALARS_H][NO_OF_PRESSURE_LEVELS]));
-    	double (*epv_on_pressure_levels)[NO_OF_PRESSURE_LEVELS] = malloc(sizeof(double[NO_OF_SCALARS_H][NO_OF_PRESSURE_LEVELS]));
-    	double (*u_on_pressure_levels)[NO_OF_PRESSURE_LEVELS] = malloc(sizeof(double[NO_OF_SCALARS_H][NO_OF_PRESSURE_LEVELS]));
-    	double (*v_on_pressure_levels)[NO_OF_PRESSURE_LEVELS] = malloc(sizeof(double[NO_OF_SCALARS_H][NO_OF_PRESSURE_LEVELS]));
-    	double (*rel_vort_on_pressure_levels)[NO_OF_PRESSURE_LEVELS] = malloc(sizeof(double[NO_OF_SCALARS_H][NO_OF_PRESSURE_LEVELS]));
+    	double (*geopotential_height)[no_of_pressure_levels] = malloc(sizeof(double[NO_OF_SCALARS_H][no_of_pressure_levels]));
+    	double (*t_on_pressure_levels)[no_of_pressure_levels] = malloc(sizeof(double[NO_OF_SCALARS_H][no_of_pressure_levels]));
+    	double (*rh_on_pressure_levels)[no_of_pressure_levels] = malloc(sizeof(double[NO_OF_SCALARS_H][no_of_pressure_levels]));
+    	double (*epv_on_pressure_levels)[no_of_pressure_levels] = malloc(sizeof(double[NO_OF_SCALARS_H][no_of_pressure_levels]));
+    	double (*u_on_pressure_levels)[no_of_pressure_levels] = malloc(sizeof(double[NO_OF_SCALARS_H][no_of_pressure_levels]));
+    	double (*v_on_pressure_levels)[no_of_pressure_levels] = malloc(sizeof(double[NO_OF_SCALARS_H][no_of_pressure_levels]));
+    	double (*rel_vort_on_pressure_levels)[no_of_pressure_levels] = malloc(sizeof(double[NO_OF_SCALARS_H][no_of_pressure_levels]));
     	
-    	// Vertical interpolation to the pressure levels.
-    	#pragma omp parallel for private(vector_to_minimize, closest_index, second_closest_index, closest_weight)
+    	/*
+    	Vertical interpolation to the pressure levels.
+    	It is approx. p = p_0exp(-z/H) => z = H*log(p_0/p), so the interpolation is linear in log(p).
+    	*/
+    	double *log_pressure_levels = malloc(no_of_pressure_levels*sizeof(double));
+    	for (int i = 0; i < no_of_pressure_levels; ++i)
+    	{
+    		log_pressure_levels[i] = log(pressure_levels[i]);
+    	}
+    	double log_pressure[NO_OF_LAYERS];
+    	int upper_index, lower_index, middle_index, upper_scalar_index, lower_scalar_index;
+    	double upper_weight;
+    	#pragma omp parallel for private(log_pressure, upper_index, lower_index, middle_index, upper_scalar_index, lower_scalar_index, upper_weight)
 		for (int i = 0; i < NO_OF_SCALARS_H; ++i)
 		{
-    		for (int j = 0; j < NO_OF_PRESSURE_LEVELS; ++j)
+			// log(p) is computed only once per column
+			for (int k = 0; k < NO_OF_LAYERS; ++k)
 			{
-				for (int k = 0; k < NO_OF_LAYERS; ++k)
-				{
-					/*
-					It is approx. p = p_0exp(-z/H) => log(p) = log(p_0) - z/H => z/H = log(p_0) - log(p) = log(p_0/p) => z = H*log(p_0/p).
-					This leads to fabs(z_2 - z_1) = fabs(H*log(p_2/p) - H*log(p_1/p)) = H*fabs(log(p_2/p) - log(p_1/p)) = H*fabs(log(p_2/p_1))
-					propto fabs(log(p_2/p_1)).
-					*/
-					vector_to_minimize[k] = fabs(log(pressure_levels[j]/(*pressure)[k*NO_OF_SCALARS_H + i]));
-				}
-				// Finding the model layer that is the closest to the desired pressure level.
-				closest_index = find_min_index(vector_to_minimize, NO_OF_LAYERS);
-				// first guess for the other layer that will be used for the interpolation
-				second_closest_index = closest_index + 1;
-				// in this case, the layer above the closest layer will be used for the interpolation
-				if (pressure_levels[j] < (*pressure)[closest_index*NO_OF_SCALARS_H + i])
-				{
-					second_closest_index = closest_index - 1;
-				}
-				// in this case, a missing value will be written
-				if ((closest_index == NO_OF_LAYERS - 1 && second_closest_index == NO_OF_LAYERS) || (closest_index < 0 || second_closest_index < 0))
+				log_pressure[k] = log((*pressure)[k*NO_OF_SCALARS_H + i]);
+			}
+    		for (int j = 0; j < no_of_pressure_levels; ++j)
+			{
+				// in this case, a missing value will be written (the pressure level is above the highest or below the lowest layer)
+				if (log_pressure_levels[j] < log_pressure[0] || log_pressure_levels[j] > log_pressure[NO_OF_LAYERS - 1])
 				{
 					geopotential_height[i][j] = 9999;
 					t_on_pressure_levels[i][j] = 9999;
@@ -797,376 +749,190 @@ int write_out(State *state_write_out, double wind_h_lowest_layer_array[], int mi
 					rel_vort_on_pressure_levels[i][j] = 9999;
 					u_on_pressure_levels[i][j] = 9999;
 					v_on_pressure_levels[i][j] = 9999;
+					continue;
 				}
-				else
+				/*
+				Binary search of the two layers enclosing the pressure level, the pressure increases monotonically downwards.
+				The pressure of the upper layer is at most the pressure level, lower_index = upper_index + 1.
+				*/
+				upper_index = 0;
+				lower_index = NO_OF_LAYERS - 1;
+				while (lower_index - upper_index > 1)
+				{
+					middle_index = (upper_index + lower_index)/2;
+					if (log_pressure[middle_index] <= log_pressure_levels[j])
+					{
+						upper_index = middle_index;
+					}
+					else
+					{
+						lower_index = middle_index;
+					}
+				}
+				upper_weight = (log_pressure[lower_index] - log_pressure_levels[j])/(log_pressure[lower_index] - log_pressure[upper_index] + EPSILON_SECURITY);
+				upper_scalar_index = upper_index*NO_OF_SCALARS_H + i;
+				lower_scalar_index = lower_index*NO_OF_SCALARS_H + i;
+				// all variables are interpolated with the same indices and weights in one pass
+				if (geopotential_height_bool == 1)
 				{
-					/*
-					this is the interpolation weight:
-					closest_weight = 1 - fabs((delta z)_{closest})/(fabs(z_{closest} - z_{other}))
-					*/
-					closest_weight = 1 - vector_to_minimize[closest_index]/
-					(fabs(log((*pressure)[closest_index*NO_OF_SCALARS_H + i]/(*pressure)[second_closest_index*NO_OF_SCALARS_H + i])) + EPSILON_SECURITY);
-					geopotential_height[i][j] = closest_weight*grid -> gravity_potential[closest_index*NO_OF_SCALARS_H + i]
-					+ (1 - closest_weight)*grid -> gravity_potential[second_closest_index*NO_OF_SCALARS_H + i];
-					geopotential_height[i][j] = geopotential_height[i][j]/G_MEAN_SFC_ABS;
-					t_on_pressure_levels[i][j] = closest_weight*diagnostics -> temperature[closest_index*NO_OF_SCALARS_H + i]
-					+ (1 - closest_weight)*diagnostics -> temperature[second_closest_index*NO_OF_SCALARS_H + i];
-					rh_on_pressure_levels[i][j] = closest_weight*(*rh)[closest_index*NO_OF_SCALARS_H + i]
-					+ (1 - closest_weight)*(*rh)[second_closest_index*NO_OF_SCALARS_H + i];
-					epv_on_pressure_levels[i][j] = closest_weight*(*epv)[closest_index*NO_OF_SCALARS_H + i]
-					+ (1 - closest_weight)*(*epv)[second_closest_index*NO_OF_SCALARS_H + i];
-					rel_vort_on_pressure_levels[i][j] = closest_weight*(*rel_vort)[closest_index*NO_OF_SCALARS_H + i]
-					+ (1 - closest_weight)*(*rel_vort)[second_closest_index*NO_OF_SCALARS_H + i];
-					u_on_pressure_levels[i][j] = closest_weight*diagnostics-> u_at_cell[closest_index*NO_OF_SCALARS_H + i]
-					+ (1 - closest_weight)*diagnostics-> u_at_cell[second_closest_index*NO_OF_SCALARS_H + i];
-					v_on_pressure_levels[i][j] = closest_weight*diagnostics-> v_at_cell[closest_index*NO_OF_SCALARS_H + i]
-					+ (1 - closest_weight)*diagnostics-> v_at_cell[second_closest_index*NO_OF_SCALARS_H + i];
+					geopotential_height[i][j] = (upper_weight*grid -> gravity_potential[upper_scalar_index]
+					+ (1 - upper_weight)*grid -> gravity_potential[lower_scalar_index])/G_MEAN_SFC_ABS;
+				}
+				if (t_bool == 1)
+				{
+					t_on_pressure_levels[i][j] = upper_weight*diagnostics -> temperature[upper_scalar_index]
+					+ (1 - upper_weight)*diagnostics -> temperature[lower_scalar_index];
+				}
+				if (rh_bool == 1)
+				{
+					rh_on_pressure_levels[i][j] = upper_weight*(*rh)[upper_scalar_index] + (1 - upper_weight)*(*rh)[lower_scalar_index];
+				}
+				if (epv_bool == 1)
+				{
+					epv_on_pressure_levels[i][j] = upper_weight*(*epv)[upper_scalar_index] + (1 - upper_weight)*(*epv)[lower_scalar_index];
+				}
+				if (rel_vort_bool == 1)
+				{
+					rel_vort_on_pressure_levels[i][j] = upper_weight*(*rel_vort)[upper_scalar_index] + (1 - upper_weight)*(*rel_vort)[lower_scalar_index];
+				}
+				if (u_bool == 1)
+				{
+					u_on_pressure_levels[i][j] = upper_weight*diagnostics -> u_at_cell[upper_scalar_index]
+					+ (1 - upper_weight)*diagnostics -> u_at_cell[lower_scalar_index];
+				}
+				if (v_bool == 1)
+				{
+					v_on_pressure_levels[i][j] = upper_weight*diagnostics -> v_at_cell[upper_scalar_index]
+					+ (1 - upper_weight)*diagnostics -> v_at_cell[lower_scalar_index];
 				}
 			}
 		}
+		free(log_pressure_levels);
     	
 		// Netcdf output.
 		if (config_io -> netcdf_output_switch == 1)
+		{
+			char OUTPUT_FILE_PRESSURE_LEVEL[300];
+			Netcdf_time_series *time_series = NULL;
+			if (config_io -> netcdf_time_series_switch == 1)
+			{
+				sprintf(OUTPUT_FILE_PRESSURE_LEVEL, "%s_pressure_levels.nc", config_io -> run_id);
+				time_series = &pressure_level_time_series[config_io -> output_stream_index];
+			}
+			else
+			{
+				sprintf(OUTPUT_FILE_PRESSURE_LEVEL, "%s+%ds_pressure_levels.nc", config_io -> run_id, (int) (t_write - t_init));
+			}
+			int ncid_pressure_level, record, time_dimid, scalar_h_dimid, level_dimid, pressure_levels_id;
+			// the variables are only defined when the file is created
+			if (open_netcdf_output(OUTPUT_FILE_PRESSURE_LEVEL, time_series, config_io, &ncid_pressure_level, &record, &time_dimid) == 1)
+			{
+				if ((retval = nc_def_dim(ncid_pressure_level, "scalar_index_h", NO_OF_SCALARS_H, &scalar_h_dimid)))
+					NCERR(retval);
+				if ((retval = nc_def_dim(ncid_pressure_level, "level_index", no_of_pressure_levels, &level_dimid)))
+					NCERR(retval);
+				int dimids_pressure_level_scalar[3];
+				int no_of_dims = get_netcdf_dimids(time_dimid, scalar_h_dimid, dimids_pressure_level_scalar);
+				dimids_pressure_level_scalar[no_of_dims] = level_dimid;
+				++no_of_dims;
+				// one chunk per pressure level (and output time)
+				size_t chunk_shape[3] = {1, NO_OF_SCALARS_H, 1};
+				// Defining the variables.
+				if ((retval = nc_def_var(ncid_pressure_level, "pressure_levels", NC_DOUBLE, 1, &level_dimid, &pressure_levels_id)))
+					NCERR(retval);
+				if ((retval = nc_put_att_text(ncid_pressure_level, pressure_levels_id, "units", strlen("Pa"), "Pa")))
+					NCERR(retval);
+				def_netcdf_output_variable(ncid_pressure_level, "geopotential_height", no_of_dims, dimids_pressure_level_scalar, &chunk_shape[3 - no_of_dims], "gpm", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid_pressure_level, "temperature", no_of_dims, dimids_pressure_level_scalar, &chunk_shape[3 - no_of_dims], "K", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid_pressure_level, "relative_humidity", no_of_dims, dimids_pressure_level_scalar, &chunk_shape[3 - no_of_dims], "%", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid_pressure_level, "ertels_potential_vorticity", no_of_dims, dimids_pressure_level_scalar, &chunk_shape[3 - no_of_dims], "Km^2/(kgs)", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid_pressure_level, "wind_u", no_of_dims, dimids_pressure_level_scalar, &chunk_shape[3 - no_of_dims], "m/s", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid_pressure_level, "wind_v", no_of_dims, dimids_pressure_level_scalar, &chunk_shape[3 - no_of_dims], "m/s", config_io -> output_variables, config_io);
+				def_netcdf_output_variable(ncid_pressure_level, "relative_vorticity", no_of_dims, dimids_pressure_level_scalar, &chunk_shape[3 - no_of_dims], "1/s", config_io -> output_variables, config_io);
+				if ((retval = nc_enddef(ncid_pressure_level)))
+					NCERR(retval);
+				// the pressure levels do not depend on time
+				put_netcdf_field(ncid_pressure_level, "pressure_levels", -1, pressure_levels, 0);
+			}
+			
+			// Writing the arrays.
+			put_netcdf_output_variable(ncid_pressure_level, "geopotential_height", record, &geopotential_height[0][0], config_io -> output_variables,
+			config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid_pressure_level, "temperature", record, &t_on_pressure_levels[0][0], config_io -> output_variables,
+			config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid_pressure_level, "ertels_potential_vorticity", record, &epv_on_pressure_levels[0][0], config_io -> output_variables,
+			config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid_pressure_level, "relative_humidity", record, &rh_on_pressure_levels[0][0], config_io -> output_variables,
+			config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid_pressure_level, "wind_u", record, &u_on_pressure_levels[0][0], config_io -> output_variables,
+			config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid_pressure_level, "wind_v", record, &v_on_pressure_levels[0][0], config_io -> output_variables,
+			config_io -> output_keepbits);
+			put_netcdf_output_variable(ncid_pressure_level, "relative_vorticity", record, &rel_vort_on_pressure_levels[0][0], config_io -> output_variables,
+			config_io -> output_keepbits);
+			
+			// closing the netcdf file or appending the time of the record
+			finish_netcdf_output(ncid_pressure_level, time_series, record, t_write - t_init);
+		}
+		
+		// Grib output.
+		if (config_io -> grib_output_switch == 1)
 		{
 			int OUTPUT_FILE_PRESSURE_LEVEL_LENGTH = 300;
 			char *OUTPUT_FILE_PRESSURE_LEVEL_PRE = malloc((OUTPUT_FILE_PRESSURE_LEVEL_LENGTH + 1)*sizeof(char));
-			sprintf(OUTPUT_FILE_PRESSURE_LEVEL_PRE, "%s+%ds_pressure_levels.nc", config_io -> run_id, (int) (t_write - t_init));
-			OUTPUT_FILE_PRESSURE_LEVEL_LENGTH = strlen(OUTPUT_FILE_PRESSURE_LEVEL_PRE);
-			free(OUTPUT_FILE_PRESSURE_LEVEL_PRE);
-			char *OUTPUT_FILE_PRESSURE_LEVEL = malloc((OUTPUT_FILE_PRESSURE_LEVEL_LENGTH + 1)*sizeof(char));
-			sprintf(OUTPUT_FILE_PRESSURE_LEVEL, "%s+%ds_pressure_levels.nc", config_io -> run_id, (int) (t_write - t_init));
-			int ncid_pressure_level, scalar_h_dimid, level_dimid, geopot_height_id, temp_pressure_level_id, rh_pressure_level_id, wind_u_pressure_level_id, wind_v_pressure_level_id, pressure_levels_id, epv_pressure_level_id, rel_vort_pressure_level_id;
-			if ((retval = nc_create(OUTPUT_FILE_PRESSURE_LEVEL, NC_CLOBBER, &ncid_pressure_level)))
-				NCERR(retval);
-			free(OUTPUT_FILE_PRESSURE_LEVEL);
-			if ((retval = nc_def_dim(ncid_pressure_level, "scalar_index_h", NO_OF_SCALARS_H, &scalar_h_dimid)))
-				NCERR(retval);
-			if ((retval = nc_def_dim(ncid_pressure_level, "level_index", NO_OF_PRESSURE_LEVELS, &level_dimid)))
-				NCERR(retval);
-			int dimids_pressure_level_scalar[2];
-			dimids_pressure_level_scalar[0] = scalar_h_dimid;
-			dimids_pressure_level_scalar[1] = level_dimid;
-			// Defining the variables.
-			if ((retval = nc_def_var(ncid_pressure_level, "pressure_levels", NC_DOUBLE, 1, &level_dimid, &pressure_levels_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid_pressure_level, pressure_levels_id, "units", strlen("Pa"), "Pa")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid_pressure_level, "geopotential_height", NC_DOUBLE, 2, dimids_pressure_level_scalar, &geopot_height_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid_pressure_level, geopot_height_id, "units", strlen("gpm"), "gpm")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid_pressure_level, "temperature", NC_DOUBLE, 2, dimids_pressure_level_scalar, &temp_pressure_level_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid_pressure_level, temp_pressure_level_id, "units", strlen("K"), "K")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid_pressure_level, "relative_humidity", NC_DOUBLE, 2, dimids_pressure_level_scalar, &rh_pressure_level_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid_pressure_level, rh_pressure_level_id, "units", strlen("%"), "%")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid_pressure_level, "ertels_potential_vorticity", NC_DOUBLE, 2, dimids_pressure_level_scalar, &epv_pressure_level_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid_pressure_level, epv_pressure_level_id, "units", strlen("Km^2/(kgs)"), "Km^2/(kgs)")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid_pressure_level, "wind_u", NC_DOUBLE, 2, dimids_pressure_level_scalar, &wind_u_pressure_level_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid_pressure_level, wind_u_pressure_level_id, "units", strlen("m/s"), "m/s")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid_pressure_level, "wind_v", NC_DOUBLE, 2, dimids_pressure_level_scalar, &wind_v_pressure_level_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid_pressure_level, wind_v_pressure_level_id, "units", strlen("m/s"), "m/s")))
-				NCERR(retval);
-			if ((retval = nc_def_var(ncid_pressure_level, "relative_vorticity", NC_DOUBLE, 2, dimids_pressure_level_scalar, &rel_vort_pressure_level_id)))
-				NCERR(retval);
-			if ((retval = nc_put_att_text(ncid_pressure_level, rel_vort_pressure_level_id, "units", strlen("1/s"), "1/s")))
-				NCERR(retval);
-			if ((retval = nc_enddef(ncid_pressure_level)))
-				NCERR(retval);
-			
-			// Writing the arrays.
-			if ((retval = nc_put_var_double(ncid_pressure_level, pressure_levels_id, &pressure_levels[0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid_pressure_level, geopot_height_id, &geopotential_height[0][0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid_pressure_level, temp_pressure_level_id, &t_on_pressure_levels[0][0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid_pressure_level, epv_pressure_level_id, &epv_on_pressure_levels[0][0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid_pressure_level, rh_pressure_level_id, &rh_on_pressure_levels[0][0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid_pressure_level, wind_u_pressure_level_id, &u_on_pressure_levels[0][0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid_pressure_level, wind_v_pressure_level_id, &v_on_pressure_levels[0][0])))
-				NCERR(retval);
-			if ((retval = nc_put_var_double(ncid_pressure_level, rel_vort_pressure_level_id, &rel_vort_on_pressure_levels[0][0])))
-				NCERR(retval);
-			
-			// Closing the netcdf file.
-			if ((retval = nc_close(ncid_pressure_level)))
-				NCERR(retval);
-		}
-		
-		// Grib output.
-		if (config_io -> grib_output_switch == 1)
-		{
-			char *SAMPLE_FILENAME = "../../src/io/grib_template.grb2";
-			FILE *SAMPLE_FILE;
-			int OUTPUT_FILE_PRESSURE_LEVEL_LENGTH = 300;
-			char *OUTPUT_FILE_PRESSURE_LEVEL_PRE = malloc((OUTPUT_FILE_PRESSURE_LEVEL_LENGTH + 1)*sizeof(char));
-			sprintf(OUTPUT_FILE_PRESSURE_LEVEL_PRE, "%s+%ds_pressure_levels.grb2", config_io -> run_id, (int) (t_write - t_init));
+			sprintf(OUTPUT_FILE_PRESSURE_LEVEL_PRE, "%s+%ds_pressure_levels.grb2", config_io -> run_id, (int) (t_write - t_init));
 			OUTPUT_FILE_PRESSURE_LEVEL_LENGTH = strlen(OUTPUT_FILE_PRESSURE_LEVEL_PRE);
 			free(OUTPUT_FILE_PRESSURE_LEVEL_PRE);
 			char *OUTPUT_FILE_PRESSURE_LEVEL = malloc((OUTPUT_FILE_PRESSURE_LEVEL_LENGTH + 1)*sizeof(char));
 			sprintf(OUTPUT_FILE_PRESSURE_LEVEL, "%s+%ds_pressure_levels.grb2", config_io -> run_id, (int) (t_write - t_init));
-			FILE *OUT_GRIB;
-			OUT_GRIB = fopen(OUTPUT_FILE_PRESSURE_LEVEL, "w+");
-			double *geopotential_height_pressure_level = malloc(NO_OF_SCALARS_H*sizeof(double));
-			double *temperature_pressure_level = malloc(NO_OF_SCALARS_H*sizeof(double));
-			double *rh_pressure_level = malloc(NO_OF_SCALARS_H*sizeof(double));
-			double *epv_pressure_level = malloc(NO_OF_SCALARS_H*sizeof(double));
-			double *wind_u_pressure_level = malloc(NO_OF_SCALARS_H*sizeof(double));
-			double *wind_v_pressure_level = malloc(NO_OF_SCALARS_H*sizeof(double));
-			double *rel_vort_pressure_level = malloc(NO_OF_SCALARS_H*sizeof(double));
-			
-			codes_handle *handle_geopotential_height_pressure_level = NULL;
-			codes_handle *handle_temperature_pressure_level = NULL;
-			codes_handle *handle_rh_pressure_level = NULL;
-			codes_handle *handle_epv_pressure_level = NULL;
-			codes_handle *handle_wind_u_pressure_level = NULL;
-			codes_handle *handle_wind_v_pressure_level = NULL;
-			codes_handle *handle_rel_vort_pressure_level = NULL;
-			
-			for (int i = 0; i < NO_OF_PRESSURE_LEVELS; ++i)
+			FILE *OUT_GRIB = open_grib_file(OUTPUT_FILE_PRESSURE_LEVEL);
+			// the properties all fields of this file share, points below the surface are marked as missing
+			codes_handle *base_handle = new_grib_base_handle(data_date, data_time, t_write, t_init, &grid -> latlon_grid, config_io);
+		    if ((retval = codes_set_double(base_handle, "missingValue", 9999)))
+		        ECCERR(retval);
+		    if ((retval = codes_set_long(base_handle, "bitmapPresent", 1)))
+		        ECCERR(retval);
+			// the fields are rearranged level by level, so that every GRIB message refers to a contiguous horizontal field
+			int no_of_pressure_level_messages = 7*no_of_pressure_levels;
+			double *pressure_level_fields = malloc(no_of_pressure_level_messages*NO_OF_SCALARS_H*sizeof(double));
+			Grib_message *grib_messages = malloc(no_of_pressure_level_messages*sizeof(Grib_message));
+			double *level_fields;
+			#pragma omp parallel for private(level_fields)
+			for (int i = 0; i < no_of_pressure_levels; ++i)
 			{
-				#pragma omp parallel for
-				for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-				{
-					geopotential_height_pressure_level[j] = geopotential_height[j][i];
-				}
-				#pragma omp parallel for
-				for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-				{
-					temperature_pressure_level[j] = t_on_pressure_levels[j][i];
-				}
-				#pragma omp parallel for
-				for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-				{
-					rh_pressure_level[j] = rh_on_pressure_levels[j][i];
-				}
-				#pragma omp parallel for
-				for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-				{
-					epv_pressure_level[j] = epv_on_pressure_levels[j][i];
-				}
-				#pragma omp parallel for
+				level_fields = &pressure_level_fields[7*i*NO_OF_SCALARS_H];
 				for (int j = 0; j < NO_OF_SCALARS_H; ++j)
 				{
-					wind_u_pressure_level[j] = u_on_pressure_levels[j][i];
-				}
-				#pragma omp parallel for
-				for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-				{
-					wind_v_pressure_level[j] = v_on_pressure_levels[j][i];
-				}
-				#pragma omp parallel for
-				for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-				{
-					rel_vort_pressure_level[j] = rel_vort_on_pressure_levels[j][i];
-				}
-				
-				SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-				handle_geopotential_height_pressure_level = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-				if (err != 0)
-					ECCERR(err);
-				fclose(SAMPLE_FILE);
-				set_basic_props2grib(handle_geopotential_height_pressure_level, data_date, data_time, t_write, t_init, 3, 5);
-			    if ((retval = codes_set_double(handle_geopotential_height_pressure_level, "missingValue", 9999)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_geopotential_height_pressure_level, "bitmapPresent", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_geopotential_height_pressure_level, "typeOfFirstFixedSurface", 100)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_geopotential_height_pressure_level, "scaledValueOfFirstFixedSurface", (int) pressure_levels[i])))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_geopotential_height_pressure_level, "scaleFactorOfFirstFixedSurface", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_geopotential_height_pressure_level, "level", 0.01*pressure_levels[i])))
-			        ECCERR(retval);
-		    	interpolate_to_ll(geopotential_height_pressure_level, grib_output_field, grid);
-			    if ((retval = codes_set_double_array(handle_geopotential_height_pressure_level, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			        ECCERR(retval);
-				if (i == 0)
-				{
-					if ((retval = codes_write_message(handle_geopotential_height_pressure_level, OUTPUT_FILE_PRESSURE_LEVEL, "w")))
-					    ECCERR(retval);
-				}
-				else
-				{
-					if ((retval = codes_write_message(handle_geopotential_height_pressure_level, OUTPUT_FILE_PRESSURE_LEVEL, "a")))
-					    ECCERR(retval);
+					level_fields[j] = geopotential_height[j][i];
+					level_fields[NO_OF_SCALARS_H + j] = t_on_pressure_levels[j][i];
+					level_fields[2*NO_OF_SCALARS_H + j] = rh_on_pressure_levels[j][i];
+					level_fields[3*NO_OF_SCALARS_H + j] = rel_vort_on_pressure_levels[j][i];
+					level_fields[4*NO_OF_SCALARS_H + j] = epv_on_pressure_levels[j][i];
+					level_fields[5*NO_OF_SCALARS_H + j] = u_on_pressure_levels[j][i];
+					level_fields[6*NO_OF_SCALARS_H + j] = v_on_pressure_levels[j][i];
 				}
-				codes_handle_delete(handle_geopotential_height_pressure_level);
-
-				SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-				handle_temperature_pressure_level = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-				if (err != 0)
-					ECCERR(err);
-				fclose(SAMPLE_FILE);
-				set_basic_props2grib(handle_temperature_pressure_level, data_date, data_time, t_write, t_init, 0, 0);
-			    if ((retval = codes_set_double(handle_temperature_pressure_level, "missingValue", 9999)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_temperature_pressure_level, "bitmapPresent", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_temperature_pressure_level, "typeOfFirstFixedSurface", 100)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_temperature_pressure_level, "scaledValueOfFirstFixedSurface", (int) pressure_levels[i])))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_temperature_pressure_level, "scaleFactorOfFirstFixedSurface", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_temperature_pressure_level, "level", 0.01*pressure_levels[i])))
-			        ECCERR(retval);
-		    	interpolate_to_ll(temperature_pressure_level, grib_output_field, grid);
-			    if ((retval = codes_set_double_array(handle_temperature_pressure_level, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			        ECCERR(retval);
-			    if ((retval = codes_write_message(handle_temperature_pressure_level, OUTPUT_FILE_PRESSURE_LEVEL, "a")))
-			        ECCERR(retval);
-				codes_handle_delete(handle_temperature_pressure_level);
-				
-				SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-				handle_rh_pressure_level = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-				if (err != 0)
-					ECCERR(err);
-				fclose(SAMPLE_FILE);
-				set_basic_props2grib(handle_rh_pressure_level, data_date, data_time, t_write, t_init, 1, 1);
-			    if ((retval = codes_set_double(handle_rh_pressure_level, "missingValue", 9999)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rh_pressure_level, "bitmapPresent", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rh_pressure_level, "typeOfFirstFixedSurface", 100)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rh_pressure_level, "scaledValueOfFirstFixedSurface", (int) pressure_levels[i])))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rh_pressure_level, "scaleFactorOfFirstFixedSurface", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rh_pressure_level, "level", 0.01*pressure_levels[i])))
-			        ECCERR(retval);
-		    	interpolate_to_ll(rh_pressure_level, grib_output_field, grid);
-			    if ((retval = codes_set_double_array(handle_rh_pressure_level, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			        ECCERR(retval);
-			    if ((retval = codes_write_message(handle_rh_pressure_level, OUTPUT_FILE_PRESSURE_LEVEL, "a")))
-			        ECCERR(retval);
-				codes_handle_delete(handle_rh_pressure_level);
-
-				SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-				handle_rel_vort_pressure_level = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-				if (err != 0)
-					ECCERR(err);
-				fclose(SAMPLE_FILE);
-				set_basic_props2grib(handle_rel_vort_pressure_level, data_date, data_time, t_write, t_init, 2, 12);
-			    if ((retval = codes_set_double(handle_rel_vort_pressure_level, "missingValue", 9999)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rel_vort_pressure_level, "bitmapPresent", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rel_vort_pressure_level, "typeOfFirstFixedSurface", 100)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rel_vort_pressure_level, "scaledValueOfFirstFixedSurface", (int) pressure_levels[i])))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rel_vort_pressure_level, "scaleFactorOfFirstFixedSurface", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_rel_vort_pressure_level, "level", 0.01*pressure_levels[i])))
-			        ECCERR(retval);
-		    	interpolate_to_ll(rel_vort_pressure_level, grib_output_field, grid);
-			    if ((retval = codes_set_double_array(handle_rel_vort_pressure_level, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			        ECCERR(retval);
-			    if ((retval = codes_write_message(handle_rel_vort_pressure_level, OUTPUT_FILE_PRESSURE_LEVEL, "a")))
-			        ECCERR(retval);
-				codes_handle_delete(handle_rel_vort_pressure_level);
-				
-				SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-				handle_epv_pressure_level = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-				if (err != 0)
-					ECCERR(err);
-				fclose(SAMPLE_FILE);
-				set_basic_props2grib(handle_epv_pressure_level, data_date, data_time, t_write, t_init, 2, 14);
-			    if ((retval = codes_set_double(handle_epv_pressure_level, "missingValue", 9999)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_epv_pressure_level, "bitmapPresent", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_epv_pressure_level, "typeOfFirstFixedSurface", 100)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_epv_pressure_level, "scaledValueOfFirstFixedSurface", (int) pressure_levels[i])))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_epv_pressure_level, "scaleFactorOfFirstFixedSurface", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_epv_pressure_level, "level", 0.01*pressure_levels[i])))
-			        ECCERR(retval);
-		    	interpolate_to_ll(epv_pressure_level, grib_output_field, grid);
-			    if ((retval = codes_set_double_array(handle_epv_pressure_level, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			        ECCERR(retval);
-			    if ((retval = codes_write_message(handle_epv_pressure_level, OUTPUT_FILE_PRESSURE_LEVEL, "a")))
-			        ECCERR(retval);
-				codes_handle_delete(handle_epv_pressure_level);
-				
-				SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-				handle_wind_u_pressure_level = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-				if (err != 0)
-					ECCERR(err);
-				fclose(SAMPLE_FILE);
-				set_basic_props2grib(handle_wind_u_pressure_level, data_date, data_time, t_write, t_init, 2, 2);
-			    if ((retval = codes_set_double(handle_wind_u_pressure_level, "missingValue", 9999)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_u_pressure_level, "bitmapPresent", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_u_pressure_level, "typeOfFirstFixedSurface", 100)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_u_pressure_level, "scaledValueOfFirstFixedSurface", (int) pressure_levels[i])))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_u_pressure_level, "scaleFactorOfFirstFixedSurface", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_u_pressure_level, "level", 0.01*pressure_levels[i])))
-			        ECCERR(retval);
-		    	interpolate_to_ll(wind_u_pressure_level, grib_output_field, grid);
-			    if ((retval = codes_set_double_array(handle_wind_u_pressure_level, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			        ECCERR(retval);
-			    if ((retval = codes_write_message(handle_wind_u_pressure_level, OUTPUT_FILE_PRESSURE_LEVEL, "a")))
-			        ECCERR(retval);
-				codes_handle_delete(handle_wind_u_pressure_level);
-				
-				SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-				handle_wind_v_pressure_level = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-				if (err != 0)
-					ECCERR(err);
-				fclose(SAMPLE_FILE);
-				set_basic_props2grib(handle_wind_v_pressure_level, data_date, data_time, t_write, t_init, 2, 3);
-			    if ((retval = codes_set_double(handle_wind_v_pressure_level, "missingValue", 9999)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_v_pressure_level, "bitmapPresent", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_v_pressure_level, "typeOfFirstFixedSurface", 100)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_v_pressure_level, "scaledValueOfFirstFixedSurface", (int) pressure_levels[i])))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_v_pressure_level, "scaleFactorOfFirstFixedSurface", 1)))
-			        ECCERR(retval);
-			    if ((retval = codes_set_long(handle_wind_v_pressure_level, "level", 0.01*pressure_levels[i])))
-			        ECCERR(retval);
-		    	interpolate_to_ll(wind_v_pressure_level, grib_output_field, grid);
-			    if ((retval = codes_set_double_array(handle_wind_v_pressure_level, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			        ECCERR(retval);
-			    if ((retval = codes_write_message(handle_wind_v_pressure_level, OUTPUT_FILE_PRESSURE_LEVEL, "a")))
-			        ECCERR(retval);
-				codes_handle_delete(handle_wind_v_pressure_level);
 			}
-			
-			free(geopotential_height_pressure_level);
-			free(temperature_pressure_level);
-			free(epv_pressure_level);
-			free(rh_pressure_level);
-			free(wind_u_pressure_level);
-			free(wind_v_pressure_level);
-			free(rel_vort_pressure_level);
-			free(OUTPUT_FILE_PRESSURE_LEVEL);
+			for (int i = 0; i < no_of_pressure_levels; ++i)
+			{
+				level_fields = &pressure_level_fields[7*i*NO_OF_SCALARS_H];
+				set_grib_message(&grib_messages[7*i], "geopotential_height", &level_fields[0], 3, 5, 100, (int) pressure_levels[i], 0.01*pressure_levels[i], NULL);
+				set_grib_message(&grib_messages[7*i + 1], "temperature", &level_fields[NO_OF_SCALARS_H], 0, 0, 100, (int) pressure_levels[i], 0.01*pressure_levels[i], NULL);
+				set_grib_message(&grib_messages[7*i + 2], "relative_humidity", &level_fields[2*NO_OF_SCALARS_H], 1, 1, 100, (int) pressure_levels[i], 0.01*pressure_levels[i], NULL);
+				set_grib_message(&grib_messages[7*i + 3], "relative_vorticity", &level_fields[3*NO_OF_SCALARS_H], 2, 12, 100, (int) pressure_levels[i], 0.01*pressure_levels[i], NULL);
+				set_grib_message(&grib_messages[7*i + 4], "ertels_potential_vorticity", &level_fields[4*NO_OF_SCALARS_H], 2, 14, 100, (int) pressure_levels[i], 0.01*pressure_levels[i], NULL);
+				set_grib_message(&grib_messages[7*i + 5], "wind_u", &level_fields[5*NO_OF_SCALARS_H], 2, 2, 100, (int) pressure_levels[i], 0.01*pressure_levels[i], NULL);
+				set_grib_message(&grib_messages[7*i + 6], "wind_v", &level_fields[6*NO_OF_SCALARS_H], 2, 3, 100, (int) pressure_levels[i], 0.01*pressure_levels[i], NULL);
+			}
+			no_of_pressure_level_messages = select_grib_messages(grib_messages, no_of_pressure_level_messages, config_io -> output_variables);
+			encode_grib_messages(base_handle, OUT_GRIB, grib_messages, no_of_pressure_level_messages, grid, config_io);
+			codes_handle_delete(base_handle);
+			free(grib_messages);
+			free(pressure_level_fields);
 			
 			fclose(OUT_GRIB);
+			report_compression_ratio(OUTPUT_FILE_PRESSURE_LEVEL,
+			(double) no_of_pressure_level_messages*grid -> latlon_grid.no_of_lat_points*grid -> latlon_grid.no_of_lon_points*sizeof(double));
+			free(OUTPUT_FILE_PRESSURE_LEVEL);
 		}
     	free(geopotential_height);
     	free(t_on_pressure_levels);
@@ -1174,259 +940,121 @@ int write_out(State *state_write_out, double wind_h_lowest_layer_array[], int mi
     	free(u_on_pressure_levels);
     	free(v_on_pressure_levels);
     	free(epv_on_pressure_levels);
-    	free(pressure_levels);
+    	free(rel_vort_on_pressure_levels);
     }
 
 	// Grib output.
 	if (config_io -> model_level_output_switch == 1 && config_io -> grib_output_switch == 1)
 	{
-		// Grib requires everything to be on horizontal levels.
-		double *temperature_h = malloc(NO_OF_SCALARS_H*sizeof(double));
-		double *pressure_h = malloc(NO_OF_SCALARS_H*sizeof(double));
-		double *rh_h = malloc(NO_OF_SCALARS_H*sizeof(double));
-		double *wind_u_h = malloc(NO_OF_SCALARS_H*sizeof(double));
-		double *wind_v_h = malloc(NO_OF_SCALARS_H*sizeof(double));
-		double *rel_vort_h = malloc(NO_OF_SCALARS_H*sizeof(double));
-		double *divv_h = malloc(NO_OF_SCALARS_H*sizeof(double));
-		double *wind_w_h = malloc(NO_OF_SCALARS_H*sizeof(double));
-		char OUTPUT_FILE_PRE[300];
-		sprintf(OUTPUT_FILE_PRE, "%s+%ds.grb2", config_io -> run_id, (int) (t_write - t_init));
-		char OUTPUT_FILE[strlen(OUTPUT_FILE_PRE) + 1];
-		sprintf(OUTPUT_FILE, "%s+%ds.grb2", config_io -> run_id, (int) (t_write - t_init));
-		char *SAMPLE_FILENAME = "../../src/io/grib_template.grb2";
-		FILE *SAMPLE_FILE;
-		if (t_init < 0)
-			exit(1);
-		FILE *OUT_GRIB;
-		OUT_GRIB = fopen(OUTPUT_FILE, "w+");
-		codes_handle *handle_temperature_h = NULL;
-		codes_handle *handle_pressure_h = NULL;
-		codes_handle *handle_wind_u_h = NULL;
-		codes_handle *handle_wind_v_h = NULL;
-		codes_handle *handle_wind_w_h = NULL;
-		codes_handle *handle_rel_vort = NULL;
-		codes_handle *handle_rh = NULL;
-		codes_handle *handle_divv_h = NULL;
+		// Grib requires everything to be on horizontal levels, the layers of the scalar fields and the levels of the vertical wind are contiguous.
+		int no_of_model_level_messages = 7*NO_OF_LAYERS + NO_OF_LEVELS;
+		Grib_message *grib_messages = malloc(no_of_model_level_messages*sizeof(Grib_message));
 		for (int i = 0; i < NO_OF_LAYERS; ++i)
 		{
-			#pragma omp parallel for
-			for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-			{
-				temperature_h[j] = diagnostics -> temperature[i*NO_OF_SCALARS_H + j];
-				pressure_h[j] = (*pressure)[i*NO_OF_SCALARS_H + j];
-				rh_h[j] = (*rh)[i*NO_OF_SCALARS_H + j];
-			}
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_temperature_h = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_temperature_h, data_date, data_time, t_write, t_init, 0, 0);
-			if ((retval = codes_set_long(handle_temperature_h, "typeOfFirstFixedSurface", 26)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_temperature_h, "scaledValueOfFirstFixedSurface", i)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_temperature_h, "scaleFactorOfFirstFixedSurface", 1)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_temperature_h, "level", i)))
-			    ECCERR(retval);
-	    	interpolate_to_ll(temperature_h, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_temperature_h, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			    ECCERR(retval);
-			if (i == 0)
-			{
-			    if ((retval = codes_write_message(handle_temperature_h, OUTPUT_FILE, "w")))
-			        ECCERR(retval);
-			}
-			else
-			{
-			    if ((retval = codes_write_message(handle_temperature_h, OUTPUT_FILE, "a")))
-			        ECCERR(retval);
-			}
-			codes_handle_delete(handle_temperature_h);
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_pressure_h = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_pressure_h, data_date, data_time, t_write, t_init, 0, 0);
-			if ((retval = codes_set_long(handle_pressure_h, "typeOfFirstFixedSurface", 26)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_pressure_h, "scaledValueOfFirstFixedSurface", i)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_pressure_h, "scaleFactorOfFirstFixedSurface", 1)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_pressure_h, "level", i)))
-			    ECCERR(retval);
-	    	interpolate_to_ll(pressure_h, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_pressure_h, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			    ECCERR(retval);
-			if ((retval = codes_write_message(handle_pressure_h, OUTPUT_FILE, "a")))
-			    ECCERR(retval);
-			codes_handle_delete(handle_pressure_h);
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_rh = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_rh, data_date, data_time, t_write, t_init, 0, 1);
-			if ((retval = codes_set_long(handle_rh, "typeOfFirstFixedSurface", 26)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_rh, "scaledValueOfFirstFixedSurface", i)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_rh, "scaleFactorOfFirstFixedSurface", 1)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_rh, "level", i)))
-			    ECCERR(retval);
-	    	interpolate_to_ll(rh_h, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_rh, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			    ECCERR(retval);
-			if ((retval = codes_write_message(handle_rh, OUTPUT_FILE, "a")))
-			    ECCERR(retval);
-			codes_handle_delete(handle_rh);
-			for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-			{
-			    wind_u_h[j] = diagnostics -> u_at_cell[i*NO_OF_SCALARS_H + j];
-			    wind_v_h[j] = diagnostics -> v_at_cell[i*NO_OF_SCALARS_H + j];
-			    rel_vort_h[j] = (*rel_vort)[i*NO_OF_SCALARS_H + j];
-			}
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_wind_u_h = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_wind_u_h, data_date, data_time, t_write, t_init, 2, 2);
-			if ((retval = codes_set_long(handle_wind_u_h, "typeOfFirstFixedSurface", 26)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_u_h, "scaledValueOfFirstFixedSurface", i)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_u_h, "scaleFactorOfFirstFixedSurface", 1)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_u_h, "level", i)))
-			    ECCERR(retval);
-	    	interpolate_to_ll(wind_u_h, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_wind_u_h, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			    ECCERR(retval);
-			if ((retval = codes_write_message(handle_wind_u_h, OUTPUT_FILE, "a")))
-			    ECCERR(retval);
-			codes_handle_delete(handle_wind_u_h);
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_wind_v_h = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_wind_v_h, data_date, data_time, t_write, t_init, 2, 3);
-			if ((retval = codes_set_long(handle_wind_v_h, "typeOfFirstFixedSurface", 26)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_v_h, "scaledValueOfFirstFixedSurface", i)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_v_h, "scaleFactorOfFirstFixedSurface", 1)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_v_h, "level", i)))
-			    ECCERR(retval);
-	    	interpolate_to_ll(wind_v_h, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_wind_v_h, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			    ECCERR(retval);
-			if ((retval = codes_write_message(handle_wind_v_h, OUTPUT_FILE, "a")))
-			    ECCERR(retval);
-			codes_handle_delete(handle_wind_v_h);
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_rel_vort = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_rel_vort, data_date, data_time, t_write, t_init, 2, 12);
-			if ((retval = codes_set_long(handle_rel_vort, "typeOfFirstFixedSurface", 26)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_rel_vort, "scaledValueOfFirstFixedSurface", i)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_rel_vort, "scaleFactorOfFirstFixedSurface", 1)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_rel_vort, "level", i)))
-			    ECCERR(retval);
-	    	interpolate_to_ll(rel_vort_h, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_rel_vort, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			    ECCERR(retval);
-			if ((retval = codes_write_message(handle_rel_vort, OUTPUT_FILE, "a")))
-			    ECCERR(retval);
-			codes_handle_delete(handle_rel_vort);
-			for (int j = 0; j < NO_OF_SCALARS_H; ++j)
-			{
-				divv_h[j] = (*divv_h_all_layers)[i*NO_OF_SCALARS_H + j];
-			}
-			SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-			handle_divv_h = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-			if (err != 0)
-				ECCERR(err);
-			fclose(SAMPLE_FILE);
-			set_basic_props2grib(handle_divv_h, data_date, data_time, t_write, t_init, 2, 13);
-			if ((retval = codes_set_long(handle_divv_h, "typeOfFirstFixedSurface", 26)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_divv_h, "scaledValueOfFirstFixedSurface", i)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_divv_h, "scaleFactorOfFirstFixedSurface", 1)))
-				ECCERR(retval);
-			if ((retval = codes_set_long(handle_divv_h, "level", i)))
-				ECCERR(retval);
-    		interpolate_to_ll(divv_h, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_divv_h, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-				ECCERR(retval);
-			if ((retval = codes_write_message(handle_divv_h, OUTPUT_FILE, "a")))
-				ECCERR(retval);
-			codes_handle_delete(handle_divv_h);
+			set_grib_message(&grib_messages[7*i], "temperature", &diagnostics -> temperature[i*NO_OF_SCALARS_H], 0, 0, 26, i, i, NULL);
+			set_grib_message(&grib_messages[7*i + 1], "pressure", &(*pressure)[i*NO_OF_SCALARS_H], 0, 0, 26, i, i, NULL);
+			set_grib_message(&grib_messages[7*i + 2], "rh", &(*rh)[i*NO_OF_SCALARS_H], 0, 1, 26, i, i, NULL);
+			set_grib_message(&grib_messages[7*i + 3], "wind_u", &diagnostics -> u_at_cell[i*NO_OF_SCALARS_H], 2, 2, 26, i, i, NULL);
+			set_grib_message(&grib_messages[7*i + 4], "wind_v", &diagnostics -> v_at_cell[i*NO_OF_SCALARS_H], 2, 3, 26, i, i, NULL);
+			set_grib_message(&grib_messages[7*i + 5], "rel_vort", &(*rel_vort)[i*NO_OF_SCALARS_H], 2, 12, 26, i, i, NULL);
+			set_grib_message(&grib_messages[7*i + 6], "divv_h_all_layers", &(*divv_h_all_layers)[i*NO_OF_SCALARS_H], 2, 13, 26, i, i, NULL);
 		}
-		free(wind_u_h);
-		free(wind_v_h);
-		free(rel_vort_h);
-		free(divv_h);
-		free(temperature_h);
-		free(pressure_h);
-		free(rh_h);
-		SAMPLE_FILE = fopen(SAMPLE_FILENAME, "r");
-		handle_wind_w_h = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
-		if (err != 0)
-			ECCERR(err);
-		fclose(SAMPLE_FILE);
 		for (int i = 0; i < NO_OF_LEVELS; ++i)
 		{
-			for (int j = 0; j < NO_OF_SCALARS_H; j++)
-			{
-			    wind_w_h[j] = state_write_out -> wind[j + i*NO_OF_VECTORS_PER_LAYER];
-			}
-			set_basic_props2grib(handle_wind_w_h, data_date, data_time, t_write, t_init, 2, 9);
-			if ((retval = codes_set_long(handle_wind_w_h, "typeOfFirstFixedSurface", 26)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_w_h, "scaleFactorOfFirstFixedSurface", 1)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_w_h, "scaledValueOfFirstFixedSurface", i)))
-			    ECCERR(retval);
-			if ((retval = codes_set_long(handle_wind_w_h, "level", i)))
-			    ECCERR(retval);
-	    	interpolate_to_ll(wind_w_h, grib_output_field, grid);
-			if ((retval = codes_set_double_array(handle_wind_w_h, "values", grib_output_field, NO_OF_LATLON_IO_POINTS)))
-			    ECCERR(retval);
-			if ((retval = codes_write_message(handle_wind_w_h, OUTPUT_FILE, "a")))
-			    ECCERR(retval);
+			set_grib_message(&grib_messages[7*NO_OF_LAYERS + i], "wind_w", &state_write_out -> wind[i*NO_OF_VECTORS_PER_LAYER], 2, 9, 26, i, i, NULL);
+		}
+		no_of_model_level_messages = select_grib_messages(grib_messages, no_of_model_level_messages, config_io -> output_variables);
+		// the output list might only contain model level variables of the netcdf output
+		if (no_of_model_level_messages > 0)
+		{
+			char OUTPUT_FILE_PRE[300];
+			sprintf(OUTPUT_FILE_PRE, "%s+%ds.grb2", config_io -> run_id, (int) (t_write - t_init));
+			char OUTPUT_FILE[strlen(OUTPUT_FILE_PRE) + 1];
+			sprintf(OUTPUT_FILE, "%s+%ds.grb2", config_io -> run_id, (int) (t_write - t_init));
+			FILE *OUT_GRIB = open_grib_file(OUTPUT_FILE);
+			// the properties all fields of this file share
+			codes_handle *base_handle = new_grib_base_handle(data_date, data_time, t_write, t_init, &grid -> latlon_grid, config_io);
+			encode_grib_messages(base_handle, OUT_GRIB, grib_messages, no_of_model_level_messages, grid, config_io);
+			codes_handle_delete(base_handle);
+			fclose(OUT_GRIB);
+			report_compression_ratio(OUTPUT_FILE, (double) no_of_model_level_messages*grid -> latlon_grid.no_of_lat_points*grid -> latlon_grid.no_of_lon_points*sizeof(double));
 		}
-		codes_handle_delete(handle_wind_w_h);
-		free(wind_w_h);
-		fclose(OUT_GRIB);
+		free(grib_messages);
 	}
 	
 	// Netcdf output.
-	if ((config_io -> model_level_output_switch == 1 && config_io -> netcdf_output_switch == 1)
-	|| (config_io -> ideal_input_id == -1 && (int) (t_write - t_init) == config -> time_to_next_analysis))
+	if (config_io -> model_level_output_switch == 1 && config_io -> netcdf_output_switch == 1)
+	{
+		char OUTPUT_FILE[300];
+		Netcdf_time_series *time_series = NULL;
+		char *output_variables = config_io -> output_variables;
+		char *output_keepbits = config_io -> output_keepbits;
+		if (config_io -> netcdf_time_series_switch == 1)
+		{
+			sprintf(OUTPUT_FILE, "%s.nc", config_io -> run_id);
+			time_series = &model_level_time_series[config_io -> output_stream_index];
+		}
+		else
+		{
+			sprintf(OUTPUT_FILE, "%s+%ds.nc", config_io -> run_id, (int) (t_write - t_init));
+			// this file is the background state of the data assimilation
+			if (da_background_bool == 1)
+			{
+				output_variables = "all";
+				output_keepbits = "off";
+			}
+		}
+		if (output_product_requested(output_variables, MODEL_LEVEL_PRODUCT) == 1)
+		{
+			write_model_level_netcdf(OUTPUT_FILE, time_series, t_write - t_init, state_write_out, diagnostics, *rh, *rel_vort, *divv_h_all_layers, irrev,
+			output_variables, output_keepbits, config_io);
+		}
+	}
+	// the background state of the data assimilation is always a file of its own
+	if (da_background_bool == 1
+	&& (config_io -> model_level_output_switch == 0 || config_io -> netcdf_output_switch == 0 || config_io -> netcdf_time_series_switch == 1))
 	{
-		char OUTPUT_FILE_PRE[300];
-		sprintf(OUTPUT_FILE_PRE, "%s+%ds.nc", config_io -> run_id, (int) (t_write - t_init));
-		char OUTPUT_FILE[strlen(OUTPUT_FILE_PRE) + 1];
+		char OUTPUT_FILE[300];
 		sprintf(OUTPUT_FILE, "%s+%ds.nc", config_io -> run_id, (int) (t_write - t_init));
-		int ncid, retval, scalar_dimid, soil_dimid, vector_h_dimid, vector_v_dimid, vector_dimid, densities_dimid,
-		curl_field_dimid, single_double_dimid, densities_id, temperature_id, wind_id, rh_id, divv_h_all_layers_id, rel_vort_id,
-		tke_id, soil_id;
-		
-		if ((retval = nc_create(OUTPUT_FILE, NC_CLOBBER, &ncid)))
-			NCERR(retval);
+		write_model_level_netcdf(OUTPUT_FILE, NULL, t_write - t_init, state_write_out, diagnostics, *rh, *rel_vort, *divv_h_all_layers, irrev, "all", "off",
+		config_io);
+	}
+	
+	// output on the native grid
+	if (config_io -> ugrid_output_switch == 1)
+	{
+		write_ugrid_output(t_write - t_init, state_write_out, diagnostics, *pressure, *rh, *rel_vort, *divv_h_all_layers, irrev, config_io);
+	}
+	
+	// publishing the output to the shared memory segment
+	if (config_io -> shm_output_switch == 1)
+	{
+		write_shm_output(t_write - t_init, state_write_out, diagnostics, *pressure, *rh, *rel_vort, *divv_h_all_layers, irrev);
+	}
+	free(divv_h_all_layers);
+	free(rel_vort);
+	free(rh);
+	free(epv);
+	free(pressure);
+	printf("Output written.\n");
+	return 0;
+}
+
+int write_model_level_netcdf(char file_name[], Netcdf_time_series *time_series, double time_since_init, State *state, Diagnostics *diagnostics,
+Scalar_field rh, Scalar_field rel_vort, Scalar_field divv_h_all_layers, Irreversible_quantities *irrev, char output_variables[], char output_keepbits[],
+Config_io *config_io)
+{
+	/*
+	This function writes the model level output to a netcdf file, which is also the input of the data assimilation.
+	If time_series is not NULL, the fields are appended to the file of the time series output.
+	Only the variables in the output list output_variables are written, they are rounded according to output_keepbits.
+	*/
+	int ncid, record, time_dimid, retval, scalar_dimid, soil_dimid, vector_h_dimid, vector_v_dimid, vector_dimid, densities_dimid,
+	curl_field_dimid, single_double_dimid;
+	
+	// the variables are only defined when the file is created
+	if (open_netcdf_output(file_name, time_series, config_io, &ncid, &record, &time_dimid) == 1)
+	{
 		if ((retval = nc_def_dim(ncid, "scalar_index", NO_OF_SCALARS, &scalar_dimid)))
 			NCERR(retval);
 		if ((retval = nc_def_dim(ncid, "soil_index", NO_OF_SOIL_LAYERS*NO_OF_SCALARS_H, &soil_dimid)))
@@ -1443,72 +1071,40 @@ int write_out(State *state_write_out, double wind_h_lowest_layer_array[], int mi
 			NCERR(retval);
 		if ((retval = nc_def_dim(ncid, "single_double_dimid_index", 1, &single_double_dimid)))
 			NCERR(retval);
+		int densities_dimids[2], scalar_dimids[2], vector_dimids[2], soil_dimids[2];
+		int no_of_dims = get_netcdf_dimids(time_dimid, densities_dimid, densities_dimids);
+		get_netcdf_dimids(time_dimid, scalar_dimid, scalar_dimids);
+		get_netcdf_dimids(time_dimid, vector_dimid, vector_dimids);
+		get_netcdf_dimids(time_dimid, soil_dimid, soil_dimids);
+		// one chunk per layer (and output time)
+		size_t scalar_chunk_shape[2] = {1, NO_OF_SCALARS_H};
+		size_t vector_chunk_shape[2] = {1, NO_OF_VECTORS_PER_LAYER};
 		
 		// Defining the variables.
-		if ((retval = nc_def_var(ncid, "densities", NC_DOUBLE, 1, &densities_dimid, &densities_id)))
-			NCERR(retval);
-		if ((retval = nc_put_att_text(ncid, densities_id, "units", strlen("kg/m^3"), "kg/m^3")))
-			NCERR(retval);
-		if ((retval = nc_def_var(ncid, "temperature", NC_DOUBLE, 1, &scalar_dimid, &temperature_id)))
-			NCERR(retval);
-		if ((retval = nc_put_att_text(ncid, temperature_id, "units", strlen("K"), "K")))
-			NCERR(retval);
-		if ((retval = nc_def_var(ncid, "wind", NC_DOUBLE, 1, &vector_dimid, &wind_id)))
-			NCERR(retval);
-		if ((retval = nc_put_att_text(ncid, wind_id, "units", strlen("m/s"), "m/s")))
-			NCERR(retval);
-		if ((retval = nc_def_var(ncid, "rh", NC_DOUBLE, 1, &scalar_dimid, &rh_id)))
-			NCERR(retval);
-		if ((retval = nc_put_att_text(ncid, rh_id, "units", strlen("%"), "%")))
-			NCERR(retval);
-		if ((retval = nc_def_var(ncid, "rel_vort", NC_DOUBLE, 1, &scalar_dimid, &rel_vort_id)))
-			NCERR(retval);
-		if ((retval = nc_put_att_text(ncid, rel_vort_id, "units", strlen("1/s"), "1/s")))
-			NCERR(retval);
-		if ((retval = nc_def_var(ncid, "divv_h_all_layers", NC_DOUBLE, 1, &scalar_dimid, &divv_h_all_layers_id)))
-			NCERR(retval);
-		if ((retval = nc_put_att_text(ncid, divv_h_all_layers_id, "units", strlen("1/s"), "1/s")))
-			NCERR(retval);
-		if ((retval = nc_def_var(ncid, "tke", NC_DOUBLE, 1, &scalar_dimid, &tke_id)))
-			NCERR(retval);
-		if ((retval = nc_put_att_text(ncid, tke_id, "units", strlen("J/kg"), "J/kg")))
-			NCERR(retval);
-		if ((retval = nc_def_var(ncid, "t_soil", NC_DOUBLE, 1, &soil_dimid, &soil_id)))
-			NCERR(retval);
-		if ((retval = nc_put_att_text(ncid, soil_id, "units", strlen("K"), "K")))
-			NCERR(retval);
+		def_netcdf_output_variable(ncid, "densities", no_of_dims, densities_dimids, &scalar_chunk_shape[2 - no_of_dims], "kg/m^3", output_variables, config_io);
+		def_netcdf_output_variable(ncid, "temperature", no_of_dims, scalar_dimids, &scalar_chunk_shape[2 - no_of_dims], "K", output_variables, config_io);
+		def_netcdf_output_variable(ncid, "wind", no_of_dims, vector_dimids, &vector_chunk_shape[2 - no_of_dims], "m/s", output_variables, config_io);
+		def_netcdf_output_variable(ncid, "rh", no_of_dims, scalar_dimids, &scalar_chunk_shape[2 - no_of_dims], "%", output_variables, config_io);
+		def_netcdf_output_variable(ncid, "rel_vort", no_of_dims, scalar_dimids, &scalar_chunk_shape[2 - no_of_dims], "1/s", output_variables, config_io);
+		def_netcdf_output_variable(ncid, "divv_h_all_layers", no_of_dims, scalar_dimids, &scalar_chunk_shape[2 - no_of_dims], "1/s", output_variables, config_io);
+		def_netcdf_output_variable(ncid, "tke", no_of_dims, scalar_dimids, &scalar_chunk_shape[2 - no_of_dims], "J/kg", output_variables, config_io);
+		def_netcdf_output_variable(ncid, "t_soil", no_of_dims, soil_dimids, &scalar_chunk_shape[2 - no_of_dims], "K", output_variables, config_io);
 		if ((retval = nc_enddef(ncid)))
 			NCERR(retval);
-		
-		// setting the variables
-		if ((retval = nc_put_var_double(ncid, densities_id, &state_write_out -> rho[0])))
-			NCERR(retval);
-		if ((retval = nc_put_var_double(ncid, temperature_id, &diagnostics -> temperature[0])))
-			NCERR(retval);
-		if ((retval = nc_put_var_double(ncid, wind_id, &state_write_out -> wind[0])))
-			NCERR(retval);
-		if ((retval = nc_put_var_double(ncid, rh_id, &(*rh)[0])))
-			NCERR(retval);
-		if ((retval = nc_put_var_double(ncid, rel_vort_id, &(*rel_vort)[0])))
-			NCERR(retval);
-		if ((retval = nc_put_var_double(ncid, divv_h_all_layers_id, &(*divv_h_all_layers)[0])))
-			NCERR(retval);
-		if ((retval = nc_put_var_double(ncid, tke_id, &irrev -> tke[0])))
-			NCERR(retval);
-		if ((retval = nc_put_var_double(ncid, soil_id, &state_write_out -> temperature_soil[0])))
-			NCERR(retval);
-		
-		// Closing the netcdf file.
-		if ((retval = nc_close(ncid)))
-			NCERR(retval);
 	}
-	free(grib_output_field);
-	free(divv_h_all_layers);
-	free(rel_vort);
-	free(rh);
-	free(epv);
-	free(pressure);
-	printf("Output written.\n");
+	
+	// setting the variables
+	put_netcdf_output_variable(ncid, "densities", record, state -> rho, output_variables, output_keepbits);
+	put_netcdf_output_variable(ncid, "temperature", record, diagnostics -> temperature, output_variables, output_keepbits);
+	put_netcdf_output_variable(ncid, "wind", record, state -> wind, output_variables, output_keepbits);
+	put_netcdf_output_variable(ncid, "rh", record, rh, output_variables, output_keepbits);
+	put_netcdf_output_variable(ncid, "rel_vort", record, rel_vort, output_variables, output_keepbits);
+	put_netcdf_output_variable(ncid, "divv_h_all_layers", record, divv_h_all_layers, output_variables, output_keepbits);
+	put_netcdf_output_variable(ncid, "tke", record, irrev -> tke, output_variables, output_keepbits);
+	put_netcdf_output_variable(ncid, "t_soil", record, state -> temperature_soil, output_variables, output_keepbits);
+	
+	// closing the netcdf file or appending the time of the record
+	finish_netcdf_output(ncid, time_series, record, time_since_init);
 	return 0;
 }
 
@@ -1595,16 +1191,67 @@ int write_out_integral(State *state_write_out, double time_since_init, Grid *gri
 	return 0;
 }
 
-int set_basic_props2grib(codes_handle *handle, long data_date, long data_time, long t_write, long t_init, long parameter_category, long parameter_number)
+int read_grib_template()
+{
+	/*
+	This function reads the GRIB template into memory. All GRIB messages are cloned from it.
+	*/
+	FILE *SAMPLE_FILE = fopen(GRIB_TEMPLATE_FILE, "r");
+	if (SAMPLE_FILE == NULL)
+	{
+		printf("Could not open the GRIB template %s.\n", GRIB_TEMPLATE_FILE);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	int err = 0;
+	grib_template = codes_handle_new_from_file(NULL, SAMPLE_FILE, PRODUCT_GRIB, &err);
+	if (err != 0)
+		ECCERR(err);
+	fclose(SAMPLE_FILE);
+	return 0;
+}
+
+int free_grib_template()
+{
+	/*
+	This function frees the GRIB template.
+	*/
+	if (grib_template != NULL)
+	{
+		codes_handle_delete(grib_template);
+		grib_template = NULL;
+	}
+	return 0;
+}
+
+FILE *open_grib_file(char file_name[])
+{
+	/*
+	This function opens a GRIB output file, all messages of an output file are written to this stream.
+	*/
+	FILE *grib_file = fopen(file_name, "w");
+	if (grib_file == NULL)
+	{
+		printf("Could not open the output file %s.\n", file_name);
+		printf("Aborting.\n");
+		exit(1);
+	}
+	return grib_file;
+}
+
+codes_handle *new_grib_base_handle(long data_date, long data_time, long t_write, long t_init, Latlon_grid *latlon_grid, Config_io *config_io)
 {
 	/*
-	This function sets the basic properties of a grib message.
+	This function clones the GRIB template and sets the properties all messages of an output time share (time, grid and packing).
 	*/
+	codes_handle *handle = codes_handle_clone(grib_template);
+	if (handle == NULL)
+	{
+		printf("Could not clone the GRIB template.\n");
+		printf("Aborting.\n");
+		exit(1);
+	}
 	int retval;
-    if ((retval = codes_set_long(handle, "parameterCategory", parameter_category)))
-        ECCERR(retval);
-    if ((retval = codes_set_long(handle, "parameterNumber", parameter_number)))
-        ECCERR(retval);
 	if ((retval = codes_set_long(handle, "dataDate", data_date)))
 		ECCERR(retval);
 	if ((retval = codes_set_long(handle, "dataTime", data_time)))
@@ -1619,25 +1266,28 @@ int set_basic_props2grib(codes_handle *handle, long data_date, long data_time, l
 		ECCERR(retval);
 	if ((retval = codes_set_long(handle, "gridDefinitionTemplateNumber", 0)))
 	    ECCERR(retval);
-	if ((retval = codes_set_long(handle, "Ni", NO_OF_LON_IO_POINTS)))
+	if ((retval = codes_set_long(handle, "Ni", latlon_grid -> no_of_lon_points)))
 	    ECCERR(retval);
-	if ((retval = codes_set_long(handle, "Nj", NO_OF_LAT_IO_POINTS)))
+	if ((retval = codes_set_long(handle, "Nj", latlon_grid -> no_of_lat_points)))
 	    ECCERR(retval);
 	if ((retval = codes_set_long(handle, "iScansNegatively", 0)))
 	    ECCERR(retval);
 	if ((retval = codes_set_long(handle, "jScansPositively", 0)))
 	    ECCERR(retval);
-	if ((retval = codes_set_double(handle, "latitudeOfFirstGridPointInDegrees", rad2deg(M_PI/2 - 0.5*M_PI/NO_OF_LAT_IO_POINTS))))
+	// the longitudes are written in the range [0, 360)
+	double lon_last = latlon_grid -> lon_first + (latlon_grid -> no_of_lon_points - 1)*latlon_grid -> delta_lon;
+	if ((retval = codes_set_double(handle, "latitudeOfFirstGridPointInDegrees", rad2deg(latlon_grid -> lat_first))))
 	    ECCERR(retval);
-	if ((retval = codes_set_double(handle, "longitudeOfFirstGridPointInDegrees", 0)))
+	if ((retval = codes_set_double(handle, "longitudeOfFirstGridPointInDegrees", fmod(rad2deg(latlon_grid -> lon_first) + 360, 360))))
 	    ECCERR(retval);
-	if ((retval = codes_set_double(handle, "latitudeOfLastGridPointInDegrees", -rad2deg(M_PI/2 - 0.5*M_PI/NO_OF_LAT_IO_POINTS))))
+	if ((retval = codes_set_double(handle, "latitudeOfLastGridPointInDegrees",
+	rad2deg(latlon_grid -> lat_first - (latlon_grid -> no_of_lat_points - 1)*latlon_grid -> delta_lat))))
 	    ECCERR(retval);
-	if ((retval = codes_set_double(handle, "longitudeOfLastGridPointInDegrees", rad2deg(-2*M_PI/NO_OF_LON_IO_POINTS))))
+	if ((retval = codes_set_double(handle, "longitudeOfLastGridPointInDegrees", fmod(rad2deg(lon_last) + 360, 360))))
 	    ECCERR(retval);
-	if ((retval = codes_set_double(handle, "iDirectionIncrementInDegrees", rad2deg(2*M_PI/NO_OF_LON_IO_POINTS))))
+	if ((retval = codes_set_double(handle, "iDirectionIncrementInDegrees", rad2deg(latlon_grid -> delta_lon))))
 	    ECCERR(retval);
-	if ((retval = codes_set_double(handle, "jDirectionIncrementInDegrees", rad2deg(M_PI/NO_OF_LAT_IO_POINTS))))
+	if ((retval = codes_set_double(handle, "jDirectionIncrementInDegrees", rad2deg(latlon_grid -> delta_lat))))
 	    ECCERR(retval);
     if ((retval = codes_set_long(handle, "discipline", 0)))
         ECCERR(retval);
@@ -1653,6 +1303,763 @@ int set_basic_props2grib(codes_handle *handle, long data_date, long data_time, l
         ECCERR(retval);
     if ((retval = codes_set_long(handle, "stepUnits", 13)))
         ECCERR(retval);
+	if (config_io -> grib_ccsds_switch == 1)
+	{
+		// requires an ecCodes built with libaec
+		size_t packing_type_length = strlen("grid_ccsds") + 1;
+		if ((retval = codes_set_string(handle, "packingType", "grid_ccsds", &packing_type_length)))
+		    ECCERR(retval);
+	}
+	return handle;
+}
+
+
+int set_grib_message(Grib_message *grib_message, char name[], double field[], long parameter_category, long parameter_number, long type_of_first_fixed_surface,
+long scaled_value_of_first_fixed_surface, long level, char short_name[])
+{
+	/*
+	This function sets the description of a GRIB message. short_name is only set in the message if it is not NULL.
+	name is the name of the variable in grib_bits_per_value (the name of the netcdf output where there is one).
+	*/
+	grib_message -> field = field;
+	grib_message -> name = name;
+	grib_message -> parameter_category = parameter_category;
+	grib_message -> parameter_number = parameter_number;
+	grib_message -> type_of_first_fixed_surface = type_of_first_fixed_surface;
+	grib_message -> scaled_value_of_first_fixed_surface = scaled_value_of_first_fixed_surface;
+	grib_message -> level = level;
+	grib_message -> short_name = short_name;
+	return 0;
+}
+
+int encode_grib_messages(codes_handle *base_handle, FILE *grib_file, Grib_message grib_messages[], int no_of_messages, Grid *grid, Config_io *config_io)
+{
+	/*
+	This function interpolates the fields of a GRIB file to the lat-lon grid and encodes them, every message is cloned from base_handle.
+	The fields are interpolated in batches of GRIB_BATCH_SIZE fields, so the interpolation indices and weights are read once per batch.
+	The interpolated fields are rounded according to output_keepbits in parallel before they are packed.
+	The ecCodes calls (including the packing, which happens when the values are set) are serialized, because ecCodes is only thread-safe
+	if it has been built with thread support, which the packages of the Linux distributions are not.
+	The messages are appended to the file in the order of grib_messages, each one as soon as it and all its predecessors are encoded.
+	*/
+	int retval, bits_per_value, batch_size;
+	int no_of_latlon_points = grid -> latlon_grid.no_of_lat_points*grid -> latlon_grid.no_of_lon_points;
+	codes_handle *handle;
+	const void *message;
+	size_t message_length, short_name_length;
+	double **batch_fields = malloc(GRIB_BATCH_SIZE*sizeof(double *));
+	double *latlon_fields = malloc(GRIB_BATCH_SIZE*no_of_latlon_points*sizeof(double));
+	for (int batch_begin = 0; batch_begin < no_of_messages; batch_begin += GRIB_BATCH_SIZE)
+	{
+		batch_size = no_of_messages - batch_begin;
+		if (batch_size > GRIB_BATCH_SIZE)
+		{
+			batch_size = GRIB_BATCH_SIZE;
+		}
+		for (int i = 0; i < batch_size; ++i)
+		{
+			batch_fields[i] = grib_messages[batch_begin + i].field;
+		}
+		interpolate_to_ll(batch_fields, latlon_fields, batch_size, &grid -> latlon_grid);
+		#pragma omp parallel for ordered schedule(dynamic, 1) private(retval, bits_per_value, handle, message, message_length, short_name_length)
+		for (int i = batch_begin; i < batch_begin + batch_size; ++i)
+		{
+			round_mantissa(&latlon_fields[(i - batch_begin)*no_of_latlon_points], no_of_latlon_points,
+			get_output_keepbits(config_io -> output_keepbits, grib_messages[i].name));
+			bits_per_value = get_grib_bits_per_value(config_io -> grib_bits_per_value, grib_messages[i].name);
+			#pragma omp critical (eccodes)
+			{
+				handle = codes_handle_clone(base_handle);
+				if (handle == NULL)
+				{
+					printf("Could not clone a GRIB handle.\n");
+					printf("Aborting.\n");
+					exit(1);
+				}
+			    if ((retval = codes_set_long(handle, "parameterCategory", grib_messages[i].parameter_category)))
+			        ECCERR(retval);
+			    if ((retval = codes_set_long(handle, "parameterNumber", grib_messages[i].parameter_number)))
+			        ECCERR(retval);
+				if ((retval = codes_set_long(handle, "typeOfFirstFixedSurface", grib_messages[i].type_of_first_fixed_surface)))
+				    ECCERR(retval);
+				if ((retval = codes_set_long(handle, "scaledValueOfFirstFixedSurface", grib_messages[i].scaled_value_of_first_fixed_surface)))
+				    ECCERR(retval);
+				if ((retval = codes_set_long(handle, "scaleFactorOfFirstFixedSurface", 1)))
+				    ECCERR(retval);
+				if ((retval = codes_set_long(handle, "level", grib_messages[i].level)))
+				    ECCERR(retval);
+				if (grib_messages[i].short_name != NULL)
+				{
+					short_name_length = strlen(grib_messages[i].short_name) + 1;
+					if ((retval = codes_set_string(handle, "shortName", grib_messages[i].short_name, &short_name_length)))
+					    ECCERR(retval);
+				}
+				// the packing has to be set before the values are
+				if (bits_per_value > 0)
+				{
+					if ((retval = codes_set_long(handle, "bitsPerValue", bits_per_value)))
+					    ECCERR(retval);
+				}
+				if ((retval = codes_set_double_array(handle, "values", &latlon_fields[(i - batch_begin)*no_of_latlon_points], no_of_latlon_points)))
+				    ECCERR(retval);
+			}
+			// the single writer, the messages are appended in a deterministic order
+			#pragma omp ordered
+			{
+				#pragma omp critical (eccodes)
+				{
+					if ((retval = codes_get_message(handle, &message, &message_length)))
+					    ECCERR(retval);
+					if (fwrite(message, 1, message_length, grib_file) != message_length)
+					{
+						printf("Could not write a GRIB message.\n");
+						printf("Aborting.\n");
+						exit(1);
+					}
+					codes_handle_delete(handle);
+				}
+			}
+		}
+	}
+	free(batch_fields);
+	free(latlon_fields);
+	return 0;
+}
+
+int get_grib_bits_per_value(char grib_bits_per_value[], char name[])
+{
+	/*
+	This function returns the bits per value of the variable name according to grib_bits_per_value (a list like "tcdc:12,mslp:16"),
+	0 means the packing of the GRIB template is kept.
+	*/
+	if (strcmp(grib_bits_per_value, "default") == 0)
+	{
+		return 0;
+	}
+	char *value = get_list_entry(grib_bits_per_value, name);
+	if (value == NULL)
+	{
+		return 0;
+	}
+	return strtol(value, NULL, 10);
+}
+
+char *get_list_entry(char list[], char name[])
+{
+	/*
+	This function returns a pointer to the value of the entry of the variable name in a comma-separated list of variable:value entries.
+	NULL is returned if there is no such entry or if the list is malformed.
+	*/
+	char *entry = list;
+	char *colon, *end;
+	while (*entry != '\0')
+	{
+		colon = strchr(entry, ':');
+		end = strchr(entry, ',');
+		if (end == NULL)
+		{
+			end = entry + strlen(entry);
+		}
+		if (colon == NULL || colon > end || colon == entry)
+		{
+			return NULL;
+		}
+		if ((size_t) (colon - entry) == strlen(name) && strncmp(entry, name, colon - entry) == 0)
+		{
+			return colon + 1;
+		}
+		entry = *end == ',' ? end + 1 : end;
+	}
+	return NULL;
+}
+
+int get_output_keepbits(char output_keepbits[], char name[])
+{
+	/*
+	This function returns the number of mantissa bits the output variable name is rounded to according to output_keepbits,
+	which is "off", "default" or a list like "t2:12,mslp:4d" (bits or, with a trailing d, decimal digits) that overrides the defaults.
+	0 means the variable is not rounded.
+	*/
+	if (strcmp(output_keepbits, "off") == 0)
+	{
+		return 0;
+	}
+	char *value = NULL;
+	if (strcmp(output_keepbits, "default") != 0)
+	{
+		value = get_list_entry(output_keepbits, name);
+	}
+	if (value != NULL)
+	{
+		char *number_end;
+		int keepbits = strtol(value, &number_end, 10);
+		// decimal digits are converted to the number of bits which resolves them
+		if (*number_end == 'd')
+		{
+			keepbits = (int) ceil(keepbits*log2(10.0));
+		}
+		return keepbits;
+	}
+	for (int i = 0; i < NO_OF_DEFAULT_OUTPUT_KEEPBITS; ++i)
+	{
+		if (strcmp(DEFAULT_OUTPUT_KEEPBITS[i].name, name) == 0)
+		{
+			return DEFAULT_OUTPUT_KEEPBITS[i].keepbits;
+		}
+	}
+	return 0;
+}
+
+int round_mantissa(double field[], int no_of_values, int keepbits)
+{
+	/*
+	This function rounds the mantissas of the values of field to keepbits bits (round to nearest, ties to even).
+	The trailing bits become zero, which is what makes the lossless compression of the output efficient.
+	Missing values (9999) and values which are not finite are kept.
+	*/
+	if (keepbits <= 0 || keepbits >= MAX_OUTPUT_KEEPBITS)
+	{
+		return 0;
+	}
+	int no_of_dropped_bits = MAX_OUTPUT_KEEPBITS - keepbits;
+	uint64_t half_minus_one = ((uint64_t) 1 << (no_of_dropped_bits - 1)) - 1;
+	uint64_t mask = ~(((uint64_t) 1 << no_of_dropped_bits) - 1);
+	uint64_t bits;
+	#pragma omp parallel for private(bits)
+	for (int i = 0; i < no_of_values; ++i)
+	{
+		if (field[i] == 9999 || isfinite(field[i]) == 0)
+		{
+			continue;
+		}
+		memcpy(&bits, &field[i], sizeof(double));
+		// the last kept bit decides about the direction of ties
+		bits += half_minus_one + ((bits >> no_of_dropped_bits) & 1);
+		bits = bits & mask;
+		memcpy(&field[i], &bits, sizeof(double));
+	}
+	return 0;
+}
+
+int report_compression_ratio(char file_name[], double raw_size)
+{
+	/*
+	This function prints the ratio of the size of the fields of an output file in double precision (raw_size, in bytes) and the size of the file.
+	*/
+	struct stat file_status;
+	if (stat(file_name, &file_status) != 0 || file_status.st_size == 0)
+	{
+		return 0;
+	}
+	printf("Compression ratio of %s: %lf\n", file_name, raw_size/file_status.st_size);
+	return 0;
+}
+
+int get_netcdf_create_mode(Config_io *config_io)
+{
+	/*
+	This function returns the mode the netcdf output files are created with.
+	*/
+	if (config_io -> netcdf4_switch == 1)
+	{
+		return NC_CLOBBER | NC_NETCDF4;
+	}
+	return NC_CLOBBER;
+}
+
+int set_netcdf_var_storage(int ncid, int varid, size_t chunk_shape[], Config_io *config_io)
+{
+	/*
+	This function sets the chunking and the filters of a netcdf output variable (NetCDF-4 only).
+	*/
+	if (config_io -> netcdf4_switch == 0)
+	{
+		return 0;
+	}
+	int retval;
+	if ((retval = nc_def_var_chunking(ncid, varid, NC_CHUNKED, chunk_shape)))
+		NCERR(retval);
+	// deflate, the shuffle filter is applied before the compression
+	if (config_io -> netcdf_compression == 1)
+	{
+		if ((retval = nc_def_var_deflate(ncid, varid, config_io -> netcdf_shuffle_switch, 1, config_io -> netcdf_compression_level)))
+			NCERR(retval);
+		return 0;
+	}
+	if (config_io -> netcdf_shuffle_switch == 1)
+	{
+		if ((retval = nc_def_var_deflate(ncid, varid, 1, 0, 0)))
+			NCERR(retval);
+	}
+	// zstd
+	if (config_io -> netcdf_compression == 2)
+	{
+		#if defined(NC_HAS_ZSTD) && NC_HAS_ZSTD
+		if ((retval = nc_def_var_zstandard(ncid, varid, config_io -> netcdf_compression_level)))
+			NCERR(retval);
+		#else
+		printf("The netcdf library does not support zstd compression, set netcdf_compression to 0 or 1.\n");
+		printf("Aborting.\n");
+		exit(1);
+		#endif
+	}
+	return 0;
+}
+
+int open_netcdf_output(char file_name[], Netcdf_time_series *time_series, Config_io *config_io, int *ncid, int *record, int *time_dimid)
+{
+	/*
+	This function opens a netcdf output file. It returns 1 if the file has been created (and is in define mode), 0 if a record is appended to an open time series file.
+	record is -1 and time_dimid is -1 if the file is not part of the time series output.
+	*/
+	int retval;
+	if (time_series != NULL && time_series -> open_bool == 1)
+	{
+		*ncid = time_series -> ncid;
+		*record = time_series -> no_of_records;
+		*time_dimid = -1;
+		return 0;
+	}
+	int create_mode = get_netcdf_create_mode(config_io);
+	// the classic format needs 64 bit offsets for files that grow beyond 2 GB
+	if (time_series != NULL && config_io -> netcdf4_switch == 0)
+	{
+		create_mode = create_mode | NC_64BIT_OFFSET;
+	}
+	if ((retval = nc_create(file_name, create_mode, ncid)))
+		NCERR(retval);
+	*record = -1;
+	*time_dimid = -1;
+	if (time_series != NULL)
+	{
+		int time_id;
+		if ((retval = nc_def_dim(*ncid, "time", NC_UNLIMITED, time_dimid)))
+			NCERR(retval);
+		if ((retval = nc_def_var(*ncid, "time", NC_DOUBLE, 1, time_dimid, &time_id)))
+			NCERR(retval);
+		if ((retval = nc_put_att_text(*ncid, time_id, "units", strlen("s since init"), "s since init")))
+			NCERR(retval);
+		time_series -> open_bool = 1;
+		time_series -> ncid = *ncid;
+		time_series -> no_of_records = 0;
+		*record = 0;
+	}
+	return 1;
+}
+
+int get_netcdf_dimids(int time_dimid, int dimid, int dimids[])
+{
+	/*
+	This function writes the dimensions of a netcdf output variable to dimids, the time dimension comes first if there is one.
+	It returns the number of dimensions.
+	*/
+	if (time_dimid == -1)
+	{
+		dimids[0] = dimid;
+		return 1;
+	}
+	dimids[0] = time_dimid;
+	dimids[1] = dimid;
+	return 2;
+}
+
+int put_netcdf_field(int ncid, char var_name[], int record, double field[], int keepbits)
+{
+	/*
+	This function writes a field to a netcdf output variable, to the record record if record is not -1.
+	If keepbits is positive, a copy of the field rounded to keepbits mantissa bits is written.
+	*/
+	int retval, varid, no_of_dims, dimids[NC_MAX_VAR_DIMS];
+	size_t start[NC_MAX_VAR_DIMS], count[NC_MAX_VAR_DIMS];
+	if ((retval = nc_inq_varid(ncid, var_name, &varid)))
+		NCERR(retval);
+	if ((retval = nc_inq_varndims(ncid, varid, &no_of_dims)))
+		NCERR(retval);
+	if ((retval = nc_inq_vardimid(ncid, varid, dimids)))
+		NCERR(retval);
+	size_t no_of_values = 1;
+	for (int i = 0; i < no_of_dims; ++i)
+	{
+		start[i] = 0;
+		if ((retval = nc_inq_dimlen(ncid, dimids[i], &count[i])))
+			NCERR(retval);
+		// the first dimension is the time
+		if (i == 0 && record != -1)
+		{
+			start[0] = record;
+			count[0] = 1;
+		}
+		no_of_values = no_of_values*count[i];
+	}
+	double *rounded_field = NULL;
+	if (keepbits > 0)
+	{
+		rounded_field = malloc(no_of_values*sizeof(double));
+		memcpy(rounded_field, field, no_of_values*sizeof(double));
+		round_mantissa(rounded_field, no_of_values, keepbits);
+		field = rounded_field;
+	}
+	if ((retval = nc_put_vara_double(ncid, varid, start, count, field)))
+		NCERR(retval);
+	free(rounded_field);
+	return 0;
+}
+
+int def_netcdf_output_variable(int ncid, char var_name[], int no_of_dims, int dimids[], size_t chunk_shape[], char units[], char output_variables[],
+Config_io *config_io)
+{
+	/*
+	This function defines a netcdf output variable including its storage and its unit if it is in the output list output_variables.
+	*/
+	if (output_variable_requested(output_variables, var_name) == 0)
+	{
+		return 0;
+	}
+	int retval, varid;
+	if ((retval = nc_def_var(ncid, var_name, NC_DOUBLE, no_of_dims, dimids, &varid)))
+		NCERR(retval);
+	set_netcdf_var_storage(ncid, varid, chunk_shape, config_io);
+	if ((retval = nc_put_att_text(ncid, varid, "units", strlen(units), units)))
+		NCERR(retval);
+	return 0;
+}
+
+int put_netcdf_output_variable(int ncid, char var_name[], int record, double field[], char output_variables[], char output_keepbits[])
+{
+	/*
+	This function writes a netcdf output variable if it is in the output list output_variables, rounded according to output_keepbits.
+	*/
+	if (output_variable_requested(output_variables, var_name) == 0)
+	{
+		return 0;
+	}
+	put_netcdf_field(ncid, var_name, record, field, get_output_keepbits(output_keepbits, var_name));
+	return 0;
+}
+
+int finish_netcdf_output(int ncid, Netcdf_time_series *time_series, int record, double time_since_init)
+{
+	/*
+	This function closes a netcdf output file. A time series file stays open, the time of the record is written and the file is flushed.
+	*/
+	int retval;
+	if (time_series == NULL)
+	{
+		close_netcdf_output_file(ncid);
+		return 0;
+	}
+	int time_id;
+	size_t time_index = record;
+	if ((retval = nc_inq_varid(ncid, "time", &time_id)))
+		NCERR(retval);
+	if ((retval = nc_put_var1_double(ncid, time_id, &time_index, &time_since_init)))
+		NCERR(retval);
+	// the file can be read while the model is still running
+	if ((retval = nc_sync(ncid)))
+		NCERR(retval);
+	time_series -> no_of_records = record + 1;
+	return 0;
+}
+
+int close_netcdf_time_series()
+{
+	/*
+	This function closes the files of the netcdf time series output at the end of the run.
+	*/
+	Netcdf_time_series *time_series[3] = {surface_time_series, pressure_level_time_series, model_level_time_series};
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < MAX_NO_OF_OUTPUT_STREAMS; ++j)
+		{
+			if (time_series[i][j].open_bool == 1)
+			{
+				close_netcdf_output_file(time_series[i][j].ncid);
+				time_series[i][j].open_bool = 0;
+			}
+		}
+	}
+	return 0;
+}
+
+int close_netcdf_output_file(int ncid)
+{
+	/*
+	This function closes a netcdf output file and reports its compression ratio.
+	*/
+	int retval, no_of_vars, no_of_dims, dimids[NC_MAX_VAR_DIMS];
+	nc_type var_type;
+	size_t path_length, type_size, dim_length;
+	double raw_size = 0.0;
+	if ((retval = nc_inq_path(ncid, &path_length, NULL)))
+		NCERR(retval);
+	char file_name[path_length + 1];
+	if ((retval = nc_inq_path(ncid, NULL, file_name)))
+		NCERR(retval);
+	// the size of all variables without compression
+	if ((retval = nc_inq_nvars(ncid, &no_of_vars)))
+		NCERR(retval);
+	for (int i = 0; i < no_of_vars; ++i)
+	{
+		if ((retval = nc_inq_var(ncid, i, NULL, &var_type, &no_of_dims, dimids, NULL)))
+			NCERR(retval);
+		if ((retval = nc_inq_type(ncid, var_type, NULL, &type_size)))
+			NCERR(retval);
+		double var_size = type_size;
+		for (int j = 0; j < no_of_dims; ++j)
+		{
+			if ((retval = nc_inq_dimlen(ncid, dimids[j], &dim_length)))
+				NCERR(retval);
+			var_size = var_size*dim_length;
+		}
+		raw_size += var_size;
+	}
+	if ((retval = nc_close(ncid)))
+		NCERR(retval);
+	report_compression_ratio(file_name, raw_size);
+	return 0;
+}
+
+int check_grib_bits_per_value(char grib_bits_per_value[])
+{
+	/*
+	This function checks the syntax of grib_bits_per_value and the numbers of bits in it.
+	*/
+	if (strcmp(grib_bits_per_value, "default") == 0)
+	{
+		return 0;
+	}
+	char *entry = grib_bits_per_value;
+	char *colon, *end, *number_end;
+	long bits_per_value;
+	while (*entry != '\0')
+	{
+		colon = strchr(entry, ':');
+		end = strchr(entry, ',');
+		if (end == NULL)
+		{
+			end = entry + strlen(entry);
+		}
+		if (colon == NULL || colon > end || colon == entry)
+		{
+			printf("grib_bits_per_value must be \"default\" or a comma-separated list of variable:bits_per_value entries.\n");
+			printf("Aborting.\n");
+			exit(1);
+		}
+		bits_per_value = strtol(colon + 1, &number_end, 10);
+		if (number_end != end || bits_per_value < MIN_GRIB_BITS_PER_VALUE || bits_per_value > MAX_GRIB_BITS_PER_VALUE)
+		{
+			printf("The bits per value in grib_bits_per_value must be integers between %d and %d.\n", MIN_GRIB_BITS_PER_VALUE, MAX_GRIB_BITS_PER_VALUE);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		entry = *end == ',' ? end + 1 : end;
+	}
+	return 0;
+}
+
+int check_output_keepbits(char output_keepbits[])
+{
+	/*
+	This function checks the syntax of output_keepbits and the numbers of bits or decimal digits in it.
+	*/
+	if (strcmp(output_keepbits, "off") == 0 || strcmp(output_keepbits, "default") == 0)
+	{
+		return 0;
+	}
+	char *entry = output_keepbits;
+	char *colon, *end, *number_end;
+	long keepbits;
+	while (*entry != '\0')
+	{
+		colon = strchr(entry, ':');
+		end = strchr(entry, ',');
+		if (end == NULL)
+		{
+			end = entry + strlen(entry);
+		}
+		if (colon == NULL || colon > end || colon == entry)
+		{
+			printf("output_keepbits must be \"off\", \"default\" or a comma-separated list of variable:bits or variable:digitsd entries.\n");
+			printf("Aborting.\n");
+			exit(1);
+		}
+		keepbits = strtol(colon + 1, &number_end, 10);
+		if (number_end + 1 == end && *number_end == 'd')
+		{
+			if (keepbits < 1 || keepbits > MAX_OUTPUT_KEEPDIGITS)
+			{
+				printf("The decimal digits in output_keepbits must be integers between 1 and %d.\n", MAX_OUTPUT_KEEPDIGITS);
+				printf("Aborting.\n");
+				exit(1);
+			}
+		}
+		else if (number_end != end || keepbits < 0 || keepbits > MAX_OUTPUT_KEEPBITS)
+		{
+			printf("The bits in output_keepbits must be integers between 0 and %d.\n", MAX_OUTPUT_KEEPBITS);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		entry = *end == ',' ? end + 1 : end;
+	}
+	return 0;
+}
+
+int output_variable_requested(char output_variables[], char name[])
+{
+	/*
+	This function returns 1 if the variable name is in the output list output_variables (a comma-separated list of variable names or "all"), 0 otherwise.
+	*/
+	if (strcmp(output_variables, "all") == 0)
+	{
+		return 1;
+	}
+	char *entry = output_variables;
+	char *end;
+	while (*entry != '\0')
+	{
+		end = strchr(entry, ',');
+		if (end == NULL)
+		{
+			end = entry + strlen(entry);
+		}
+		if ((size_t) (end - entry) == strlen(name) && strncmp(entry, name, end - entry) == 0)
+		{
+			return 1;
+		}
+		entry = *end == ',' ? end + 1 : end;
+	}
+	return 0;
+}
+
+int output_product_requested(char output_variables[], int product)
+{
+	/*
+	This function returns 1 if at least one variable of the output product product is in the output list output_variables, 0 otherwise.
+	*/
+	for (int i = 0; i < NO_OF_OUTPUT_VARIABLES; ++i)
+	{
+		if (OUTPUT_VARIABLES[i].product == product && output_variable_requested(output_variables, OUTPUT_VARIABLES[i].name) == 1)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int get_output_inputs(Config_io *config_io, int da_background_bool)
+{
+	/*
+	This function returns the shared intermediates (a combination of the bits of output_inputs) the output of one output time needs.
+	*/
+	int product_switches[3] = {config_io -> surface_output_switch, config_io -> pressure_level_output_switch, config_io -> model_level_output_switch};
+	int inputs = 0;
+	for (int i = 0; i < NO_OF_OUTPUT_VARIABLES; ++i)
+	{
+		if (product_switches[OUTPUT_VARIABLES[i].product] == 1 && output_variable_requested(config_io -> output_variables, OUTPUT_VARIABLES[i].name) == 1)
+		{
+			inputs = inputs | OUTPUT_VARIABLES[i].inputs;
+		}
+	}
+	// the output on the native grid always contains all its variables
+	if (config_io -> ugrid_output_switch == 1 || config_io -> shm_output_switch == 1)
+	{
+		inputs = inputs | PRESSURE_INPUT | RH_INPUT | UV_AT_CELL_INPUT | REL_VORT_INPUT | DIVV_H_INPUT;
+	}
+	// so does the background state of the data assimilation
+	if (da_background_bool == 1)
+	{
+		inputs = inputs | RH_INPUT | REL_VORT_INPUT | DIVV_H_INPUT;
+	}
+	return inputs;
+}
+
+int select_grib_messages(Grib_message grib_messages[], int no_of_messages, char output_variables[])
+{
+	/*
+	This function removes the GRIB messages of variables that are not in the output list output_variables and returns the number of remaining messages.
+	*/
+	int no_of_selected_messages = 0;
+	for (int i = 0; i < no_of_messages; ++i)
+	{
+		if (output_variable_requested(output_variables, grib_messages[i].name) == 1)
+		{
+			grib_messages[no_of_selected_messages] = grib_messages[i];
+			++no_of_selected_messages;
+		}
+	}
+	return no_of_selected_messages;
+}
+
+int set_pressure_levels(char pressure_levels[], Config_io *config_io)
+{
+	/*
+	This function reads the pressure levels of the pressure level output from pressure_levels (a comma-separated list of pressures in hPa).
+	*/
+	char *entry = pressure_levels;
+	char *number_end;
+	config_io -> no_of_pressure_levels = 0;
+	while (*entry != '\0')
+	{
+		if (config_io -> no_of_pressure_levels == MAX_NO_OF_PRESSURE_LEVELS)
+		{
+			printf("At most %d pressure levels can be set in pressure_levels.\n", MAX_NO_OF_PRESSURE_LEVELS);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		config_io -> pressure_levels[config_io -> no_of_pressure_levels] = 100.0*strtod(entry, &number_end);
+		if (number_end == entry || (*number_end != ',' && *number_end != '\0') || config_io -> pressure_levels[config_io -> no_of_pressure_levels] <= 0)
+		{
+			printf("pressure_levels must be a comma-separated list of positive pressures in hPa.\n");
+			printf("Aborting.\n");
+			exit(1);
+		}
+		++config_io -> no_of_pressure_levels;
+		entry = *number_end == ',' ? number_end + 1 : number_end;
+	}
+	if (config_io -> no_of_pressure_levels == 0)
+	{
+		printf("pressure_levels must contain at least one pressure level.\n");
+		printf("Aborting.\n");
+		exit(1);
+	}
+	return 0;
+}
+
+int check_output_variables(char output_variables[])
+{
+	/*
+	This function checks that every entry of the output list output_variables is a variable of the output.
+	*/
+	if (strcmp(output_variables, "all") == 0)
+	{
+		return 0;
+	}
+	char *entry = output_variables;
+	char *end;
+	int known_bool;
+	while (*entry != '\0')
+	{
+		end = strchr(entry, ',');
+		if (end == NULL)
+		{
+			end = entry + strlen(entry);
+		}
+		known_bool = 0;
+		for (int i = 0; i < NO_OF_OUTPUT_VARIABLES; ++i)
+		{
+			if ((size_t) (end - entry) == strlen(OUTPUT_VARIABLES[i].name) && strncmp(entry, OUTPUT_VARIABLES[i].name, end - entry) == 0)
+			{
+				known_bool = 1;
+			}
+		}
+		if (known_bool == 0)
+		{
+			printf("output_variables must be \"all\" or a comma-separated list of output variables, %.*s is not an output variable.\n", (int) (end - entry), entry);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		entry = *end == ',' ? end + 1 : end;
+	}
 	return 0;
 }
 
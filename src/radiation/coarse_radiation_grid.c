@@ -0,0 +1,238 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the radiation grid is set up, which is one or two resolution levels coarser than the model grid.
+The input of the radiation is aggregated from the cells of the model grid, the results are remapped conservatively.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <geos95.h>
+#include "../game_types.h"
+#include "../radiation/radiation.h"
+
+int set_radiation_grid(Grid *grid, Config *config, Radiation_grid *radiation_grid)
+{
+	/*
+	This function sets up the radiation grid. The generators of the coarse icosahedral grid are a subset of the generators
+	of the model grid, every cell of the model grid is assigned to the nearest of them.
+	*/
+	int coarse_res_id = RES_ID - config -> rad_coarsening;
+	int no_of_columns = NO_OF_PENTAGONS + 10*(pow(4, coarse_res_id) - 1);
+	radiation_grid -> no_of_columns = no_of_columns;
+	int *seed = malloc(no_of_columns*sizeof(int));
+	int *coarse_index_new = malloc(NO_OF_SCALARS_H*sizeof(int));
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		radiation_grid -> coarse_index[i] = -1;
+	}
+	for (int i = 0; i < no_of_columns; ++i)
+	{
+		upscale_scalar_point(coarse_res_id, i, &seed[i]);
+		radiation_grid -> coarse_index[seed[i]] = i;
+		radiation_grid -> latitude_scalar[i] = grid -> latitude_scalar[seed[i]];
+		radiation_grid -> longitude_scalar[i] = grid -> longitude_scalar[seed[i]];
+	}
+
+	// the radiation columns grow from their generators until every cell has been assigned to the nearest one
+	int changed_bool = 1;
+	int no_of_edges, vector_index, neighbour, best_index;
+	double distance, best_distance;
+	while (changed_bool == 1)
+	{
+		changed_bool = 0;
+		#pragma omp parallel for private(no_of_edges, vector_index, neighbour, best_index, distance, best_distance) reduction(max:changed_bool)
+		for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+		{
+			best_index = radiation_grid -> coarse_index[i];
+			best_distance = 10.0;
+			if (best_index >= 0)
+			{
+				best_distance = calculate_distance_h(grid -> latitude_scalar[i], grid -> longitude_scalar[i],
+				grid -> latitude_scalar[seed[best_index]], grid -> longitude_scalar[seed[best_index]], 1.0);
+			}
+			no_of_edges = 6;
+			if (i < NO_OF_PENTAGONS)
+			{
+				no_of_edges = 5;
+			}
+			for (int j = 0; j < no_of_edges; ++j)
+			{
+				vector_index = grid -> adjacent_vector_indices_h[6*i + j];
+				neighbour = grid -> from_index[vector_index];
+				if (neighbour == i)
+				{
+					neighbour = grid -> to_index[vector_index];
+				}
+				if (radiation_grid -> coarse_index[neighbour] < 0 || radiation_grid -> coarse_index[neighbour] == best_index)
+				{
+					continue;
+				}
+				distance = calculate_distance_h(grid -> latitude_scalar[i], grid -> longitude_scalar[i],
+				grid -> latitude_scalar[seed[radiation_grid -> coarse_index[neighbour]]], grid -> longitude_scalar[seed[radiation_grid -> coarse_index[neighbour]]], 1.0);
+				// ties are resolved in favour of the lower index to make the result independent of the number of threads
+				if (distance < best_distance || (distance == best_distance && radiation_grid -> coarse_index[neighbour] < best_index))
+				{
+					best_index = radiation_grid -> coarse_index[neighbour];
+					best_distance = distance;
+				}
+			}
+			coarse_index_new[i] = best_index;
+			if (best_index != radiation_grid -> coarse_index[i])
+			{
+				changed_bool = 1;
+			}
+		}
+		#pragma omp parallel for
+		for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+		{
+			radiation_grid -> coarse_index[i] = coarse_index_new[i];
+		}
+	}
+	free(coarse_index_new);
+	free(seed);
+
+	// collecting the cells of the model grid belonging to each radiation column
+	for (int i = 0; i <= no_of_columns; ++i)
+	{
+		radiation_grid -> fine_cells_start[i] = 0;
+	}
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		radiation_grid -> fine_cells_start[radiation_grid -> coarse_index[i] + 1] += 1;
+	}
+	for (int i = 0; i < no_of_columns; ++i)
+	{
+		radiation_grid -> fine_cells_start[i + 1] += radiation_grid -> fine_cells_start[i];
+	}
+	int *counter = calloc(no_of_columns, sizeof(int));
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		radiation_grid -> fine_cells[radiation_grid -> fine_cells_start[radiation_grid -> coarse_index[i]] + counter[radiation_grid -> coarse_index[i]]] = i;
+		counter[radiation_grid -> coarse_index[i]] += 1;
+	}
+	free(counter);
+
+	// the vertical positions are averaged with the volumes and areas as weights, the surface albedo with the surface areas
+	int fine_index;
+	double weight, weights_sum;
+	#pragma omp parallel for private(fine_index, weight, weights_sum)
+	for (int i = 0; i < no_of_columns; ++i)
+	{
+		for (int layer_index = 0; layer_index < NO_OF_LAYERS; ++layer_index)
+		{
+			radiation_grid -> z_scalar[layer_index*NO_OF_SCALARS_H + i] = 0.0;
+			weights_sum = 0.0;
+			for (int j = radiation_grid -> fine_cells_start[i]; j < radiation_grid -> fine_cells_start[i + 1]; ++j)
+			{
+				fine_index = layer_index*NO_OF_SCALARS_H + radiation_grid -> fine_cells[j];
+				weight = grid -> volume[fine_index];
+				radiation_grid -> z_scalar[layer_index*NO_OF_SCALARS_H + i] += weight*grid -> z_scalar[fine_index];
+				weights_sum += weight;
+			}
+			radiation_grid -> z_scalar[layer_index*NO_OF_SCALARS_H + i] = radiation_grid -> z_scalar[layer_index*NO_OF_SCALARS_H + i]/weights_sum;
+		}
+		for (int level_index = 0; level_index < NO_OF_LEVELS; ++level_index)
+		{
+			radiation_grid -> z_vector[level_index*NO_OF_VECTORS_PER_LAYER + i] = 0.0;
+			weights_sum = 0.0;
+			for (int j = radiation_grid -> fine_cells_start[i]; j < radiation_grid -> fine_cells_start[i + 1]; ++j)
+			{
+				fine_index = level_index*NO_OF_VECTORS_PER_LAYER + radiation_grid -> fine_cells[j];
+				weight = grid -> area[fine_index];
+				radiation_grid -> z_vector[level_index*NO_OF_VECTORS_PER_LAYER + i] += weight*grid -> z_vector[fine_index];
+				weights_sum += weight;
+			}
+			radiation_grid -> z_vector[level_index*NO_OF_VECTORS_PER_LAYER + i] = radiation_grid -> z_vector[level_index*NO_OF_VECTORS_PER_LAYER + i]/weights_sum;
+		}
+		radiation_grid -> sfc_albedo[i] = 0.0;
+		weights_sum = 0.0;
+		for (int j = radiation_grid -> fine_cells_start[i]; j < radiation_grid -> fine_cells_start[i + 1]; ++j)
+		{
+			weight = grid -> area[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + radiation_grid -> fine_cells[j]];
+			radiation_grid -> sfc_albedo[i] += weight*grid -> sfc_albedo[radiation_grid -> fine_cells[j]];
+			weights_sum += weight;
+		}
+		radiation_grid -> sfc_albedo[i] = radiation_grid -> sfc_albedo[i]/weights_sum;
+	}
+	return 0;
+}
+
+int coarsen_rad_input(double rho[], double temperature[], double temperature_soil[], Grid *grid, Radiation_grid *radiation_grid)
+{
+	/*
+	This function aggregates the input of the radiation from the cells of the model grid to the radiation columns.
+	Mass densities and temperatures are averaged with the volumes as weights, the soil temperature with the surface areas.
+	*/
+	int fine_index, coarse_index;
+	double weight, weights_sum;
+	#pragma omp parallel for private(fine_index, coarse_index, weight, weights_sum)
+	for (int i = 0; i < radiation_grid -> no_of_columns; ++i)
+	{
+		for (int layer_index = 0; layer_index < NO_OF_LAYERS; ++layer_index)
+		{
+			coarse_index = layer_index*NO_OF_SCALARS_H + i;
+			for (int const_id = 0; const_id < NO_OF_CONSTITUENTS; ++const_id)
+			{
+				radiation_grid -> rho[const_id*NO_OF_SCALARS + coarse_index] = 0.0;
+			}
+			radiation_grid -> temperature[coarse_index] = 0.0;
+			weights_sum = 0.0;
+			for (int j = radiation_grid -> fine_cells_start[i]; j < radiation_grid -> fine_cells_start[i + 1]; ++j)
+			{
+				fine_index = layer_index*NO_OF_SCALARS_H + radiation_grid -> fine_cells[j];
+				weight = grid -> volume[fine_index];
+				for (int const_id = 0; const_id < NO_OF_CONSTITUENTS; ++const_id)
+				{
+					radiation_grid -> rho[const_id*NO_OF_SCALARS + coarse_index] += weight*rho[const_id*NO_OF_SCALARS + fine_index];
+				}
+				radiation_grid -> temperature[coarse_index] += weight*temperature[fine_index];
+				weights_sum += weight;
+			}
+			for (int const_id = 0; const_id < NO_OF_CONSTITUENTS; ++const_id)
+			{
+				radiation_grid -> rho[const_id*NO_OF_SCALARS + coarse_index] = radiation_grid -> rho[const_id*NO_OF_SCALARS + coarse_index]/weights_sum;
+			}
+			radiation_grid -> temperature[coarse_index] = radiation_grid -> temperature[coarse_index]/weights_sum;
+		}
+		for (int soil_layer_index = 0; soil_layer_index < NO_OF_SOIL_LAYERS; ++soil_layer_index)
+		{
+			coarse_index = soil_layer_index*NO_OF_SCALARS_H + i;
+			radiation_grid -> temperature_soil[coarse_index] = 0.0;
+			weights_sum = 0.0;
+			for (int j = radiation_grid -> fine_cells_start[i]; j < radiation_grid -> fine_cells_start[i + 1]; ++j)
+			{
+				weight = grid -> area[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + radiation_grid -> fine_cells[j]];
+				radiation_grid -> temperature_soil[coarse_index] += weight*temperature_soil[soil_layer_index*NO_OF_SCALARS_H + radiation_grid -> fine_cells[j]];
+				weights_sum += weight;
+			}
+			radiation_grid -> temperature_soil[coarse_index] = radiation_grid -> temperature_soil[coarse_index]/weights_sum;
+		}
+	}
+	return 0;
+}
+
+int remap_rad_output(Radiation_grid *radiation_grid, double radiation_tendency[], double radiation_tendency_sw[], double sfc_sw_in[], double sfc_lw_out[])
+{
+	/*
+	This function remaps the results of the radiation back to the model grid. Every cell gets the value of its radiation column,
+	which conserves the volume integral of the heating rate and the area integrals of the surface fluxes.
+	*/
+	int coarse_index;
+	#pragma omp parallel for private(coarse_index)
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		coarse_index = radiation_grid -> coarse_index[i];
+		for (int layer_index = 0; layer_index < NO_OF_LAYERS; ++layer_index)
+		{
+			radiation_tendency[layer_index*NO_OF_SCALARS_H + i] = radiation_grid -> radiation_tendency[layer_index*NO_OF_SCALARS_H + coarse_index];
+			radiation_tendency_sw[layer_index*NO_OF_SCALARS_H + i] = radiation_grid -> radiation_tendency_sw[layer_index*NO_OF_SCALARS_H + coarse_index];
+		}
+		sfc_sw_in[i] = radiation_grid -> sfc_sw_in[coarse_index];
+		sfc_lw_out[i] = radiation_grid -> sfc_lw_out[coarse_index];
+	}
+	return 0;
+}
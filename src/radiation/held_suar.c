@@ -15,18 +15,22 @@ Calculates the Held-Suarez radiative forcing.
 double t_eq(double, double);
 double k_T(double, double);
 
-int held_suar(double latitude_scalar[], double z_scalar[], double mass_densities[], double temperature_gas[], double radiation_tendency[])
+int held_suar(double latitude_scalar[], double mass_densities[], double temperature_gas[], double radiation_tendency[], int first_column, int no_of_columns)
 {
-	int layer_index, h_index;
+	/*
+	works on the columns first_column, ..., first_column + no_of_columns - 1 of the model fields
+	*/
+	int i;
 	double pressure;
-	#pragma omp parallel for private(layer_index, h_index, pressure)
-	for (int i = 0; i < NO_OF_SCALARS_RAD; ++i)
+	for (int layer_index = 0; layer_index < NO_OF_LAYERS; ++layer_index)
 	{
-		layer_index = i/NO_OF_SCALARS_RAD_PER_LAYER;
-		h_index = i - layer_index*NO_OF_SCALARS_RAD_PER_LAYER;
-		pressure = mass_densities[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS_RAD + i]*R_D*temperature_gas[i];
-		radiation_tendency[i] = -k_T(latitude_scalar[h_index], pressure)*(temperature_gas[i] - t_eq(latitude_scalar[h_index], pressure));
-		radiation_tendency[i] = C_D_V*mass_densities[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS_RAD + i]*radiation_tendency[i];
+		for (int h_index = first_column; h_index < first_column + no_of_columns; ++h_index)
+		{
+			i = layer_index*NO_OF_SCALARS_H + h_index;
+			pressure = mass_densities[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + i]*R_D*temperature_gas[i];
+			radiation_tendency[i] = -k_T(latitude_scalar[h_index], pressure)*(temperature_gas[i] - t_eq(latitude_scalar[h_index], pressure));
+			radiation_tendency[i] = C_D_V*mass_densities[NO_OF_CONDENSED_CONSTITUENTS*NO_OF_SCALARS + i]*radiation_tendency[i];
+		}
 	}
 	return 0;
 }
@@ -9,174 +9,393 @@ This file manages the calls to the radiation routines.
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <omp.h>
 #include "../game_types.h"
 #include "../radiation/radiation.h"
 
-int create_rad_array_scalar(double [], double [], int);
-int create_rad_array_scalar_h(double [], double [], int);
-int create_rad_array_mass_den(double [], double [], int);
-int create_rad_array_vector(double [], double [], int);
-int remap_to_original(double [], double [], int);
-int remap_to_original_scalar_h(double [], double [], int);
+int compute_radiation(double [], double [], double [], Grid *, Radiation_grid *, Config *, double, double [], double [], double [], double []);
+int call_radiation_blocks(int, double [], double [], double [], double [], double [], double [], double [], double [], Config *, double, double [], double [], double [], double []);
+void *async_radiation_thread(void *);
 
-int call_radiation(State *state, Grid *grid, Dualgrid *dualgrid, State *state_tendency, Diagnostics *diagnostics, Forcings *forcings, Irreversible_quantities *irrev, Config *config, double delta_t, double time_coordinate)
+// stack size of the asynchronous radiation thread in bytes
+const size_t RAD_THREAD_STACK_SIZE = 512*1024*1024;
+// rough estimate of the memory RTE+RRTMGP works on per column and layer (a few arrays with one entry per g-point) in bytes
+const int RAD_BYTES_PER_COLUMN_AND_LAYER = 4096;
+// the smallest automatically chosen radiation chunk (shorter chunks would hurt the vectorization in RTE+RRTMGP)
+const int MIN_RAD_CHUNK_SIZE = 16;
+// the number of chunks every thread should get at least for a good load balance
+const int RAD_CHUNKS_PER_THREAD = 4;
+// cache size assumed if it cannot be determined at run time in bytes
+const long DEFAULT_CACHE_SIZE = 1024*1024;
+
+int call_radiation(State *state, Grid *grid, Radiation_grid *radiation_grid, Dualgrid *dualgrid, State *state_tendency, Diagnostics *diagnostics, Forcings *forcings, Irreversible_quantities *irrev, Config *config, double delta_t, double time_coordinate)
 {
+	/*
+	This function calls the radiation routines synchronously, the results are directly written to the forcings.
+	*/
 	if (config -> rad_on == 1)
 	{
 		printf("Starting update of radiative fluxes ...\n");
 	}
-	int no_of_scalars = NO_OF_SCALARS_RAD;
-	int no_of_constituents = NO_OF_CONSTITUENTS;
-	int no_of_condensed_constituents = NO_OF_CONDENSED_CONSTITUENTS;
-	int no_of_layers = NO_OF_LAYERS;
-	// loop over all radiation blocks
-	#pragma omp parallel for
-	for (int rad_block_index = 0; rad_block_index < NO_OF_RAD_BLOCKS; ++rad_block_index)
-	{
-		Radiation *radiation = calloc(1, sizeof(Radiation));
-		// remapping all the arrays
-		create_rad_array_scalar_h(grid -> latitude_scalar, radiation -> lat_scal, rad_block_index);
-		create_rad_array_scalar_h(grid -> longitude_scalar, radiation -> lon_scal, rad_block_index);
-		create_rad_array_scalar_h(state -> temperature_soil, radiation -> temp_sfc, rad_block_index);
-		create_rad_array_scalar_h(grid -> sfc_albedo, radiation -> sfc_albedo, rad_block_index);
-		create_rad_array_scalar(grid -> z_scalar, radiation -> z_scal, rad_block_index);
-		create_rad_array_vector(grid -> z_vector, radiation -> z_vect, rad_block_index);
-		create_rad_array_mass_den(state -> rho, radiation -> rho, rad_block_index);
-		create_rad_array_scalar(diagnostics -> temperature, radiation -> temp, rad_block_index);
-		// calling the radiation routine
-		// RTE+RRTMGP
-		if (config -> rad_on == 1)
-		{
-			calc_radiative_flux_convergence(radiation -> lat_scal,
-			radiation -> lon_scal,
-			radiation -> z_scal,
-			radiation -> z_vect,
-			radiation -> rho,
-			radiation -> temp,
-			radiation -> rad_tend,
-			radiation -> temp_sfc,
-			radiation -> sfc_sw_in,
-			radiation -> sfc_lw_out,
-			radiation -> sfc_albedo,
-			&no_of_scalars, &no_of_layers,
-			&no_of_constituents, &no_of_condensed_constituents,
-			&time_coordinate);
-		}
-		// Held-Suarez
-		if (config -> rad_on == 2)
-		{
-			held_suar(radiation -> lat_scal, radiation -> z_scal, radiation -> rho, radiation -> temp, radiation -> rad_tend);
-		}
-		// filling the actual radiation tendency
-		remap_to_original(radiation -> rad_tend, forcings -> radiation_tendency, rad_block_index);
-		remap_to_original_scalar_h(radiation -> sfc_sw_in, forcings -> sfc_sw_in, rad_block_index);
-		remap_to_original_scalar_h(radiation -> sfc_lw_out, forcings -> sfc_lw_out, rad_block_index);
-		free(radiation);
+	compute_radiation(state -> rho, diagnostics -> temperature, state -> temperature_soil, grid, radiation_grid, config, time_coordinate,
+	forcings -> radiation_tendency, forcings -> radiation_tendency_sw, forcings -> sfc_sw_in, forcings -> sfc_lw_out);
+	if (config -> rad_on == 1 && config -> rad_time_interpol == 1)
+	{
+		store_rad_result(grid, forcings, time_coordinate);
 	}
 	if (config -> rad_on == 1)
 	{
 		printf("Update of radiative fluxes completed.\n");
+		print_rad_global_means(grid, forcings);
 	}
 	return 0;
 }
 
-int create_rad_array_scalar(double in[], double out[], int rad_block_index)
+int start_async_radiation(State *state, Grid *grid, Radiation_grid *radiation_grid, Diagnostics *diagnostics, Async_radiation *async_radiation, Config *config, double time_coordinate)
 {
 	/*
-	cuts out a slice of a scalar field for hand-over to the radiation routine (done for RAM efficiency reasons)
+	This function hands over a snapshot of the model state to a separate radiation thread and returns immediately.
 	*/
-	int layer_index, h_index;
-	// loop over all elements of the resulting array
-	for (int i = 0; i < NO_OF_SCALARS_RAD; ++i)
+	if (config -> rad_on == 1)
+	{
+		printf("Starting asynchronous update of radiative fluxes ...\n");
+	}
+	// a previous radiation update must have been collected before a new one can be started
+	if (async_radiation -> running_bool == 1)
+	{
+		finish_async_radiation(async_radiation, NULL);
+	}
+	// taking the snapshot
+	memcpy(async_radiation -> rho, state -> rho, sizeof(Mass_densities));
+	memcpy(async_radiation -> temperature, diagnostics -> temperature, sizeof(Scalar_field));
+	memcpy(async_radiation -> temperature_soil, state -> temperature_soil, NO_OF_SOIL_LAYERS*NO_OF_SCALARS_H*sizeof(double));
+	async_radiation -> time_coordinate = time_coordinate;
+	async_radiation -> grid = grid;
+	async_radiation -> radiation_grid = radiation_grid;
+	async_radiation -> config = config;
+	async_radiation -> finished_bool = 0;
+	// the radiation thread needs a large stack because of the automatic arrays of the radiation scheme
+	pthread_attr_t thread_attributes;
+	pthread_attr_init(&thread_attributes);
+	pthread_attr_setstacksize(&thread_attributes, RAD_THREAD_STACK_SIZE);
+	if (pthread_create(&async_radiation -> thread, &thread_attributes, async_radiation_thread, async_radiation) != 0)
 	{
-		layer_index = i/NO_OF_SCALARS_RAD_PER_LAYER;
-		h_index = i - layer_index*NO_OF_SCALARS_RAD_PER_LAYER;
-		out[i] = in[rad_block_index*NO_OF_SCALARS_RAD_PER_LAYER + h_index + layer_index*NO_OF_SCALARS_H];
+		printf("Could not start the radiation thread.\n");
+		printf("Aborting.\n");
+		exit(1);
 	}
+	pthread_attr_destroy(&thread_attributes);
+	async_radiation -> running_bool = 1;
 	return 0;
 }
 
-int create_rad_array_scalar_h(double in[], double out[], int rad_block_index)
+int finish_async_radiation(Async_radiation *async_radiation, Forcings *forcings)
 {
 	/*
-	cuts out a slice of a horizontal scalar field for hand-over to the radiation routine (done for RAM efficiency reasons)
+	This function waits for the radiation thread and swaps the new radiative fluxes into the forcings.
+	If forcings is NULL, the results are discarded.
 	*/
-	// loop over all elements of the resulting array
-	for (int i = 0; i < NO_OF_SCALARS_RAD_PER_LAYER; ++i)
+	if (async_radiation -> running_bool == 0)
 	{
-		out[i] = in[rad_block_index*NO_OF_SCALARS_RAD_PER_LAYER + i];
+		return 0;
+	}
+	pthread_join(async_radiation -> thread, NULL);
+	async_radiation -> running_bool = 0;
+	if (forcings != NULL)
+	{
+		memcpy(forcings -> radiation_tendency, async_radiation -> radiation_tendency, sizeof(Scalar_field));
+		memcpy(forcings -> radiation_tendency_sw, async_radiation -> radiation_tendency_sw, sizeof(Scalar_field));
+		memcpy(forcings -> sfc_sw_in, async_radiation -> sfc_sw_in, NO_OF_SCALARS_H*sizeof(double));
+		memcpy(forcings -> sfc_lw_out, async_radiation -> sfc_lw_out, NO_OF_SCALARS_H*sizeof(double));
+		if (async_radiation -> config -> rad_on == 1)
+		{
+			print_rad_global_means(async_radiation -> grid, forcings);
+		}
+		if (async_radiation -> config -> rad_on == 1 && async_radiation -> config -> rad_time_interpol == 1)
+		{
+			store_rad_result(async_radiation -> grid, forcings, async_radiation -> time_coordinate);
+		}
 	}
 	return 0;
 }
 
-int create_rad_array_mass_den(double in[], double out[], int rad_block_index)
+int async_radiation_finished(Async_radiation *async_radiation, Forcings *forcings)
 {
 	/*
-	same thing as create_rad_array_scalar, only for a mass density field
+	This function returns 1 if no radiation update is running, without waiting for the radiation thread.
+	A thread which is done is joined and its results are swapped into the forcings.
 	*/
-	int layer_index, h_index;
-	for (int const_id = 0; const_id < NO_OF_CONSTITUENTS; ++const_id)
+	if (async_radiation -> running_bool == 1 && __atomic_load_n(&async_radiation -> finished_bool, __ATOMIC_ACQUIRE) == 1)
 	{
-		// loop over all elements of the resulting array
-		for (int i = 0; i < NO_OF_SCALARS_RAD; ++i)
-		{
-			layer_index = i/NO_OF_SCALARS_RAD_PER_LAYER;
-			h_index = i - layer_index*NO_OF_SCALARS_RAD_PER_LAYER;
-			out[const_id*NO_OF_SCALARS_RAD + i]
-			= in[const_id*NO_OF_SCALARS + rad_block_index*NO_OF_SCALARS_RAD_PER_LAYER + h_index + layer_index*NO_OF_SCALARS_H];
-		}
+		finish_async_radiation(async_radiation, forcings);
+	}
+	return async_radiation -> running_bool == 0;
+}
+
+void *async_radiation_thread(void *argument)
+{
+	/*
+	This is the function executed by the radiation thread. It works with its own OpenMP team.
+	*/
+	Async_radiation *async_radiation = (Async_radiation *) argument;
+	omp_set_num_threads(async_radiation -> config -> no_of_rad_threads);
+	compute_radiation(async_radiation -> rho, async_radiation -> temperature, async_radiation -> temperature_soil,
+	async_radiation -> grid, async_radiation -> radiation_grid, async_radiation -> config, async_radiation -> time_coordinate,
+	async_radiation -> radiation_tendency, async_radiation -> radiation_tendency_sw, async_radiation -> sfc_sw_in, async_radiation -> sfc_lw_out);
+	__atomic_store_n(&async_radiation -> finished_bool, 1, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+int compute_radiation(double rho[], double temperature[], double temperature_soil[], Grid *grid, Radiation_grid *radiation_grid, Config *config, double time_coordinate,
+double radiation_tendency[], double radiation_tendency_sw[], double sfc_sw_in[], double sfc_lw_out[])
+{
+	/*
+	This function computes the radiation either on the model grid or on the coarser radiation grid.
+	*/
+	if (config -> rad_coarsening == 0)
+	{
+		call_radiation_blocks(NO_OF_SCALARS_H, grid -> latitude_scalar, grid -> longitude_scalar, grid -> z_scalar, grid -> z_vector, grid -> sfc_albedo,
+		rho, temperature, temperature_soil, config, time_coordinate, radiation_tendency, radiation_tendency_sw, sfc_sw_in, sfc_lw_out);
+	}
+	else
+	{
+		coarsen_rad_input(rho, temperature, temperature_soil, grid, radiation_grid);
+		call_radiation_blocks(radiation_grid -> no_of_columns, radiation_grid -> latitude_scalar, radiation_grid -> longitude_scalar,
+		radiation_grid -> z_scalar, radiation_grid -> z_vector, radiation_grid -> sfc_albedo,
+		radiation_grid -> rho, radiation_grid -> temperature, radiation_grid -> temperature_soil, config, time_coordinate,
+		radiation_grid -> radiation_tendency, radiation_grid -> radiation_tendency_sw, radiation_grid -> sfc_sw_in, radiation_grid -> sfc_lw_out);
+		remap_rad_output(radiation_grid, radiation_tendency, radiation_tendency_sw, sfc_sw_in, sfc_lw_out);
 	}
 	return 0;
 }
 
-int create_rad_array_vector(double in[], double out[], int rad_block_index)
+int call_radiation_blocks(int no_of_columns_total, double latitude_scalar[], double longitude_scalar[], double z_scalar[], double z_vector[], double sfc_albedo[],
+double rho[], double temperature[], double temperature_soil[], Config *config, double time_coordinate,
+double radiation_tendency[], double radiation_tendency_sw[], double sfc_sw_in[], double sfc_lw_out[])
 {
 	/*
-	cuts out a slice of a vector field for hand-over to the radiation routine (done for RAM efficiency reasons),
-	only the vertical vector points are taken into account since only they are needed by the radiation
+	This function cuts the first no_of_columns_total columns of the given fields into chunks and hands them out dynamically to the threads,
+	which call the radiation routines for each of them. The radiation routines work directly on the fields
+	(no copies), every thread uses its own workspace.
+	In the case of RTE+RRTMGP, the columns are sorted into day and night columns first. The short wave part is then computed
+	for the day columns only and the long wave part for all columns, in two separate parallel phases.
 	*/
-	int layer_index, h_index;
-	// loop over all elements of the resulting array
-	for (int i = 0; i < NO_OF_SCALARS_RAD + NO_OF_SCALARS_RAD_PER_LAYER; ++i)
+	int no_of_scalars_h = NO_OF_SCALARS_H;
+	int no_of_layers = NO_OF_LAYERS;
+	int no_of_vectors_per_layer = NO_OF_VECTORS_PER_LAYER;
+	int no_of_constituents = NO_OF_CONSTITUENTS;
+	int no_of_condensed_constituents = NO_OF_CONDENSED_CONSTITUENTS;
+	int chunk_size, no_of_chunks, first_column, no_of_columns, workspace_index;
+	
+	// Held-Suarez
+	if (config -> rad_on == 2)
 	{
-		layer_index = i/NO_OF_SCALARS_RAD_PER_LAYER;
-		h_index = i - layer_index*NO_OF_SCALARS_RAD_PER_LAYER;
-		out[i] = in[rad_block_index*NO_OF_SCALARS_RAD_PER_LAYER + h_index + layer_index*NO_OF_VECTORS_PER_LAYER];
+		chunk_size = get_rad_chunk_size(config, no_of_columns_total);
+		// the last chunk takes the remainder
+		no_of_chunks = (no_of_columns_total + chunk_size - 1)/chunk_size;
+		#pragma omp parallel for schedule(dynamic, 1) private(first_column, no_of_columns)
+		for (int chunk_index = 0; chunk_index < no_of_chunks; ++chunk_index)
+		{
+			first_column = chunk_index*chunk_size;
+			no_of_columns = chunk_size;
+			if (first_column + no_of_columns > no_of_columns_total)
+			{
+				no_of_columns = no_of_columns_total - first_column;
+			}
+			held_suar(latitude_scalar, rho, temperature, radiation_tendency, first_column, no_of_columns);
+			for (int i = first_column; i < first_column + no_of_columns; ++i)
+			{
+				sfc_sw_in[i] = 0.0;
+				sfc_lw_out[i] = 0.0;
+			}
+			for (int layer_index = 0; layer_index < NO_OF_LAYERS; ++layer_index)
+			{
+				for (int i = first_column; i < first_column + no_of_columns; ++i)
+				{
+					radiation_tendency_sw[layer_index*NO_OF_SCALARS_H + i] = 0.0;
+				}
+			}
+		}
+		return 0;
 	}
+	
+	// RTE+RRTMGP
+	// global day/night partition: the day columns come first in column_list, followed by the night columns
+	double *cos_zenith = malloc(NO_OF_SCALARS_H*sizeof(double));
+	int *column_list = malloc(no_of_columns_total*sizeof(int));
+	#pragma omp parallel for
+	for (int i = 0; i < no_of_columns_total; ++i)
+	{
+		cos_zenith[i] = coszenith(latitude_scalar[i], longitude_scalar[i], time_coordinate);
+	}
+	int no_of_day_columns = 0;
+	for (int i = 0; i < no_of_columns_total; ++i)
+	{
+		if (cos_zenith[i] > 0.0)
+		{
+			column_list[no_of_day_columns] = i;
+			++no_of_day_columns;
+		}
+	}
+	int night_column_counter = no_of_day_columns;
+	for (int i = 0; i < no_of_columns_total; ++i)
+	{
+		if (cos_zenith[i] <= 0.0)
+		{
+			column_list[night_column_counter] = i;
+			++night_column_counter;
+		}
+	}
+	// there is no short wave radiation in the night columns
+	#pragma omp parallel for
+	for (int j = no_of_day_columns; j < no_of_columns_total; ++j)
+	{
+		sfc_sw_in[column_list[j]] = 0.0;
+		for (int layer_index = 0; layer_index < NO_OF_LAYERS; ++layer_index)
+		{
+			radiation_tendency_sw[layer_index*NO_OF_SCALARS_H + column_list[j]] = 0.0;
+		}
+	}
+	
+	// short wave phase (day columns only)
+	if (no_of_day_columns > 0)
+	{
+		chunk_size = get_rad_chunk_size(config, no_of_day_columns);
+		no_of_chunks = (no_of_day_columns + chunk_size - 1)/chunk_size;
+		#pragma omp parallel for schedule(dynamic, 1) private(first_column, no_of_columns, workspace_index)
+		for (int chunk_index = 0; chunk_index < no_of_chunks; ++chunk_index)
+		{
+			first_column = chunk_index*chunk_size;
+			no_of_columns = chunk_size;
+			if (first_column + no_of_columns > no_of_day_columns)
+			{
+				no_of_columns = no_of_day_columns - first_column;
+			}
+			workspace_index = omp_get_thread_num();
+			calc_sw_flux_convergence(cos_zenith,
+			z_scalar,
+			z_vector,
+			rho,
+			temperature,
+			radiation_tendency_sw,
+			temperature_soil,
+			sfc_sw_in,
+			sfc_albedo,
+			&no_of_scalars_h, &no_of_layers, &no_of_vectors_per_layer,
+			&no_of_constituents, &no_of_condensed_constituents,
+			&column_list[first_column], &no_of_columns, &workspace_index);
+		}
+	}
+	
+	// long wave phase (all columns), which also adds up the short wave and the long wave heating
+	chunk_size = get_rad_chunk_size(config, no_of_columns_total);
+	no_of_chunks = (no_of_columns_total + chunk_size - 1)/chunk_size;
+	#pragma omp parallel for schedule(dynamic, 1) private(first_column, no_of_columns, workspace_index)
+	for (int chunk_index = 0; chunk_index < no_of_chunks; ++chunk_index)
+	{
+		first_column = chunk_index*chunk_size;
+		no_of_columns = chunk_size;
+		if (first_column + no_of_columns > no_of_columns_total)
+		{
+			no_of_columns = no_of_columns_total - first_column;
+		}
+		workspace_index = omp_get_thread_num();
+		calc_lw_flux_convergence(z_scalar,
+		z_vector,
+		rho,
+		temperature,
+		radiation_tendency,
+		radiation_tendency_sw,
+		temperature_soil,
+		sfc_lw_out,
+		&no_of_scalars_h, &no_of_layers, &no_of_vectors_per_layer,
+		&no_of_constituents, &no_of_condensed_constituents,
+		&column_list[first_column], &no_of_columns, &workspace_index);
+	}
+	free(column_list);
+	free(cos_zenith);
 	return 0;
 }
 
-int remap_to_original(double in[], double out[], int rad_block_index)
+int print_rad_global_means(Grid *grid, Forcings *forcings)
 {
 	/*
-	reverses what create_rad_array_scalar has done
+	This function prints the global means of the radiative heating of the atmosphere and of the surface fluxes,
+	which makes it possible to compare the effect of different radiation settings.
 	*/
-	int layer_index, h_index;
-	// loop over all elements of the resulting array
-	for (int i = 0; i < NO_OF_SCALARS_RAD; ++i)
+	double heating = 0.0;
+	double sfc_sw_in = 0.0;
+	double sfc_lw_out = 0.0;
+	double sfc_area = 0.0;
+	#pragma omp parallel for reduction(+:heating)
+	for (int i = 0; i < NO_OF_SCALARS; ++i)
 	{
-		layer_index = i/NO_OF_SCALARS_RAD_PER_LAYER;
-		h_index = i - layer_index*NO_OF_SCALARS_RAD_PER_LAYER;
-		out[rad_block_index*NO_OF_SCALARS_RAD_PER_LAYER + h_index + layer_index*NO_OF_SCALARS_H] = in[i];
+		heating += forcings -> radiation_tendency[i]*grid -> volume[i];
 	}
+	#pragma omp parallel for reduction(+:sfc_sw_in, sfc_lw_out, sfc_area)
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		sfc_sw_in += forcings -> sfc_sw_in[i]*grid -> area[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i];
+		sfc_lw_out += forcings -> sfc_lw_out[i]*grid -> area[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i];
+		sfc_area += grid -> area[NO_OF_LAYERS*NO_OF_VECTORS_PER_LAYER + i];
+	}
+	printf("Global mean radiative heating of the atmosphere: %lf W/m^2\n", heating/sfc_area);
+	printf("Global mean surface short wave in: %lf W/m^2\n", sfc_sw_in/sfc_area);
+	printf("Global mean surface long wave out: %lf W/m^2\n", sfc_lw_out/sfc_area);
 	return 0;
 }
 
+int get_no_of_rad_workspaces(Config *config)
+{
+	/*
+	This function returns the maximum number of threads which can call the radiation routines at the same time.
+	*/
+	int no_of_workspaces = omp_get_max_threads();
+	if (config -> rad_async == 1 && config -> no_of_rad_threads > no_of_workspaces)
+	{
+		no_of_workspaces = config -> no_of_rad_threads;
+	}
+	return no_of_workspaces;
+}
 
-int remap_to_original_scalar_h(double in[], double out[], int rad_block_index)
+int get_rad_chunk_size(Config *config, int no_of_columns_total)
 {
 	/*
-	reverses what create_rad_array_scalar_h has done
+	This function returns the number of columns per radiation chunk for a grid of no_of_columns_total columns. If the user has not set it, it is determined
+	from the number of threads (for load balancing) and the cache size (the working set of a chunk should fit into it).
 	*/
-	// loop over all elements of the resulting array
-	for (int i = 0; i < NO_OF_SCALARS_RAD_PER_LAYER; ++i)
+	if (config -> rad_chunk_size > 0)
 	{
-		out[rad_block_index*NO_OF_SCALARS_RAD_PER_LAYER + i] = in[i];
+		return config -> rad_chunk_size;
 	}
-	return 0;
+	long cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	if (cache_size <= 0)
+	{
+		cache_size = DEFAULT_CACHE_SIZE;
+	}
+	int chunk_size_cache = cache_size/(RAD_BYTES_PER_COLUMN_AND_LAYER*NO_OF_LAYERS);
+	int chunk_size_balance = no_of_columns_total/(RAD_CHUNKS_PER_THREAD*omp_get_max_threads());
+	int chunk_size = chunk_size_cache;
+	if (chunk_size_balance < chunk_size)
+	{
+		chunk_size = chunk_size_balance;
+	}
+	if (chunk_size < MIN_RAD_CHUNK_SIZE)
+	{
+		chunk_size = MIN_RAD_CHUNK_SIZE;
+	}
+	if (chunk_size > no_of_columns_total)
+	{
+		chunk_size = no_of_columns_total;
+	}
+	return chunk_size;
 }
 
 
 
 
 
+
+
@@ -0,0 +1,349 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+This is a standalone driver for timing the radiation routines without the dynamical core.
+The model atmosphere is either a synthetic standard atmosphere or read from a grid file and an initialization state file.
+The short wave and the long wave part are timed separately for an increasing number of threads.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <netcdf.h>
+#include <omp.h>
+#include "../game_types.h"
+#include "../game_constants.h"
+#include "../radiation/radiation.h"
+#define ERRCODE 2
+#define ERR(e) {printf("Error: %s\n", nc_strerror(e)); exit(ERRCODE);}
+
+int set_synthetic_atmosphere(int, int, int, int, double [], double [], double [], double [], double [], double [], double [], double []);
+int read_atmosphere(char [], char [], double [], double [], double [], double [], double [], double [], double [], double []);
+double time_sw(int, int, int, int, int, int, int [], double [], double [], double [], double [], double [], double [], double [], double [], double []);
+double time_lw(int, int, int, int, int, int, int [], double [], double [], double [], double [], double [], double [], double [], double []);
+
+// the time coordinate of the benchmark (2021-06-21, 12 UTC), about half of the columns are day columns
+const double BENCHMARK_TIME = 1624276800.0;
+// the height of the top of the synthetic atmosphere in meters
+const double SYNTHETIC_TOA = 41152.0;
+
+int main(int argc, char *argv[])
+{
+	if (argc != 8 && argc != 10)
+	{
+		printf("Usage: rad_benchmark no_of_columns no_of_layers no_of_repetitions max_no_of_threads chunk_size sw_full_gpoints lw_full_gpoints [grid_file init_state_file]\n");
+		printf("Aborting.\n");
+		exit(1);
+	}
+	int no_of_columns = strtod(argv[1], NULL);
+	int no_of_layers = strtod(argv[2], NULL);
+	int no_of_repetitions = strtod(argv[3], NULL);
+	int max_no_of_threads = strtod(argv[4], NULL);
+	int chunk_size = strtod(argv[5], NULL);
+	int sw_full_gpoints = strtod(argv[6], NULL);
+	int lw_full_gpoints = strtod(argv[7], NULL);
+	if (no_of_columns < 1 || no_of_layers < 2 || no_of_repetitions < 1 || max_no_of_threads < 1 || chunk_size < 1)
+	{
+		printf("no_of_columns, no_of_repetitions, max_no_of_threads and chunk_size must be at least 1, no_of_layers at least 2.\n");
+		printf("Aborting.\n");
+		exit(1);
+	}
+
+	// the fields have the layout of the model fields, the strides are those of the model grid if the atmosphere is read from files
+	int no_of_scalars_h = no_of_columns;
+	int no_of_vectors_per_layer = no_of_columns;
+	if (argc == 10)
+	{
+		if (no_of_columns > NO_OF_SCALARS_H || no_of_layers != NO_OF_LAYERS)
+		{
+			printf("If the atmosphere is read from files, no_of_columns must not exceed %d and no_of_layers must be %d.\n", NO_OF_SCALARS_H, NO_OF_LAYERS);
+			printf("Aborting.\n");
+			exit(1);
+		}
+		no_of_scalars_h = NO_OF_SCALARS_H;
+		no_of_vectors_per_layer = NO_OF_VECTORS_PER_LAYER;
+	}
+	double *latitude_scalar = malloc(no_of_scalars_h*sizeof(double));
+	double *longitude_scalar = malloc(no_of_scalars_h*sizeof(double));
+	double *sfc_albedo = malloc(no_of_scalars_h*sizeof(double));
+	double *z_scalar = malloc(no_of_layers*no_of_scalars_h*sizeof(double));
+	double *z_vector = malloc((no_of_layers*no_of_vectors_per_layer + no_of_scalars_h)*sizeof(double));
+	double *rho = malloc(NO_OF_CONSTITUENTS*no_of_layers*no_of_scalars_h*sizeof(double));
+	double *temperature = malloc(no_of_layers*no_of_scalars_h*sizeof(double));
+	double *temperature_soil = malloc(NO_OF_SOIL_LAYERS*no_of_scalars_h*sizeof(double));
+	double *radiation_tendency = malloc(no_of_layers*no_of_scalars_h*sizeof(double));
+	double *radiation_tendency_sw = malloc(no_of_layers*no_of_scalars_h*sizeof(double));
+	double *sfc_sw_in = malloc(no_of_scalars_h*sizeof(double));
+	double *sfc_lw_out = malloc(no_of_scalars_h*sizeof(double));
+	double *cos_zenith = malloc(no_of_scalars_h*sizeof(double));
+	int *column_list = malloc(no_of_columns*sizeof(int));
+	if (argc == 10)
+	{
+		read_atmosphere(argv[8], argv[9], latitude_scalar, longitude_scalar, sfc_albedo, z_scalar, z_vector, rho, temperature, temperature_soil);
+	}
+	else
+	{
+		set_synthetic_atmosphere(no_of_columns, no_of_layers, no_of_scalars_h, no_of_vectors_per_layer,
+		latitude_scalar, longitude_scalar, sfc_albedo, z_scalar, z_vector, rho, temperature, temperature_soil);
+	}
+
+	// the day columns come first in column_list
+	int no_of_day_columns = 0;
+	for (int i = 0; i < no_of_columns; ++i)
+	{
+		cos_zenith[i] = coszenith(latitude_scalar[i], longitude_scalar[i], BENCHMARK_TIME);
+		if (cos_zenith[i] > 0.0)
+		{
+			column_list[no_of_day_columns] = i;
+			++no_of_day_columns;
+		}
+	}
+	int night_column_counter = no_of_day_columns;
+	for (int i = 0; i < no_of_columns; ++i)
+	{
+		if (cos_zenith[i] <= 0.0)
+		{
+			column_list[night_column_counter] = i;
+			++night_column_counter;
+		}
+	}
+
+	radiation_init(&max_no_of_threads, &sw_full_gpoints, &lw_full_gpoints);
+	printf("Columns: %d (day columns: %d), layers: %d, repetitions: %d, chunk size: %d\n", no_of_columns, no_of_day_columns, no_of_layers, no_of_repetitions, chunk_size);
+	printf("threads\tSW columns/s\tLW columns/s\tSW speedup\tLW speedup\n");
+	double time_sw_single, time_lw_single, time_sw_value, time_lw_value;
+	int no_of_threads = 1;
+	while (no_of_threads <= max_no_of_threads)
+	{
+		omp_set_num_threads(no_of_threads);
+		// the first call of every configuration is not timed, it allocates the workspaces
+		time_sw(no_of_day_columns, no_of_layers, no_of_scalars_h, no_of_vectors_per_layer, chunk_size, 1, column_list, cos_zenith,
+		z_scalar, z_vector, rho, temperature, radiation_tendency_sw, temperature_soil, sfc_sw_in, sfc_albedo);
+		time_sw_value = time_sw(no_of_day_columns, no_of_layers, no_of_scalars_h, no_of_vectors_per_layer, chunk_size, no_of_repetitions, column_list, cos_zenith,
+		z_scalar, z_vector, rho, temperature, radiation_tendency_sw, temperature_soil, sfc_sw_in, sfc_albedo);
+		time_lw(no_of_columns, no_of_layers, no_of_scalars_h, no_of_vectors_per_layer, chunk_size, 1, column_list,
+		z_scalar, z_vector, rho, temperature, radiation_tendency, radiation_tendency_sw, temperature_soil, sfc_lw_out);
+		time_lw_value = time_lw(no_of_columns, no_of_layers, no_of_scalars_h, no_of_vectors_per_layer, chunk_size, no_of_repetitions, column_list,
+		z_scalar, z_vector, rho, temperature, radiation_tendency, radiation_tendency_sw, temperature_soil, sfc_lw_out);
+		if (no_of_threads == 1)
+		{
+			time_sw_single = time_sw_value;
+			time_lw_single = time_lw_value;
+		}
+		printf("%d\t%lf\t%lf\t%lf\t%lf\n", no_of_threads,
+		no_of_day_columns*no_of_repetitions/time_sw_value, no_of_columns*no_of_repetitions/time_lw_value,
+		time_sw_single/time_sw_value, time_lw_single/time_lw_value);
+		// the thread count is doubled, the maximum is always included
+		if (no_of_threads < max_no_of_threads && 2*no_of_threads > max_no_of_threads)
+		{
+			no_of_threads = max_no_of_threads;
+		}
+		else
+		{
+			no_of_threads = 2*no_of_threads;
+		}
+	}
+
+	free(latitude_scalar);
+	free(longitude_scalar);
+	free(sfc_albedo);
+	free(z_scalar);
+	free(z_vector);
+	free(rho);
+	free(temperature);
+	free(temperature_soil);
+	free(radiation_tendency);
+	free(radiation_tendency_sw);
+	free(sfc_sw_in);
+	free(sfc_lw_out);
+	free(cos_zenith);
+	free(column_list);
+	return 0;
+}
+
+double time_sw(int no_of_day_columns, int no_of_layers, int no_of_scalars_h, int no_of_vectors_per_layer, int chunk_size, int no_of_repetitions, int column_list[],
+double cos_zenith[], double z_scalar[], double z_vector[], double rho[], double temperature[], double radiation_tendency_sw[], double temperature_soil[],
+double sfc_sw_in[], double sfc_albedo[])
+{
+	/*
+	This function calls the short wave part of the radiation for the day columns no_of_repetitions times and returns the wall-clock time.
+	*/
+	int no_of_constituents = NO_OF_CONSTITUENTS;
+	int no_of_condensed_constituents = NO_OF_CONDENSED_CONSTITUENTS;
+	int no_of_chunks = (no_of_day_columns + chunk_size - 1)/chunk_size;
+	int first_column, no_of_columns, workspace_index;
+	double begin = omp_get_wtime();
+	for (int repetition = 0; repetition < no_of_repetitions; ++repetition)
+	{
+		#pragma omp parallel for schedule(dynamic, 1) private(first_column, no_of_columns, workspace_index)
+		for (int chunk_index = 0; chunk_index < no_of_chunks; ++chunk_index)
+		{
+			first_column = chunk_index*chunk_size;
+			no_of_columns = chunk_size;
+			if (first_column + no_of_columns > no_of_day_columns)
+			{
+				no_of_columns = no_of_day_columns - first_column;
+			}
+			workspace_index = omp_get_thread_num();
+			calc_sw_flux_convergence(cos_zenith, z_scalar, z_vector, rho, temperature, radiation_tendency_sw, temperature_soil, sfc_sw_in, sfc_albedo,
+			&no_of_scalars_h, &no_of_layers, &no_of_vectors_per_layer, &no_of_constituents, &no_of_condensed_constituents,
+			&column_list[first_column], &no_of_columns, &workspace_index);
+		}
+	}
+	return omp_get_wtime() - begin;
+}
+
+double time_lw(int no_of_columns_total, int no_of_layers, int no_of_scalars_h, int no_of_vectors_per_layer, int chunk_size, int no_of_repetitions, int column_list[],
+double z_scalar[], double z_vector[], double rho[], double temperature[], double radiation_tendency[], double radiation_tendency_sw[], double temperature_soil[],
+double sfc_lw_out[])
+{
+	/*
+	This function calls the long wave part of the radiation for all columns no_of_repetitions times and returns the wall-clock time.
+	*/
+	int no_of_constituents = NO_OF_CONSTITUENTS;
+	int no_of_condensed_constituents = NO_OF_CONDENSED_CONSTITUENTS;
+	int no_of_chunks = (no_of_columns_total + chunk_size - 1)/chunk_size;
+	int first_column, no_of_columns, workspace_index;
+	double begin = omp_get_wtime();
+	for (int repetition = 0; repetition < no_of_repetitions; ++repetition)
+	{
+		#pragma omp parallel for schedule(dynamic, 1) private(first_column, no_of_columns, workspace_index)
+		for (int chunk_index = 0; chunk_index < no_of_chunks; ++chunk_index)
+		{
+			first_column = chunk_index*chunk_size;
+			no_of_columns = chunk_size;
+			if (first_column + no_of_columns > no_of_columns_total)
+			{
+				no_of_columns = no_of_columns_total - first_column;
+			}
+			workspace_index = omp_get_thread_num();
+			calc_lw_flux_convergence(z_scalar, z_vector, rho, temperature, radiation_tendency, radiation_tendency_sw, temperature_soil, sfc_lw_out,
+			&no_of_scalars_h, &no_of_layers, &no_of_vectors_per_layer, &no_of_constituents, &no_of_condensed_constituents,
+			&column_list[first_column], &no_of_columns, &workspace_index);
+		}
+	}
+	return omp_get_wtime() - begin;
+}
+
+int set_synthetic_atmosphere(int no_of_columns, int no_of_layers, int no_of_scalars_h, int no_of_vectors_per_layer,
+double latitude_scalar[], double longitude_scalar[], double sfc_albedo[], double z_scalar[], double z_vector[], double rho[], double temperature[], double temperature_soil[])
+{
+	/*
+	This function sets up a standard atmosphere (ICAO lapse rates) with a moisture profile and a low cloud deck in every third column.
+	The columns are spread evenly over the globe.
+	*/
+	double pressure, z_sfc, sfc_temperature;
+	int i;
+	for (int h_index = 0; h_index < no_of_columns; ++h_index)
+	{
+		// a Fibonacci spiral on the sphere
+		latitude_scalar[h_index] = asin(-1.0 + (2.0*h_index + 1.0)/no_of_columns);
+		longitude_scalar[h_index] = fmod(h_index*M_PI*(3.0 - sqrt(5.0)), 2.0*M_PI);
+		sfc_albedo[h_index] = 0.06 + 0.3*pow(sin(latitude_scalar[h_index]), 4.0);
+		// some orography
+		z_sfc = 500.0*(1.0 + sin(3.0*longitude_scalar[h_index])*cos(latitude_scalar[h_index]));
+		sfc_temperature = 300.0 - 40.0*pow(sin(latitude_scalar[h_index]), 2.0) - 0.0065*z_sfc;
+		for (int level_index = 0; level_index <= no_of_layers; ++level_index)
+		{
+			// the levels are stretched towards the surface
+			z_vector[level_index*no_of_vectors_per_layer + h_index] = z_sfc + (SYNTHETIC_TOA - z_sfc)*pow((double) (no_of_layers - level_index)/no_of_layers, 1.5);
+		}
+		for (int soil_layer_index = 0; soil_layer_index < NO_OF_SOIL_LAYERS; ++soil_layer_index)
+		{
+			temperature_soil[soil_layer_index*no_of_scalars_h + h_index] = sfc_temperature;
+		}
+		for (int layer_index = 0; layer_index < no_of_layers; ++layer_index)
+		{
+			i = layer_index*no_of_scalars_h + h_index;
+			z_scalar[i] = 0.5*(z_vector[layer_index*no_of_vectors_per_layer + h_index] + z_vector[(layer_index + 1)*no_of_vectors_per_layer + h_index]);
+			temperature[i] = fmax(sfc_temperature - 0.0065*(z_scalar[i] - z_sfc), 216.65);
+			pressure = P_0*exp(-z_scalar[i]/8000.0);
+			for (int const_id = 0; const_id < NO_OF_CONSTITUENTS; ++const_id)
+			{
+				rho[const_id*no_of_layers*no_of_scalars_h + i] = 0.0;
+			}
+			// dry air
+			rho[NO_OF_CONDENSED_CONSTITUENTS*no_of_layers*no_of_scalars_h + i] = pressure/(R_D*temperature[i]);
+			if (NO_OF_CONDENSED_CONSTITUENTS == 4)
+			{
+				// water vapour
+				rho[(NO_OF_CONDENSED_CONSTITUENTS + 1)*no_of_layers*no_of_scalars_h + i] = 0.015*cos(latitude_scalar[h_index])*exp(-z_scalar[i]/2000.0);
+				// cloud water and cloud ice
+				if (h_index % 3 == 0 && z_scalar[i] - z_sfc > 1000.0 && z_scalar[i] - z_sfc < 3000.0)
+				{
+					rho[3*no_of_layers*no_of_scalars_h + i] = 2e-4;
+				}
+				if (h_index % 3 == 0 && z_scalar[i] > 8000.0 && z_scalar[i] < 10000.0)
+				{
+					rho[2*no_of_layers*no_of_scalars_h + i] = 2e-5;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+int read_atmosphere(char grid_file[], char init_state_file[], double latitude_scalar[], double longitude_scalar[], double sfc_albedo[],
+double z_scalar[], double z_vector[], double rho[], double temperature[], double temperature_soil[])
+{
+	/*
+	This function reads the model atmosphere from a grid file and an initialization state file.
+	If the soil temperature is not contained in the initialization state file, the temperature of the lowest layer is used.
+	*/
+	int ncid, retval, latitude_scalar_id, longitude_scalar_id, sfc_albedo_id, z_scalar_id, z_vector_id, densities_id, temperature_id, t_soil_id;
+	if ((retval = nc_open(grid_file, NC_NOWRITE, &ncid)))
+		ERR(retval);
+	if ((retval = nc_inq_varid(ncid, "latitude_scalar", &latitude_scalar_id)))
+		ERR(retval);
+	if ((retval = nc_inq_varid(ncid, "longitude_scalar", &longitude_scalar_id)))
+		ERR(retval);
+	if ((retval = nc_inq_varid(ncid, "sfc_albedo", &sfc_albedo_id)))
+		ERR(retval);
+	if ((retval = nc_inq_varid(ncid, "z_scalar", &z_scalar_id)))
+		ERR(retval);
+	if ((retval = nc_inq_varid(ncid, "z_vector", &z_vector_id)))
+		ERR(retval);
+	if ((retval = nc_get_var_double(ncid, latitude_scalar_id, &latitude_scalar[0])))
+		ERR(retval);
+	if ((retval = nc_get_var_double(ncid, longitude_scalar_id, &longitude_scalar[0])))
+		ERR(retval);
+	if ((retval = nc_get_var_double(ncid, sfc_albedo_id, &sfc_albedo[0])))
+		ERR(retval);
+	if ((retval = nc_get_var_double(ncid, z_scalar_id, &z_scalar[0])))
+		ERR(retval);
+	if ((retval = nc_get_var_double(ncid, z_vector_id, &z_vector[0])))
+		ERR(retval);
+	if ((retval = nc_close(ncid)))
+		ERR(retval);
+	if ((retval = nc_open(init_state_file, NC_NOWRITE, &ncid)))
+		ERR(retval);
+	if ((retval = nc_inq_varid(ncid, "densities", &densities_id)))
+		ERR(retval);
+	if ((retval = nc_inq_varid(ncid, "temperature", &temperature_id)))
+		ERR(retval);
+	if ((retval = nc_get_var_double(ncid, densities_id, &rho[0])))
+		ERR(retval);
+	if ((retval = nc_get_var_double(ncid, temperature_id, &temperature[0])))
+		ERR(retval);
+	if (nc_inq_varid(ncid, "t_soil", &t_soil_id) == 0)
+	{
+		if ((retval = nc_get_var_double(ncid, t_soil_id, &temperature_soil[0])))
+			ERR(retval);
+	}
+	else
+	{
+		for (int soil_layer_index = 0; soil_layer_index < NO_OF_SOIL_LAYERS; ++soil_layer_index)
+		{
+			for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+			{
+				temperature_soil[soil_layer_index*NO_OF_SCALARS_H + i] = temperature[NO_OF_SCALARS - NO_OF_SCALARS_H + i];
+			}
+		}
+	}
+	if ((retval = nc_close(ncid)))
+		ERR(retval);
+	return 0;
+}
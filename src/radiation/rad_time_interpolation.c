@@ -0,0 +1,171 @@
+/*
+This source file is part of the Geophysical Fluids Modeling Framework (GAME), which is released under the MIT license.
+Github repository: https://github.com/OpenNWP/GAME
+*/
+
+/*
+In this file, the radiative heating is interpolated in time between two radiation updates.
+The long wave part is extrapolated linearly from the latest two radiation updates, the short wave part is proportional
+to the cosine of the solar zenith angle. Columns which were dark (or almost dark) at the latest update borrow the short wave heating
+per cosine of the zenith angle from the nearest column which was lit, this way columns crossing the sunrise terminator
+between two updates get short wave heating.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../game_types.h"
+#include "../radiation/radiation.h"
+
+int set_rad_sw_donors(Grid *, Forcings *);
+
+// columns with a smaller cosine of the zenith angle at the latest update borrow the short wave heating per cosine from a neighbour (the ratio is unreliable near the terminator)
+const double MIN_RAD_SW_COS_ZENITH = 0.1;
+// the extrapolation of the long wave part never goes further than this times the interval between the latest two radiation updates
+const double MAX_RAD_EXTRAPOL_FACTOR = 1.0;
+
+int store_rad_result(Grid *grid, Forcings *forcings, double time_coordinate)
+{
+	/*
+	This function saves a new radiation result (which has just been written to the forcings) as the latest one.
+	*/
+	if (forcings -> no_of_rad_results > 0)
+	{
+		memcpy(forcings -> rad_tend_lw_old, forcings -> rad_tend_lw, sizeof(Scalar_field));
+		memcpy(forcings -> rad_sfc_lw_out_old, forcings -> rad_sfc_lw_out, NO_OF_SCALARS_H*sizeof(double));
+		forcings -> t_rad_old = forcings -> t_rad;
+	}
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_SCALARS; ++i)
+	{
+		forcings -> rad_tend_sw[i] = forcings -> radiation_tendency_sw[i];
+		forcings -> rad_tend_lw[i] = forcings -> radiation_tendency[i] - forcings -> radiation_tendency_sw[i];
+	}
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		forcings -> rad_sfc_sw_in[i] = forcings -> sfc_sw_in[i];
+		forcings -> rad_sfc_lw_out[i] = forcings -> sfc_lw_out[i];
+		forcings -> rad_cos_zenith[i] = coszenith(grid -> latitude_scalar[i], grid -> longitude_scalar[i], time_coordinate);
+	}
+	set_rad_sw_donors(grid, forcings);
+	forcings -> t_rad = time_coordinate;
+	if (forcings -> no_of_rad_results < 2)
+	{
+		forcings -> no_of_rad_results += 1;
+	}
+	return 0;
+}
+
+int interpolate_radiation_in_time(Grid *grid, Forcings *forcings, double time_coordinate)
+{
+	/*
+	This function sets the radiative heating and the surface fluxes for the given time from the latest two radiation updates.
+	*/
+	if (forcings -> no_of_rad_results == 0)
+	{
+		return 0;
+	}
+	// the long wave part is kept constant until two radiation updates are available
+	double extrapol_factor = 0.0;
+	if (forcings -> no_of_rad_results == 2 && forcings -> t_rad > forcings -> t_rad_old)
+	{
+		extrapol_factor = (time_coordinate - forcings -> t_rad)/(forcings -> t_rad - forcings -> t_rad_old);
+		if (extrapol_factor < 0.0)
+		{
+			extrapol_factor = 0.0;
+		}
+		if (extrapol_factor > MAX_RAD_EXTRAPOL_FACTOR)
+		{
+			extrapol_factor = MAX_RAD_EXTRAPOL_FACTOR;
+		}
+	}
+	double sw_factor;
+	int i, donor;
+	#pragma omp parallel for private(sw_factor, i, donor)
+	for (int h_index = 0; h_index < NO_OF_SCALARS_H; ++h_index)
+	{
+		// the short wave heating is roughly proportional to the cosine of the zenith angle
+		donor = forcings -> rad_sw_donor[h_index];
+		if (donor >= 0)
+		{
+			sw_factor = coszenith(grid -> latitude_scalar[h_index], grid -> longitude_scalar[h_index], time_coordinate)/forcings -> rad_cos_zenith[donor];
+		}
+		// no column was lit at the latest update
+		else
+		{
+			donor = h_index;
+			sw_factor = 0.0;
+		}
+		for (int layer_index = 0; layer_index < NO_OF_LAYERS; ++layer_index)
+		{
+			i = layer_index*NO_OF_SCALARS_H + h_index;
+			forcings -> radiation_tendency_sw[i] = sw_factor*forcings -> rad_tend_sw[layer_index*NO_OF_SCALARS_H + donor];
+			forcings -> radiation_tendency[i] = forcings -> radiation_tendency_sw[i] + forcings -> rad_tend_lw[i]
+			+ extrapol_factor*(forcings -> rad_tend_lw[i] - forcings -> rad_tend_lw_old[i]);
+		}
+		forcings -> sfc_sw_in[h_index] = sw_factor*forcings -> rad_sfc_sw_in[donor];
+		forcings -> sfc_lw_out[h_index] = forcings -> rad_sfc_lw_out[h_index]
+		+ extrapol_factor*(forcings -> rad_sfc_lw_out[h_index] - forcings -> rad_sfc_lw_out_old[h_index]);
+	}
+	return 0;
+}
+
+int set_rad_sw_donors(Grid *grid, Forcings *forcings)
+{
+	/*
+	This function assigns to every column the column whose short wave heating per cosine of the zenith angle is used between two radiation updates.
+	Columns with a sufficiently large cosine of the zenith angle at the latest update are their own donors, the donors grow from them into the remaining columns.
+	*/
+	int *rad_sw_donor_new = malloc(NO_OF_SCALARS_H*sizeof(int));
+	#pragma omp parallel for
+	for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+	{
+		forcings -> rad_sw_donor[i] = -1;
+		if (forcings -> rad_cos_zenith[i] >= MIN_RAD_SW_COS_ZENITH)
+		{
+			forcings -> rad_sw_donor[i] = i;
+		}
+	}
+	int changed_bool = 1;
+	int no_of_edges, vector_index, neighbour, best_donor;
+	while (changed_bool == 1)
+	{
+		changed_bool = 0;
+		#pragma omp parallel for private(no_of_edges, vector_index, neighbour, best_donor) reduction(max:changed_bool)
+		for (int i = 0; i < NO_OF_SCALARS_H; ++i)
+		{
+			best_donor = forcings -> rad_sw_donor[i];
+			if (best_donor == -1)
+			{
+				no_of_edges = 6;
+				if (i < NO_OF_PENTAGONS)
+				{
+					no_of_edges = 5;
+				}
+				for (int j = 0; j < no_of_edges; ++j)
+				{
+					vector_index = grid -> adjacent_vector_indices_h[6*i + j];
+					neighbour = grid -> from_index[vector_index];
+					if (neighbour == i)
+					{
+						neighbour = grid -> to_index[vector_index];
+					}
+					// the lowest index wins to make the result independent of the number of threads
+					if (forcings -> rad_sw_donor[neighbour] >= 0 && (best_donor == -1 || forcings -> rad_sw_donor[neighbour] < best_donor))
+					{
+						best_donor = forcings -> rad_sw_donor[neighbour];
+					}
+				}
+				if (best_donor >= 0)
+				{
+					changed_bool = 1;
+				}
+			}
+			rad_sw_donor_new[i] = best_donor;
+		}
+		memcpy(forcings -> rad_sw_donor, rad_sw_donor_new, NO_OF_SCALARS_H*sizeof(int));
+	}
+	free(rad_sw_donor_new);
+	return 0;
+}
@@ -3,7 +3,21 @@ This source file is part of the Geophysical Fluids Modeling Framework (GAME), wh
 Github repository: https://github.com/OpenNWP/GAME
 */
 
-void radiation_init();
-void calc_radiative_flux_convergence(double [], double [], double [], double [], double [], double [], double [], double [], double [], double [], double [], int *, int *, int *, int *, double *);
-int held_suar(double [], double [], double [], double [], double []);
-int call_radiation(State *, Grid *, Dualgrid *, State *, Diagnostics *, Forcings *, Irreversible_quantities *, Config *, double, double);
+void radiation_init(int *, int *, int *);
+void calc_sw_flux_convergence(double [], double [], double [], double [], double [], double [], double [], double [], double [], int *, int *, int *, int *, int *, int [], int *, int *);
+void calc_lw_flux_convergence(double [], double [], double [], double [], double [], double [], double [], double [], int *, int *, int *, int *, int *, int [], int *, int *);
+int held_suar(double [], double [], double [], double [], int, int);
+int call_radiation(State *, Grid *, Radiation_grid *, Dualgrid *, State *, Diagnostics *, Forcings *, Irreversible_quantities *, Config *, double, double);
+int start_async_radiation(State *, Grid *, Radiation_grid *, Diagnostics *, Async_radiation *, Config *, double);
+int finish_async_radiation(Async_radiation *, Forcings *);
+int async_radiation_finished(Async_radiation *, Forcings *);
+int get_rad_chunk_size(Config *, int);
+int get_no_of_rad_workspaces(Config *);
+int print_rad_global_means(Grid *, Forcings *);
+int upscale_scalar_point(int, int, int *);
+int set_radiation_grid(Grid *, Config *, Radiation_grid *);
+int coarsen_rad_input(double [], double [], double [], Grid *, Radiation_grid *);
+int remap_rad_output(Radiation_grid *, double [], double [], double [], double []);
+double coszenith(double, double, double);
+int store_rad_result(Grid *, Forcings *, double);
+int interpolate_radiation_in_time(Grid *, Forcings *, double);
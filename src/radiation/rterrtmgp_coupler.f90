@@ -40,11 +40,17 @@ module radiation
    /)
   
   character(len = *),parameter :: rrtmgp_coefficients_file_sw = &
-  ! insert the name of the short wave data file here
+  ! insert the name of the reduced short wave data file here
   "/home/max/code/rte-rrtmgp/rrtmgp/data/rrtmgp-data-sw-g112-210809.nc"
+  character(len = *),parameter :: rrtmgp_coefficients_file_sw_full = &
+  ! insert the name of the full short wave data file here
+  "/home/max/code/rte-rrtmgp/rrtmgp/data/rrtmgp-data-sw-g224-210809.nc"
   character(len = *),parameter :: rrtmgp_coefficients_file_lw = &
-  ! insert the name of the long wave data file here
+  ! insert the name of the reduced long wave data file here
   "/home/max/code/rte-rrtmgp/rrtmgp/data/rrtmgp-data-lw-g128-210809.nc"
+  character(len = *),parameter :: rrtmgp_coefficients_file_lw_full = &
+  ! insert the name of the full long wave data file here
+  "/home/max/code/rte-rrtmgp/rrtmgp/data/rrtmgp-data-lw-g256-210809.nc"
   character(len = *),parameter :: cloud_coefficients_file_sw = &
   ! insert the name of the short wave cloud optics file here
   "/home/max/code/rte-rrtmgp/extensions/cloud_optics/rrtmgp-cloud-optics-coeffs-sw.nc"
@@ -53,6 +59,39 @@ module radiation
   "/home/max/code/rte-rrtmgp/extensions/cloud_optics/rrtmgp-cloud-optics-coeffs-lw.nc"
   ! the gases in lowercase
   character(len = 32),dimension(size(active_gases)) :: gases_lowercase
+  ! the spectral properties of the gas phase (read-only after radiation_init)
+  type(ty_gas_optics_rrtmgp)                        :: k_dist_sw,k_dist_lw
+  ! the spectral properties of the clouds (read-only after radiation_init)
+  type(ty_cloud_optics)                             :: cloud_optics_sw,cloud_optics_lw
+  
+  ! everything a thread needs for the radiation calculation, allocated once and reused in every call
+  type t_radiation_workspace
+    ! the gas concentrations (object holding all information on the composition
+    ! of the gas phase)
+    type(ty_gas_concs)                    :: gas_concentrations_sw
+    type(ty_gas_concs)                    :: gas_concentrations_lw
+    ! the resulting fluxes (pointing to the flux arrays below)
+    type(ty_fluxes_broadband)             :: fluxes_sw,fluxes_lw
+    ! short wave optical properties
+    type(ty_optical_props_2str)           :: atmos_props_sw,cloud_props_sw
+    ! long wave optical properties
+    type(ty_optical_props_1scl)           :: atmos_props_lw,cloud_props_lw
+    ! long wave source function
+    type(ty_source_func_lw)               :: sources_lw
+    ! top of atmosphere short wave flux
+    real(wp), allocatable                 :: toa_flux(:,:)
+    ! storage of the fluxes
+    real(wp), allocatable                 :: flux_up_sw(:,:),flux_dn_sw(:,:),flux_net_sw(:,:)
+    real(wp), allocatable                 :: flux_up_lw(:,:),flux_dn_lw(:,:),flux_net_lw(:,:)
+    ! the number of columns the flux arrays can take
+    integer                               :: max_no_of_columns = 0
+    ! the numbers of columns the optical properties are currently allocated for
+    integer                               :: no_of_columns_sw = 0
+    integer                               :: no_of_columns_lw = 0
+  end type t_radiation_workspace
+  
+  ! one workspace per thread
+  type(t_radiation_workspace), allocatable, target :: workspaces(:)
   
   ! interface to C functions
   interface
@@ -75,208 +114,478 @@ module radiation
   
   contains
   
-  subroutine radiation_init() &
+  subroutine radiation_init(no_of_workspaces,sw_full_gpoints,lw_full_gpoints) &
   bind(c,name = "radiation_init")
-    ! This is called only once, in the beginning.
+    ! This is called only once, in the beginning. It reads the spectral properties of the gases and the clouds,
+    ! which are then shared by all radiation calls, and sets up the workspaces of the threads.
+    
+    ! the number of threads that may call the radiation at the same time
+    integer, intent(in) :: no_of_workspaces
+    ! 1: full short wave k-distribution, 0: reduced short wave k-distribution (fewer g-points)
+    integer, intent(in) :: sw_full_gpoints
+    ! 1: full long wave k-distribution, 0: reduced long wave k-distribution (fewer g-points)
+    integer, intent(in) :: lw_full_gpoints
     
     ! local variables
     ! loop index
-    integer :: ji
+    integer            :: ji
+    ! the gas concentrations object, only used for defining the available gases
+    type(ty_gas_concs) :: available_gases
     
     ! formatting the gas names
     do ji=1,size(active_gases)
       gases_lowercase(ji) = trim(lower_case(active_gases(ji)))
     end do
     
+    ! here, the names of the gases are written to the gas_concentrations object
+    call handle_error(available_gases%init(gases_lowercase))
+    
+    ! loading the short wave radiation properties
+    if (sw_full_gpoints==1) then
+      call load_and_init(k_dist_sw,trim(rrtmgp_coefficients_file_sw_full),available_gases)
+    else
+      call load_and_init(k_dist_sw,trim(rrtmgp_coefficients_file_sw),available_gases)
+    endif
+    ! loading the long wave radiation properties
+    if (lw_full_gpoints==1) then
+      call load_and_init(k_dist_lw,trim(rrtmgp_coefficients_file_lw_full),available_gases)
+    else
+      call load_and_init(k_dist_lw,trim(rrtmgp_coefficients_file_lw),available_gases)
+    endif
+    write(*,*) "Number of short wave g-points:",k_dist_sw%get_ngpt()
+    write(*,*) "Number of long wave g-points:",k_dist_lw%get_ngpt()
+    
+    ! reading the SW spectral properties of clouds
+    call load_cld_lutcoeff(cloud_optics_sw,trim(cloud_coefficients_file_sw))
+    
+    ! reading the LW spectral properties of clouds
+    call load_cld_lutcoeff(cloud_optics_lw,trim(cloud_coefficients_file_lw))
+    
+    ! the parts of the workspaces which do not depend on the number of columns
+    allocate(workspaces(no_of_workspaces))
+    do ji=1,no_of_workspaces
+      call handle_error(workspaces(ji)%gas_concentrations_sw%init(gases_lowercase))
+      call handle_error(workspaces(ji)%gas_concentrations_lw%init(gases_lowercase))
+      call handle_error(workspaces(ji)%cloud_props_sw%init(k_dist_sw%get_band_lims_wavenumber()))
+      call handle_error(workspaces(ji)%cloud_props_lw%init(k_dist_lw%get_band_lims_wavenumber()))
+    enddo
+    
   end subroutine radiation_init
   
-  subroutine calc_radiative_flux_convergence(latitude_scalar,longitude_scalar, &
+  subroutine calc_sw_flux_convergence(cos_zenith, &
   z_scalar,z_vector, &
-  mass_densities,temperature_gas,radiation_tendency, &
-  temp_sfc,sfc_sw_in,sfc_lw_out,sfc_albedo, &
-  no_of_scalars,no_of_layers,no_of_constituents,no_of_condensed_constituents, &
-  time_coord) &
+  mass_densities,temperature_gas,radiation_tendency_sw, &
+  temp_sfc,sfc_sw_in,sfc_albedo, &
+  no_of_scalars_h,no_of_layers,no_of_vectors_per_layer,no_of_constituents,no_of_condensed_constituents, &
+  column_indices_c,no_of_columns,workspace_index) &
   
-    ! This is the function that is called by the dynamical core. The dycore hands over
-    ! the thermodynamic state as well as meta data (time stamp, coordinates) and gets
-    ! back radiative flux convergences in W/m^3.
+    ! This is the short wave part of the radiation, which is called by the dynamical core for day columns only.
+    ! The fields are the ones of the whole model grid (no copies), the calculation is done for the columns
+    ! listed in column_indices_c (C indices, starting from zero). The short wave result is written to radiation_tendency_sw.
   
-    bind(c,name = "calc_radiative_flux_convergence")
+    bind(c,name = "calc_sw_flux_convergence")
     
-    ! the number of scalar points of the model grid
-    integer, intent(in)                :: no_of_scalars
+    ! the number of columns of the model grid
+    integer, intent(in)                :: no_of_scalars_h
     ! the number of layers of the model grid
     integer, intent(in)                :: no_of_layers
+    ! the number of vector points per layer of the model grid (the stride of the vertical vector points)
+    integer, intent(in)                :: no_of_vectors_per_layer
     ! the number of constituents of the model atmosphere
     integer, intent(in)                :: no_of_constituents
     ! the numer of condensed constituents of the model atmosphere
     integer, intent(in)                :: no_of_condensed_constituents
-    ! the time coordinate (UTC time stamp)
-    real(wp)                          :: time_coord
-    ! the latitude coordinates of the scalar data points
-    real(wp), intent(in)               :: latitude_scalar(no_of_scalars/no_of_layers)
-    ! the longitude coordinates of the scalar data points
-    real(wp), intent(in)               :: longitude_scalar(no_of_scalars/no_of_layers)
+    ! the number of columns to work on
+    integer, intent(in)                :: no_of_columns
+    ! the indices of the columns to work on (C indices)
+    integer, intent(in)                :: column_indices_c(no_of_columns)
+    ! the index of the workspace to use (the thread number, starting from zero)
+    integer, intent(in)                :: workspace_index
+    ! the cosine of the solar zenith angle (positive in all columns handed over)
+    real(wp), intent(in)               :: cos_zenith(no_of_scalars_h)
     ! the vertical positions of the scalar data points
-    real(wp), intent(in)               :: z_scalar(no_of_scalars)
+    real(wp), intent(in)               :: z_scalar(no_of_scalars_h,no_of_layers)
     ! the vertical positions of the vector data points
-    real(wp), intent(in)               :: z_vector(no_of_scalars+no_of_scalars/no_of_layers)
+    real(wp), intent(in)               :: z_vector(no_of_layers*no_of_vectors_per_layer+no_of_scalars_h)
     ! the mass densities of the model atmosphere
-    real(wp), intent(in)               :: mass_densities &
-    (no_of_constituents*no_of_scalars)
+    real(wp), intent(in)               :: mass_densities(no_of_scalars_h,no_of_layers,no_of_constituents)
     ! the temperature of the model atmosphere
-    real(wp), intent(in)               :: temperature_gas(no_of_scalars)
-    ! the result (in W/m^3)
-    real(wp), intent(inout)            :: radiation_tendency(no_of_scalars)
+    real(wp), intent(in)               :: temperature_gas(no_of_scalars_h,no_of_layers)
+    ! the short wave result (in W/m^3)
+    real(wp), intent(inout)            :: radiation_tendency_sw(no_of_scalars_h,no_of_layers)
     ! surface temperature
-    real(wp), intent(in)               :: temp_sfc(no_of_scalars/no_of_layers)
+    real(wp), intent(in)               :: temp_sfc(no_of_scalars_h)
     ! surface shortwave in
-    real(wp), intent(inout)            :: sfc_sw_in(no_of_scalars/no_of_layers)
-    ! surface longwave out
-    real(wp), intent(inout)            :: sfc_lw_out(no_of_scalars/no_of_layers)
+    real(wp), intent(inout)            :: sfc_sw_in(no_of_scalars_h)
     ! surface albedo for all bands
-    real(wp), intent(in)               :: sfc_albedo(no_of_scalars/no_of_layers)
+    real(wp), intent(in)               :: sfc_albedo(no_of_scalars_h)
     
     ! local variables
-    ! the gas concentrations (object holding all information on the composition
-    ! of the gas phase)
-    type(ty_gas_concs)                :: gas_concentrations_sw
-    type(ty_gas_concs)                :: gas_concentrations_lw
-    ! the spectral properties of the gas phase
-    type(ty_gas_optics_rrtmgp)        :: k_dist_sw,k_dist_lw
-    ! the spectral properties of the clouds
-    type(ty_cloud_optics)             :: cloud_optics_sw,cloud_optics_lw
+    ! the workspace of this thread
+    type(t_radiation_workspace), pointer :: ws
+    ! loop indices
+    integer                           :: ji,jk
+    ! the indices of the columns in the model grid
+    integer                           :: column_indices(no_of_columns)
     ! solar zenith angle
-    real(wp)                          :: mu_0(no_of_scalars/no_of_layers)
-    ! number of points where it is day
-    integer                           :: no_of_day_points
-    ! loop indices and helper variables
-    integer                           :: ji,j_day,jk,base_index
-    ! the indices of columns where it is day
-    integer                           :: day_indices(no_of_scalars/no_of_layers)
-    ! number of scalars per layer (number of columns)
-    integer                           :: no_of_scalars_h
-    ! the resulting fluxes
-    type(ty_fluxes_broadband)         :: fluxes,fluxes_day
-    ! short wave optical properties
-    type(ty_optical_props_2str)       :: atmos_props_sw,cloud_props_sw
-    ! long wave optical properties
-    type(ty_optical_props_1scl)       :: atmos_props_lw,cloud_props_lw
-    ! top of atmosphere short wave flux
-    real(wp), dimension(:,:), allocatable          :: toa_flux ! no_of_day_points,no_of_sw_g_points
-    ! long wave source function
-    type(ty_source_func_lw)           :: sources_lw
-    ! the surface emissivity
-    real(wp)                          :: surface_emissivity(no_of_lw_bands,no_of_scalars/no_of_layers)
+    real(wp)                          :: mu_0(no_of_columns)
     ! surface albedo for direct radiation
-    real(wp)                          :: albedo_dir(no_of_sw_bands,no_of_scalars/no_of_layers)
+    real(wp)                          :: albedo_dir(no_of_sw_bands,no_of_columns)
     ! surface albedo for diffusive radiation
-    real(wp)                          :: albedo_dif(no_of_sw_bands,no_of_scalars/no_of_layers)
-    ! surface albedo for direct radiation (day points only)
-    real(wp)                          :: albedo_dir_day(no_of_sw_bands,no_of_scalars/no_of_layers)
-    ! surface albedo for diffusive radiation (day points only)
-    real(wp)                          :: albedo_dif_day(no_of_sw_bands,no_of_scalars/no_of_layers)
-    ! solar zenith angle (day points only)
-    real(wp)                          :: mu_0_day(no_of_scalars/no_of_layers)
-    ! temperature at the surface (day points only)
-    real(wp)                          :: temp_sfc_day(no_of_scalars/no_of_layers)
+    real(wp)                          :: albedo_dif(no_of_sw_bands,no_of_columns)
+    ! temperature at the surface
+    real(wp)                          :: temp_sfc_rad(no_of_columns)
+    ! reformatted temperature field
+    real(wp)                          :: temperature_rad(no_of_columns,no_of_layers)
+    ! reformatted pressure field
+    real(wp)                          :: pressure_rad(no_of_columns,no_of_layers)
+    ! pressure at cell interfaces
+    real(wp)                          :: pressure_interface_rad(no_of_columns,no_of_layers+1)
+    ! temperature at cell interfaces
+    real(wp)                          :: temperature_interface_rad(no_of_columns,no_of_layers+1)
+    ! liquid water path in g/m^2
+    real(wp)                          :: liquid_water_path(no_of_columns,no_of_layers)
+    ! ice water path g/m^2
+    real(wp)                          :: ice_water_path(no_of_columns,no_of_layers)
+    ! liquid particles effective radius in micro meters 
+    real(wp)                          :: liquid_eff_radius(no_of_columns,no_of_layers)
+    ! ice particles effective radius in micro meters 
+    real(wp)                          :: ice_eff_radius(no_of_columns,no_of_layers)
+    
+    ! some general preparations
+    
+    ws => workspaces(workspace_index+1)
+    
+    ! making sure the flux arrays of the workspace are large enough
+    call prepare_workspace(ws,no_of_columns,no_of_layers)
+    
+    ! the indices of the columns in the model grid
+    do ji=1,no_of_columns
+      column_indices(ji) = column_indices_c(ji)+1
+      mu_0(ji) = cos_zenith(column_indices(ji))
+      albedo_dir(:,ji) = sfc_albedo(column_indices(ji))
+      albedo_dif(:,ji) = sfc_albedo(column_indices(ji))
+    enddo
+    
+    ! reformatting the model state for RTE+RRTMGP
+    call prepare_columns(z_scalar,z_vector,mass_densities,temperature_gas,temp_sfc, &
+    no_of_scalars_h,no_of_layers,no_of_vectors_per_layer,no_of_constituents,no_of_condensed_constituents, &
+    column_indices,no_of_columns,temp_sfc_rad,temperature_rad,pressure_rad,pressure_interface_rad, &
+    temperature_interface_rad,liquid_water_path,ice_water_path,liquid_eff_radius,ice_eff_radius)
+    
+    ! allocating the short wave optical properties (only if the number of columns has changed),
+    ! the gas concentrations are initialized again because set_vmr only accepts the number of columns of the first call after init
+    if (ws%no_of_columns_sw/=no_of_columns) then
+      call handle_error(ws%gas_concentrations_sw%init(gases_lowercase))
+      call handle_error(ws%atmos_props_sw%alloc_2str(no_of_columns,no_of_layers,k_dist_sw))
+      call handle_error(ws%cloud_props_sw%alloc_2str(no_of_columns,no_of_layers))
+      ws%no_of_columns_sw = no_of_columns
+    endif
+    
+    ! setting the volume mixing ratios of the gases for the short wave calculation
+    call set_vol_mix_ratios(mass_densities,z_scalar,column_indices,no_of_columns,no_of_scalars_h, &
+    no_of_layers,no_of_constituents,no_of_condensed_constituents,ws%gas_concentrations_sw)
+    
+    ! pointing the short wave fluxes to the storage of the workspace
+    call set_fluxes(ws%fluxes_sw,ws%flux_up_sw,ws%flux_dn_sw,ws%flux_net_sw,no_of_columns)
+    
+    ! setting the short wave optical properties of the gas phase
+    call handle_error(k_dist_sw%gas_optics(pressure_rad, &
+                                           pressure_interface_rad, &
+                                           temperature_rad, &
+                                           ws%gas_concentrations_sw, &
+                                           ws%atmos_props_sw, &
+                                           ws%toa_flux(1:no_of_columns,:)))
+    
+    ! calculating the SW properties of the clouds
+    call handle_error(cloud_optics_sw%cloud_optics(liquid_water_path, &
+                                                   ice_water_path, &
+                                                   liquid_eff_radius, &
+                                                   ice_eff_radius, &
+                                                   ws%cloud_props_sw))
+    
+    ! this seems to have to do with scattering
+    call handle_error(ws%cloud_props_sw%delta_scale())
+    
+    ! adding the SW cloud properties to the gas properties to obtain the atmosphere's properties
+    call handle_error(ws%cloud_props_sw%increment(ws%atmos_props_sw))
+    
+    ! calculate shortwave radiative fluxes
+    call handle_error(rte_sw(ws%atmos_props_sw, &
+                             .true., &
+                             mu_0, &
+                             ws%toa_flux(1:no_of_columns,:), &
+                             albedo_dir, &
+                             albedo_dif, &
+                             ws%fluxes_sw))
+    
+    ! short wave result (in Wm^-3)
+    do jk=1,no_of_layers
+      do ji=1,no_of_columns
+        radiation_tendency_sw(column_indices(ji),jk) = 0._wp
+      enddo
+    enddo
+    call calc_power_density(no_of_scalars_h,no_of_layers,no_of_vectors_per_layer, &
+    no_of_columns,column_indices,ws%fluxes_sw,z_vector,radiation_tendency_sw)
+    
+    ! saving the surface shortwave inward radiative flux density
+    do ji=1,no_of_columns
+      sfc_sw_in(column_indices(ji)) = ws%fluxes_sw%flux_dn(ji,no_of_layers+1) &
+      - ws%fluxes_sw%flux_up(ji,no_of_layers+1)
+    enddo
+    
+  end subroutine calc_sw_flux_convergence
+  
+  subroutine calc_lw_flux_convergence(z_scalar,z_vector, &
+  mass_densities,temperature_gas,radiation_tendency,radiation_tendency_sw, &
+  temp_sfc,sfc_lw_out, &
+  no_of_scalars_h,no_of_layers,no_of_vectors_per_layer,no_of_constituents,no_of_condensed_constituents, &
+  column_indices_c,no_of_columns,workspace_index) &
+  
+    ! This is the long wave part of the radiation, which is called by the dynamical core for all columns
+    ! after the short wave part. The fields are the ones of the whole model grid (no copies), the calculation is done
+    ! for the columns listed in column_indices_c (C indices, starting from zero). radiation_tendency is set to
+    ! the sum of the short wave result and the long wave result.
+  
+    bind(c,name = "calc_lw_flux_convergence")
+    
+    ! the number of columns of the model grid
+    integer, intent(in)                :: no_of_scalars_h
+    ! the number of layers of the model grid
+    integer, intent(in)                :: no_of_layers
+    ! the number of vector points per layer of the model grid (the stride of the vertical vector points)
+    integer, intent(in)                :: no_of_vectors_per_layer
+    ! the number of constituents of the model atmosphere
+    integer, intent(in)                :: no_of_constituents
+    ! the numer of condensed constituents of the model atmosphere
+    integer, intent(in)                :: no_of_condensed_constituents
+    ! the number of columns to work on
+    integer, intent(in)                :: no_of_columns
+    ! the indices of the columns to work on (C indices)
+    integer, intent(in)                :: column_indices_c(no_of_columns)
+    ! the index of the workspace to use (the thread number, starting from zero)
+    integer, intent(in)                :: workspace_index
+    ! the vertical positions of the scalar data points
+    real(wp), intent(in)               :: z_scalar(no_of_scalars_h,no_of_layers)
+    ! the vertical positions of the vector data points
+    real(wp), intent(in)               :: z_vector(no_of_layers*no_of_vectors_per_layer+no_of_scalars_h)
+    ! the mass densities of the model atmosphere
+    real(wp), intent(in)               :: mass_densities(no_of_scalars_h,no_of_layers,no_of_constituents)
+    ! the temperature of the model atmosphere
+    real(wp), intent(in)               :: temperature_gas(no_of_scalars_h,no_of_layers)
+    ! the result (in W/m^3)
+    real(wp), intent(inout)            :: radiation_tendency(no_of_scalars_h,no_of_layers)
+    ! the short wave part of the result (in W/m^3)
+    real(wp), intent(in)               :: radiation_tendency_sw(no_of_scalars_h,no_of_layers)
+    ! surface temperature
+    real(wp), intent(in)               :: temp_sfc(no_of_scalars_h)
+    ! surface longwave out
+    real(wp), intent(inout)            :: sfc_lw_out(no_of_scalars_h)
+    
+    ! local variables
+    ! the workspace of this thread
+    type(t_radiation_workspace), pointer :: ws
+    ! loop indices
+    integer                           :: ji,jk
+    ! the indices of the columns in the model grid
+    integer                           :: column_indices(no_of_columns)
+    ! the surface emissivity
+    real(wp)                          :: surface_emissivity(no_of_lw_bands,no_of_columns)
+    ! temperature at the surface
+    real(wp)                          :: temp_sfc_rad(no_of_columns)
     ! reformatted temperature field
-    real(wp)                          :: temperature_rad(no_of_scalars/no_of_layers,no_of_layers)
+    real(wp)                          :: temperature_rad(no_of_columns,no_of_layers)
     ! reformatted pressure field
-    real(wp)                          :: pressure_rad(no_of_scalars/no_of_layers,no_of_layers)
+    real(wp)                          :: pressure_rad(no_of_columns,no_of_layers)
     ! pressure at cell interfaces
-    real(wp)                          :: pressure_interface_rad(no_of_scalars/no_of_layers,no_of_layers+1)
+    real(wp)                          :: pressure_interface_rad(no_of_columns,no_of_layers+1)
     ! temperature at cell interfaces
-    real(wp)                          :: temperature_interface_rad (no_of_scalars/no_of_layers,no_of_layers+1)
-    ! temperature at cells restricted to day points
-    real(wp)                          :: temperature_rad_day(no_of_scalars/no_of_layers,no_of_layers)
-    ! pressure at cells restricted to day points
-    real(wp)                          :: pressure_rad_day(no_of_scalars/no_of_layers,no_of_layers)
-    ! pressure at cell interfaces restricted to day points
-    real(wp)                          :: pressure_interface_rad_day(no_of_scalars/no_of_layers,no_of_layers+1)
+    real(wp)                          :: temperature_interface_rad(no_of_columns,no_of_layers+1)
     ! liquid water path in g/m^2
-    real(wp)                          :: liquid_water_path(no_of_scalars/no_of_layers,no_of_layers)
+    real(wp)                          :: liquid_water_path(no_of_columns,no_of_layers)
     ! ice water path g/m^2
-    real(wp)                          :: ice_water_path(no_of_scalars/no_of_layers,no_of_layers)
+    real(wp)                          :: ice_water_path(no_of_columns,no_of_layers)
     ! liquid particles effective radius in micro meters 
-    real(wp)                          :: liquid_eff_radius(no_of_scalars/no_of_layers,no_of_layers)
+    real(wp)                          :: liquid_eff_radius(no_of_columns,no_of_layers)
     ! ice particles effective radius in micro meters 
-    real(wp)                          :: ice_eff_radius(no_of_scalars/no_of_layers,no_of_layers)
-    ! liquid water path in g/m^2 restricted to the day points
-    real(wp)                          :: liquid_water_path_day(no_of_scalars/no_of_layers,no_of_layers)
-    ! ice water path in g/m^2 restricted to the day points
-    real(wp)                          :: ice_water_path_day(no_of_scalars/no_of_layers,no_of_layers)
-    ! liquid particles effective radius in micro meters restricted to the day points
-    real(wp)                          :: liquid_eff_radius_day(no_of_scalars/no_of_layers,no_of_layers)
-    ! ice particles effective radius in micro meters restricted to the day points
-    real(wp)                          :: ice_eff_radius_day(no_of_scalars/no_of_layers,no_of_layers)
+    real(wp)                          :: ice_eff_radius(no_of_columns,no_of_layers)
+    
+    ! some general preparations
+    
+    ws => workspaces(workspace_index+1)
+    
+    ! making sure the flux arrays of the workspace are large enough
+    call prepare_workspace(ws,no_of_columns,no_of_layers)
+    
+    ! the indices of the columns in the model grid
+    do ji=1,no_of_columns
+      column_indices(ji) = column_indices_c(ji)+1
+    enddo
+    
+    ! set the surface emissivity (a longwave property) to a standard value
+    surface_emissivity(:,:) = 0.98_wp
+    
+    ! reformatting the model state for RTE+RRTMGP
+    call prepare_columns(z_scalar,z_vector,mass_densities,temperature_gas,temp_sfc, &
+    no_of_scalars_h,no_of_layers,no_of_vectors_per_layer,no_of_constituents,no_of_condensed_constituents, &
+    column_indices,no_of_columns,temp_sfc_rad,temperature_rad,pressure_rad,pressure_interface_rad, &
+    temperature_interface_rad,liquid_water_path,ice_water_path,liquid_eff_radius,ice_eff_radius)
+    
+    ! allocating the long wave optical properties and the source function (only if the number of columns has changed),
+    ! the gas concentrations are initialized again because set_vmr only accepts the number of columns of the first call after init
+    if (ws%no_of_columns_lw/=no_of_columns) then
+      call handle_error(ws%gas_concentrations_lw%init(gases_lowercase))
+      call handle_error(ws%atmos_props_lw%alloc_1scl(no_of_columns,no_of_layers,k_dist_lw))
+      call handle_error(ws%cloud_props_lw%alloc_1scl(no_of_columns,no_of_layers))
+      call handle_error(ws%sources_lw%alloc(no_of_columns,no_of_layers,k_dist_lw))
+      ws%no_of_columns_lw = no_of_columns
+    endif
+    
+    ! setting the volume mixing ratios of the gases for the long wave calculation
+    call set_vol_mix_ratios(mass_densities,z_scalar,column_indices,no_of_columns,no_of_scalars_h, &
+    no_of_layers,no_of_constituents,no_of_condensed_constituents,ws%gas_concentrations_lw)
+    
+    ! pointing the long wave fluxes to the storage of the workspace
+    call set_fluxes(ws%fluxes_lw,ws%flux_up_lw,ws%flux_dn_lw,ws%flux_net_lw,no_of_columns)
+    
+    ! setting the long wave optical properties of the gas phase
+    call handle_error(k_dist_lw%gas_optics(pressure_rad, &
+                                           pressure_interface_rad, &
+                                           temperature_rad, &
+                                           temp_sfc_rad, &
+                                           ws%gas_concentrations_lw, &
+                                           ws%atmos_props_lw, &
+                                           ws%sources_lw, &
+                                           tlev = temperature_interface_rad))
+    
+    ! calculating the LW properties of the clouds
+    call handle_error(cloud_optics_lw%cloud_optics(liquid_water_path, &
+                                                   ice_water_path, &
+                                                   liquid_eff_radius, &
+                                                   ice_eff_radius, &
+                                                   ws%cloud_props_lw))
+    
+    ! adding the LW cloud properties to the gas properties to obtain the atmosphere's properties
+    call handle_error(ws%cloud_props_lw%increment(ws%atmos_props_lw))
+    
+    ! calculate longwave radiative fluxes
+    call handle_error(rte_lw(ws%atmos_props_lw, &
+                             .true., &
+                             ws%sources_lw, &
+                             surface_emissivity, &
+                             ws%fluxes_lw))
+    
+    ! the short wave result has been computed before
+    do jk=1,no_of_layers
+      do ji=1,no_of_columns
+        radiation_tendency(column_indices(ji),jk) = radiation_tendency_sw(column_indices(ji),jk)
+      enddo
+    enddo
+   
+    ! add long wave result (in Wm^-3)
+    call calc_power_density(no_of_scalars_h,no_of_layers,no_of_vectors_per_layer, &
+    no_of_columns,column_indices,ws%fluxes_lw,z_vector,radiation_tendency)
+    
+    ! saving the surface longwave outward radiative flux density
+    do ji=1,no_of_columns
+      sfc_lw_out(column_indices(ji)) = ws%fluxes_lw%flux_up(ji,no_of_layers+1) &
+      - ws%fluxes_lw%flux_dn(ji,no_of_layers+1)
+    enddo
+    
+  end subroutine calc_lw_flux_convergence
+  
+  subroutine prepare_columns(z_scalar,z_vector,mass_densities,temperature_gas,temp_sfc, &
+  no_of_scalars_h,no_of_layers,no_of_vectors_per_layer,no_of_constituents,no_of_condensed_constituents, &
+  column_indices,no_of_columns,temp_sfc_rad,temperature_rad,pressure_rad,pressure_interface_rad, &
+  temperature_interface_rad,liquid_water_path,ice_water_path,liquid_eff_radius,ice_eff_radius)
+  
+    ! reformats the thermodynamic state and the clouds of the given columns for RTE+RRTMGP
+    
+    ! as usual
+    integer,  intent(in)  :: no_of_scalars_h
+    ! as usual
+    integer,  intent(in)  :: no_of_layers
+    ! as usual
+    integer,  intent(in)  :: no_of_vectors_per_layer
+    ! as usual
+    integer,  intent(in)  :: no_of_constituents
+    ! as usual
+    integer,  intent(in)  :: no_of_condensed_constituents
+    ! the number of columns to work on
+    integer,  intent(in)  :: no_of_columns
+    ! the indices of the columns in the model grid
+    integer,  intent(in)  :: column_indices(no_of_columns)
+    ! the vertical positions of the scalar data points
+    real(wp), intent(in)  :: z_scalar(no_of_scalars_h,no_of_layers)
+    ! the vertical positions of the vector data points
+    real(wp), intent(in)  :: z_vector(no_of_layers*no_of_vectors_per_layer+no_of_scalars_h)
+    ! the mass densities of the model atmosphere
+    real(wp), intent(in)  :: mass_densities(no_of_scalars_h,no_of_layers,no_of_constituents)
+    ! the temperature of the model atmosphere
+    real(wp), intent(in)  :: temperature_gas(no_of_scalars_h,no_of_layers)
+    ! surface temperature
+    real(wp), intent(in)  :: temp_sfc(no_of_scalars_h)
+    ! temperature at the surface
+    real(wp), intent(out) :: temp_sfc_rad(no_of_columns)
+    ! reformatted temperature field
+    real(wp), intent(out) :: temperature_rad(no_of_columns,no_of_layers)
+    ! reformatted pressure field
+    real(wp), intent(out) :: pressure_rad(no_of_columns,no_of_layers)
+    ! pressure at cell interfaces
+    real(wp), intent(out) :: pressure_interface_rad(no_of_columns,no_of_layers+1)
+    ! temperature at cell interfaces
+    real(wp), intent(out) :: temperature_interface_rad(no_of_columns,no_of_layers+1)
+    ! liquid water path in g/m^2
+    real(wp), intent(out) :: liquid_water_path(no_of_columns,no_of_layers)
+    ! ice water path g/m^2
+    real(wp), intent(out) :: ice_water_path(no_of_columns,no_of_layers)
+    ! liquid particles effective radius in micro meters 
+    real(wp), intent(out) :: liquid_eff_radius(no_of_columns,no_of_layers)
+    ! ice particles effective radius in micro meters 
+    real(wp), intent(out) :: ice_eff_radius(no_of_columns,no_of_layers)
+    
+    ! local variables
+    ! loop indices
+    integer               :: ji,jk,jc
     ! scale height of the atmosphere
-    real(wp)                          :: scale_height = 8.e3_wp
+    real(wp)              :: scale_height = 8.e3_wp
     ! representative value of liquid particle radius
-    real(wp)                          :: liquid_eff_radius_value
+    real(wp)              :: liquid_eff_radius_value
     ! representative value of ice particle radius
-    real(wp)                          :: ice_eff_radius_value
+    real(wp)              :: ice_eff_radius_value
     ! layer thickness
-    real(wp)                          :: thickness
+    real(wp)              :: thickness
     ! ice precipitation particles radius
-    real(wp)                          :: ice_precip_radius
+    real(wp)              :: ice_precip_radius
     ! liquid precipitation particles radius
-    real(wp)                          :: liquid_precip_radius
+    real(wp)              :: liquid_precip_radius
     ! ice cloud particles radius
-    real(wp)                          :: ice_cloud_radius
+    real(wp)              :: ice_cloud_radius
     ! liquid cloud particles radius
-    real(wp)                          :: liquid_cloud_radius
+    real(wp)              :: liquid_cloud_radius
     ! ice precipitation particles weight
-    real(wp)                          :: ice_precip_weight
+    real(wp)              :: ice_precip_weight
     ! liquid precipitation particles weight
-    real(wp)                          :: liquid_precip_weight
+    real(wp)              :: liquid_precip_weight
     ! ice cloud particles weight
-    real(wp)                          :: ice_cloud_weight
+    real(wp)              :: ice_cloud_weight
     ! liquid cloud particles weight
-    real(wp)                          :: liquid_cloud_weight
+    real(wp)              :: liquid_cloud_weight
     ! security margin
-    real(wp)                          :: security_margin = 1e-10
-    
-    ! some general preparations
-    
-    ! here, the names of the gases are written to the gas_concentrations object
-    call handle_error(gas_concentrations_sw%init(gases_lowercase))
-    call handle_error(gas_concentrations_lw%init(gases_lowercase))
-    
-    !$omp critical
-    ! loading the short wave radiation properties
-    call load_and_init(k_dist_sw,trim(rrtmgp_coefficients_file_sw),gas_concentrations_sw)
-    ! loading the long wave radiation properties
-    call load_and_init(k_dist_lw,trim(rrtmgp_coefficients_file_lw),gas_concentrations_lw)
-    
-    ! reading the SW spectrai properties of clouds
-    call load_cld_lutcoeff(cloud_optics_sw,trim(cloud_coefficients_file_sw))
-    
-    ! reading the LW spectrai properties of clouds
-    call load_cld_lutcoeff(cloud_optics_lw,trim(cloud_coefficients_file_lw))
-    !$omp end critical
-    
-    ! calculation of the number of columns
-    no_of_scalars_h = no_of_scalars/no_of_layers
-    
-    ! set the surface emissivity (a longwave property) to a standard value
-    surface_emissivity(:,:) = 0.98_wp
-    
-    do ji=1,no_of_scalars_h
-      albedo_dir(:,ji) = sfc_albedo(ji)
-      albedo_dif(:,ji) = sfc_albedo(ji)
-    enddo
+    real(wp)              :: security_margin = 1e-10
     
     ! reformatting the thermodynamical state of the gas phase for RTE+RRTMGP
-    do ji=1,no_of_scalars_h
-      do jk=1,no_of_layers
-        temperature_rad(ji,jk) = temperature_gas((jk-1)*no_of_scalars_h+ji)
+    do jk=1,no_of_layers
+      do ji=1,no_of_columns
+        jc = column_indices(ji)
+        temperature_rad(ji,jk) = temperature_gas(jc,jk)
         ! the pressure is diagnozed here, using the equation of state for ideal gases
-        pressure_rad(ji,jk) = R_D &
-        *mass_densities(no_of_condensed_constituents*no_of_scalars &
-        + (jk-1)*no_of_scalars_h+ji)*temperature_rad(ji,jk)
+        pressure_rad(ji,jk) = R_D*mass_densities(jc,jk,no_of_condensed_constituents+1)*temperature_rad(ji,jk)
       enddo
     enddo
+    do ji=1,no_of_columns
+      temp_sfc_rad(ji) = temp_sfc(column_indices(ji))
+    enddo
     
     ! reformatting the clouds for RTE+RRTMGP
     ! the moist case
@@ -285,29 +594,25 @@ module radiation
     ice_cloud_radius = 0.5_wp*(cloud_optics_sw%get_min_radius_ice()+cloud_optics_sw%get_max_radius_ice())
     liquid_cloud_radius = 0.5_wp*(cloud_optics_sw%get_min_radius_liq()+cloud_optics_sw%get_max_radius_liq())
     if (no_of_condensed_constituents==4) then
-      do ji=1,no_of_scalars_h
+      do ji=1,no_of_columns
+        jc = column_indices(ji)
         do jk=1,no_of_layers
-          base_index = (jk-1)*no_of_scalars_h
           ! the solid condensates' effective radius
-          ice_precip_weight = mass_densities(base_index+ji)+security_margin
-          ice_cloud_weight = mass_densities(2*no_of_scalars+base_index+ji)+security_margin
+          ice_precip_weight = mass_densities(jc,jk,1)+security_margin
+          ice_cloud_weight = mass_densities(jc,jk,3)+security_margin
           ice_eff_radius_value = (ice_precip_weight*ice_precip_radius+ice_cloud_weight*ice_cloud_radius) &
           /(ice_precip_weight+ice_cloud_weight)
           ! the liquid condensates' effective radius
-          liquid_precip_weight = mass_densities(no_of_scalars+base_index+ji)+security_margin
-          liquid_cloud_weight = mass_densities(3*no_of_scalars+base_index+ji)+security_margin
+          liquid_precip_weight = mass_densities(jc,jk,2)+security_margin
+          liquid_cloud_weight = mass_densities(jc,jk,4)+security_margin
           liquid_eff_radius_value = (liquid_precip_weight*liquid_precip_radius+liquid_cloud_weight*liquid_cloud_radius) &
           /(liquid_precip_weight+liquid_cloud_weight)
           ! thickness of the gridbox
-          thickness = z_vector(ji+base_index)-z_vector(ji+jk*no_of_scalars_h)
+          thickness = z_vector((jk-1)*no_of_vectors_per_layer+jc)-z_vector(jk*no_of_vectors_per_layer+jc)
           ! solid water "content"
-          ice_water_path(ji,jk) = thickness*1000._wp &
-          *(mass_densities(base_index+ji) &
-          +mass_densities(2*no_of_scalars+base_index+ji))
+          ice_water_path(ji,jk) = thickness*1000._wp*(mass_densities(jc,jk,1)+mass_densities(jc,jk,3))
           ! liquid water "content"
-          liquid_water_path(ji,jk) = thickness*1000._wp &
-          *(mass_densities(no_of_scalars+base_index+ji) &
-          +mass_densities(3*no_of_scalars+base_index+ji))
+          liquid_water_path(ji,jk) = thickness*1000._wp*(mass_densities(jc,jk,2)+mass_densities(jc,jk,4))
           ! if there is no solid water in the grid box, the solid effective radius is set to zero
           ice_eff_radius(ji,jk) = merge(ice_eff_radius_value,0._wp,ice_water_path(ji,jk)>0._wp)
           ! if there is no liquid water in the grid box, the liquid effective radius is set to zero
@@ -323,7 +628,7 @@ module radiation
     endif
     
     ! moving the temperature into the allowed area
-    do ji=1,no_of_scalars_h
+    do ji=1,no_of_columns
       do jk=1,no_of_layers
         if (temperature_rad(ji,jk)>k_dist_sw%get_temp_max()) then
           temperature_rad(ji,jk) = k_dist_sw%get_temp_max()
@@ -341,7 +646,8 @@ module radiation
     enddo
     
     ! the properties at cell interfaces
-    do ji=1,no_of_scalars_h
+    do ji=1,no_of_columns
+      jc = column_indices(ji)
       do jk=1,no_of_layers+1
         ! values at TOA
         if (jk==1) then
@@ -352,22 +658,22 @@ module radiation
           ! delta T
           + (temperature_rad(ji,jk) - temperature_rad(ji,jk+1))/ &
           ! delta z
-          (z_scalar(ji+(jk-1)*no_of_scalars_h)-z_scalar(ji+jk*no_of_scalars_h)) &
+          (z_scalar(jc,jk)-z_scalar(jc,jk+1)) &
           ! times delta_z
-          *(z_vector(ji)-z_scalar(ji+(jk-1)*no_of_scalars_h))
+          *(z_vector(jc)-z_scalar(jc,jk))
           ! pressure at TOA
           ! here, the barometric height formula is used
           pressure_interface_rad   (ji,jk) = pressure_rad   (ji,jk) &
-          *EXP(-(z_vector(ji)-z_scalar(ji+(jk-1)*no_of_scalars_h))/scale_height)
+          *EXP(-(z_vector(jc)-z_scalar(jc,jk))/scale_height)
         ! values at the surface
         elseif (jk==no_of_layers+1) then
           ! temperature at the surface
           ! the value in the lowest layer
-          temperature_interface_rad(ji,jk) = temp_sfc(ji)
+          temperature_interface_rad(ji,jk) = temp_sfc_rad(ji)
           ! surface pressure
           pressure_interface_rad   (ji,jk) = pressure_rad   (ji,jk-1) &
-          *EXP(-(z_vector(no_of_layers*no_of_scalars_h+ji) &
-          -z_scalar(ji+(jk-2)*no_of_scalars_h))/scale_height)
+          *EXP(-(z_vector(no_of_layers*no_of_vectors_per_layer+jc) &
+          -z_scalar(jc,jk-1))/scale_height)
         else
           ! just the arithmetic mean
           temperature_interface_rad(ji,jk) = 0.5_wp*(temperature_rad(ji,jk-1)+temperature_rad(ji,jk))
@@ -377,7 +683,7 @@ module radiation
     enddo
     
     ! moving the interface temperature into the allowed area
-    do ji=1,no_of_scalars_h
+    do ji=1,no_of_columns
       if (temperature_interface_rad(ji,1)>k_dist_sw%get_temp_max()) then
          temperature_interface_rad(ji,1) = k_dist_sw%get_temp_max()
       endif
@@ -404,198 +710,64 @@ module radiation
       endif
     enddo
     
-    ! calculating the zenith angle,and counting day and night points
-    j_day = 0
-    do ji=1,no_of_scalars_h
-      mu_0(ji) = coszenith(latitude_scalar(ji),longitude_scalar(ji),time_coord)
-      if (mu_0(ji)>0._wp) then
-        j_day = j_day+1
-        day_indices(j_day) = ji
-      endif
-    enddo
-    
-    no_of_day_points = j_day
-    if (no_of_day_points==0) then
-      goto 1
-    endif
-    
-    ! now we start the actual radiation calculation
-    ! clearing the radiation tendency (it still contains the results of the previous call
-    ! from the dycore)
-    do ji=1,no_of_scalars
-      radiation_tendency(ji) = 0._wp
-    enddo
-    
-    ! short wave first
-    ! filling up the arrays restricted to day points
-    do j_day=1,no_of_day_points
-      temperature_rad_day(j_day,:) = temperature_rad(day_indices(j_day),:)
-      pressure_rad_day(j_day,:) = pressure_rad(day_indices(j_day),:)
-      pressure_interface_rad_day(j_day,:)= pressure_interface_rad(day_indices(j_day),:)
-      mu_0_day(j_day) = mu_0(day_indices(j_day))
-      temp_sfc_day(j_day) = temp_sfc(day_indices(j_day))
-      albedo_dir_day(:,j_day) = albedo_dir(:,day_indices(j_day))  
-      albedo_dif_day(:,j_day) = albedo_dif(:,day_indices(j_day))
-      liquid_water_path_day(j_day,:) = liquid_water_path(day_indices(j_day),:)
-      ice_water_path_day(j_day,:) = ice_water_path(day_indices(j_day),:)
-      liquid_eff_radius_day(j_day,:) = liquid_eff_radius(day_indices(j_day),:)
-      ice_eff_radius_day(j_day,:) = ice_eff_radius(day_indices(j_day),:)
-    end do
-    
-    ! setting the volume mixing ratios of the gases for the short wave calculation
-    gas_concentrations_sw%ncol = no_of_day_points
-    call set_vol_mix_ratios(mass_densities,.true.,no_of_day_points,no_of_scalars_h, &
-    no_of_layers,no_of_scalars,no_of_condensed_constituents,day_indices,z_scalar, &
-    gas_concentrations_sw)
-    
-    ! initializing the short wave fluxes
-    call init_fluxes(fluxes_day,no_of_day_points,no_of_layers+1)
-    
-    ! setting the bands for the SW cloud properties
-    call handle_error(cloud_props_sw%init(k_dist_sw%get_band_lims_wavenumber()))
-    
-    ! allocating the short wave optical properties
-    call handle_error(atmos_props_sw%alloc_2str(no_of_day_points,no_of_layers,k_dist_sw))
-    
-    ! allocating the short wave optical properties of the clouds
-    call handle_error(cloud_props_sw%alloc_2str(no_of_day_points,no_of_layers))
-    
-    ! allocating the TOA flux
-    allocate(toa_flux(no_of_day_points,k_dist_sw%get_ngpt()))
-    
-    ! setting the short wave optical properties of the gas phase
-    call handle_error(k_dist_sw%gas_optics(pressure_rad_day(1:no_of_day_points,:), &
-                                           pressure_interface_rad_day(1:no_of_day_points,:), &
-                                           temperature_rad_day(1:no_of_day_points,:), &
-                                           gas_concentrations_sw, &
-                                           atmos_props_sw, &
-                                           toa_flux))
-    
-    ! calculating the SW properties of the clouds
-    call handle_error(cloud_optics_sw%cloud_optics(liquid_water_path_day(1:no_of_day_points,:), &
-                                                   ice_water_path_day(1:no_of_day_points,:), &
-                                                   liquid_eff_radius_day(1:no_of_day_points,:), &
-                                                   ice_eff_radius_day(1:no_of_day_points,:), &
-                                                   cloud_props_sw))
-    
-    ! this seems to have to do with scattering
-    call handle_error(cloud_props_sw%delta_scale())
-    
-    ! adding the SW cloud properties to the gas properties to obtain the atmosphere's properties
-    call handle_error(cloud_props_sw%increment(atmos_props_sw))
-    
-    ! calculate shortwave radiative fluxes (only the day points are handed over
-    ! for efficiency)
-    call handle_error(rte_sw(atmos_props_sw, &
-                             .true., &
-                             mu_0_day(1:no_of_day_points), &
-                             toa_flux, &
-                             albedo_dir_day(:,1:no_of_day_points), &
-                             albedo_dif_day(:,1:no_of_day_points), &
-                             fluxes_day))
-    
-    ! short wave result (in Wm^-3)
-    call calc_power_density(.true.,no_of_scalars, &
-    no_of_layers,no_of_scalars_h,no_of_day_points,day_indices, &
-    fluxes_day,z_vector,radiation_tendency)
-    
-    ! saving the surface shortwave inward radiative flux density
-    do ji=1,no_of_day_points
-      sfc_sw_in(day_indices(ji)) = fluxes_day%flux_dn(ji,no_of_layers+1) &
-      - fluxes_day%flux_up(ji,no_of_layers+1)
-    enddo
-    
-    ! freeing the short wave fluxes
-    call free_fluxes(fluxes_day)
-    
-    ! now long wave
-1   continue
-    ! setting the volume mixing ratios of the gases for the long wave calculation
-    call set_vol_mix_ratios(mass_densities,.false.,no_of_day_points,no_of_scalars_h, &
-    no_of_layers,no_of_scalars,no_of_condensed_constituents,day_indices,z_scalar, &
-    gas_concentrations_lw)
-    
-    ! initializing the long wave fluxes
-    call init_fluxes(fluxes,no_of_scalars_h,no_of_layers+1)
-    
-    ! setting the bands for the LW cloud properties
-    call handle_error(cloud_props_lw%init(k_dist_lw%get_band_lims_wavenumber()))
-    
-    ! allocating the long wave optical properties of the gas phase
-    call handle_error(atmos_props_lw%alloc_1scl(no_of_scalars_h,no_of_layers,k_dist_lw))
-    
-    ! allocating the long wave optical properties of the clouds
-    call handle_error(cloud_props_lw%alloc_1scl(no_of_scalars_h,no_of_layers))
-    
-    ! allocating the long wave source function
-    call handle_error(sources_lw%alloc(no_of_scalars_h,no_of_layers,k_dist_lw))
-    
-    ! setting the long wave optical properties of the gas phase
-    call handle_error(k_dist_lw%gas_optics(pressure_rad, &
-                                           pressure_interface_rad, &
-                                           temperature_rad, &
-                                           temp_sfc, &
-                                           gas_concentrations_lw, &
-                                           atmos_props_lw, &
-                                           sources_lw, &
-                                           tlev = temperature_interface_rad))
-    
-    ! calculating the LW properties of the clouds
-    call handle_error(cloud_optics_lw%cloud_optics(liquid_water_path, &
-                                                   ice_water_path, &
-                                                   liquid_eff_radius, &
-                                                   ice_eff_radius, &
-                                                   cloud_props_lw))
-    
-    ! adding the LW cloud properties to the gas properties to obtain the atmosphere's properties
-    call handle_error(cloud_props_lw%increment(atmos_props_lw))
-    
-    ! calculate longwave radiative fluxes
-    call handle_error(rte_lw(atmos_props_lw, &
-                             .true., &
-                             sources_lw, &
-                             surface_emissivity, &
-                             fluxes))
-   
-    ! add long wave result (in Wm^-3)
-    call calc_power_density(.false.,no_of_scalars, &
-    no_of_layers,no_of_scalars_h,no_of_day_points,day_indices, &
-    fluxes,z_vector,radiation_tendency)
-    
-    ! saving the surface longwave outward radiative flux density
-    do ji=1,no_of_scalars_h
-      sfc_lw_out(ji) = fluxes%flux_up(ji,no_of_layers+1) &
-      - fluxes%flux_dn(ji,no_of_layers+1)
-    enddo
+  end subroutine prepare_columns
+  
+  subroutine prepare_workspace(ws,no_of_columns,no_of_layers)
+  
+    ! makes sure the arrays of a workspace can take the given number of columns,
+    ! they are only (re-)allocated if they are too small
     
-    ! freeing the long wave fluxes
-    call free_fluxes(fluxes)
+    ! the workspace
+    type(t_radiation_workspace), intent(inout) :: ws
+    ! the number of columns
+    integer,                     intent(in)    :: no_of_columns
+    ! as usual
+    integer,                     intent(in)    :: no_of_layers
     
-  end subroutine calc_radiative_flux_convergence
+    if (no_of_columns<=ws%max_no_of_columns) then
+      return
+    endif
     
-  subroutine calc_power_density(day_only,no_of_scalars, &
-  no_of_layers,no_of_scalars_h,no_of_day_points,day_indices, &
-  fluxes,z_vector,radiation_tendency)
+    if (allocated(ws%toa_flux)) then
+      deallocate(ws%toa_flux)
+      deallocate(ws%flux_up_sw)
+      deallocate(ws%flux_dn_sw)
+      deallocate(ws%flux_net_sw)
+      deallocate(ws%flux_up_lw)
+      deallocate(ws%flux_dn_lw)
+      deallocate(ws%flux_net_lw)
+    endif
+    allocate(ws%toa_flux(no_of_columns,k_dist_sw%get_ngpt()))
+    allocate(ws%flux_up_sw(no_of_columns,no_of_layers+1))
+    allocate(ws%flux_dn_sw(no_of_columns,no_of_layers+1))
+    allocate(ws%flux_net_sw(no_of_columns,no_of_layers+1))
+    allocate(ws%flux_up_lw(no_of_columns,no_of_layers+1))
+    allocate(ws%flux_dn_lw(no_of_columns,no_of_layers+1))
+    allocate(ws%flux_net_lw(no_of_columns,no_of_layers+1))
+    ws%max_no_of_columns = no_of_columns
+  
+  end subroutine prepare_workspace
+  
+  subroutine calc_power_density(no_of_scalars_h,no_of_layers,no_of_vectors_per_layer, &
+  no_of_relevant_columns,column_indices,fluxes,z_vector,radiation_tendency)
   
     ! this is essentially the negative vertical divergence operator
     
-    ! true for short wave calculations (for efficiency)
-    logical, intent(in)                   :: day_only
     ! as usual
-    integer, intent(in)                   :: no_of_scalars
+    integer, intent(in)                   :: no_of_scalars_h
     ! as usual
     integer, intent(in)                   :: no_of_layers
     ! as usual
-    integer, intent(in)                   :: no_of_scalars_h
-    ! as usual
-    integer, intent(in)                   :: no_of_day_points
-    ! the indices of the columns where it is day
-    integer, intent(in)                   :: day_indices(no_of_scalars_h)
+    integer, intent(in)                   :: no_of_vectors_per_layer
+    ! the number of columns taken into account
+    integer, intent(in)                   :: no_of_relevant_columns
+    ! the indices of the columns in the model grid the fluxes belong to
+    integer, intent(in)                   :: column_indices(no_of_relevant_columns)
     type(ty_fluxes_broadband), intent(in) :: fluxes
     ! as usual
-    real(wp), intent(in)                  :: z_vector(no_of_scalars + no_of_scalars_h)
+    real(wp), intent(in)                  :: z_vector(no_of_layers*no_of_vectors_per_layer+no_of_scalars_h)
     ! the result (in W/m^3)
-    real(wp), intent(inout)               :: radiation_tendency(no_of_scalars)
+    real(wp), intent(inout)               :: radiation_tendency(no_of_scalars_h,no_of_layers)
   
     ! local variables
     ! the layer index
@@ -604,29 +776,17 @@ module radiation
     integer :: j_column
     ! the horizontal index
     integer :: jk
-    ! the number of columns taken into account
-    integer :: no_of_relevant_columns
-    
-    if (day_only) then
-      no_of_relevant_columns = no_of_day_points
-    else
-      no_of_relevant_columns = no_of_scalars_h
-    endif
   
     ! loop over all columns
     do j_column=1,no_of_relevant_columns
+      ! finding the relevant horizontal index
+      jk = column_indices(j_column)
       ! loop over all layers
       do ji=1,no_of_layers
-        ! finding the relevant horizontal index
-        if (day_only) then
-          jk = day_indices(j_column)
-        else
-          jk = j_column
-        endif
-        radiation_tendency((ji-1)*no_of_scalars_h+jk) = &
-        ! this function is called four times, therefore we need to
+        radiation_tendency(jk,ji) = &
+        ! this function is called twice, therefore we need to
         ! add up the tendencies
-        radiation_tendency((ji-1)*no_of_scalars_h+jk) + &
+        radiation_tendency(jk,ji) + &
         ! this is a sum of four fluxes
         ( &
         ! upward flux (going in)
@@ -639,22 +799,23 @@ module radiation
         - fluxes%flux_dn(j_column,ji+1)) &
         ! dividing by the column thickness (the shallow atmosphere
         ! approximation is made at this point)
-        /(z_vector((ji-1)*no_of_scalars_h+jk) - z_vector(ji*no_of_scalars_h+jk))
+        /(z_vector((ji-1)*no_of_vectors_per_layer+jk) - z_vector(ji*no_of_vectors_per_layer+jk))
       enddo
     enddo
   
   end subroutine calc_power_density
   
-  real(wp) function coszenith(lat,lon,t)
+  real(wp) function coszenith(lat,lon,t) &
+  bind(c,name = "coszenith")
   
     ! calculates the cosine of the zenith angle at a given
-    ! point and time
+    ! point and time (also called by the dynamical core)
   
   	! the coordinates of the place we look at
-    real(wp), intent(in) :: lat
-    real(wp), intent(in) :: lon
+    real(wp), intent(in), value :: lat
+    real(wp), intent(in), value :: lon
     ! the unix time stamp of the time
-    real(wp), intent(in) :: t
+    real(wp), intent(in), value :: t
     
     ! local variables
     real(wp)                          :: normal_vector_rel2_earth(3)
@@ -729,34 +890,31 @@ module radiation
   
   end function coszenith
   
-  subroutine set_vol_mix_ratios(mass_densities,sw_bool,no_of_day_points,no_of_scalars_h, &
-  no_of_layers,no_of_scalars,no_of_condensed_constituents,day_indices,z_scalar, &
-  gas_concentrations)
+  subroutine set_vol_mix_ratios(mass_densities,z_scalar,column_indices,no_of_relevant_columns,no_of_scalars_h, &
+  no_of_layers,no_of_constituents,no_of_condensed_constituents,gas_concentrations)
     
     ! computes volume mixing ratios out of the model variables
     
-    ! mass densities of the constituents
-    real(wp), intent(in)              :: mass_densities(:)
-    ! short wave switch
-    logical,  intent(in)              :: sw_bool
-    ! as usual
-    integer,  intent(in)              :: no_of_day_points
     ! as usual
     integer,  intent(in)              :: no_of_scalars_h
     ! as usual
     integer,  intent(in)              :: no_of_layers
     ! as usual
-    integer,  intent(in)              :: no_of_scalars
+    integer,  intent(in)              :: no_of_constituents
     ! as usual
     integer,  intent(in)              :: no_of_condensed_constituents
-    ! the indices of the points where it is day
-    integer,  intent(in)              :: day_indices(no_of_scalars/no_of_layers)
+    ! the number of columns taken into account
+    integer,  intent(in)              :: no_of_relevant_columns
+    ! the indices of the columns in the model grid
+    integer,  intent(in)              :: column_indices(no_of_relevant_columns)
+    ! mass densities of the constituents
+    real(wp), intent(in)              :: mass_densities(no_of_scalars_h,no_of_layers,no_of_constituents)
     ! z coordinates of scalar data points
-    real(wp), intent(in)              :: z_scalar(no_of_scalars)
+    real(wp), intent(in)              :: z_scalar(no_of_scalars_h,no_of_layers)
     type(ty_gas_concs), intent(inout) :: gas_concentrations
     
     ! the volume mixing ratio of a gas
-    real(wp) :: vol_mix_ratio(no_of_scalars_h,no_of_layers)
+    real(wp) :: vol_mix_ratio(no_of_relevant_columns,no_of_layers)
     ! loop indices
     integer  :: ji,jk,jl
     
@@ -773,19 +931,11 @@ module radiation
         case("ch4")
           vol_mix_ratio(:,:) = molar_fraction_in_dry_air(wp)
         case("o3")
-          if (sw_bool) then
-            do jk=1,no_of_day_points
-              do jl=1,no_of_layers
-                vol_mix_ratio(jk,jl) = calc_o3_vmr(z_scalar(day_indices(jk)+(jl-1)*no_of_scalars_h))
-              enddo
+          do jk=1,no_of_relevant_columns
+            do jl=1,no_of_layers
+              vol_mix_ratio(jk,jl) = calc_o3_vmr(z_scalar(column_indices(jk),jl))
             enddo
-          else
-            do jk=1,no_of_scalars_h
-              do jl=1,no_of_layers
-                vol_mix_ratio(jk,jl) = calc_o3_vmr(z_scalar(jk+(jl-1)*no_of_scalars_h))
-              enddo
-            enddo
-          endif
+          enddo
         case("co2")
           vol_mix_ratio(:,:) = molar_fraction_in_dry_air(5)
         case("co")
@@ -794,55 +944,43 @@ module radiation
           vol_mix_ratio(:,:) = molar_fraction_in_dry_air(11)
         case("h2o")
           ! no_of_condensed_constituents==4 is equivalent to the presence of water in the model atmosphere
-          ! in the short wave case,only the day points matter
-          if (sw_bool .and. no_of_condensed_constituents==4) then
-            do jk=1,no_of_day_points
-              do jl=1,no_of_layers
-                vol_mix_ratio(jk,jl) = & 
-                mass_densities((no_of_condensed_constituents+1)*no_of_scalars+day_indices(jk)+(jl-1)*no_of_scalars_h)*R_V/ &
-                (mass_densities(no_of_condensed_constituents*no_of_scalars+day_indices(jk)+(jl-1)*no_of_scalars_h)*R_D)
-              enddo
-            enddo
-          ! in the long wave case,all points matter
-          elseif (no_of_condensed_constituents==4) then
-            do jk=1,no_of_scalars_h
+          if (no_of_condensed_constituents==4) then
+            do jk=1,no_of_relevant_columns
               do jl=1,no_of_layers
                 vol_mix_ratio(jk,jl) = & 
-                mass_densities((no_of_condensed_constituents+1)*no_of_scalars+jk+(jl-1)*no_of_scalars_h)*R_V/ &
-                (mass_densities(no_of_condensed_constituents*no_of_scalars+jk+(jl-1)*no_of_scalars_h)*R_D)
+                mass_densities(column_indices(jk),jl,no_of_condensed_constituents+2)*R_V/ &
+                (mass_densities(column_indices(jk),jl,no_of_condensed_constituents+1)*R_D)
               enddo
             enddo
           endif
         end select
       ! finally setting the VMRs to the gas_concentrations objects
-      if (sw_bool) then
-        call handle_error(gas_concentrations%set_vmr(gases_lowercase(ji),vol_mix_ratio(1:no_of_day_points,:)))
-      else
-        call handle_error(gas_concentrations%set_vmr(gases_lowercase(ji),vol_mix_ratio(:,:)))
-      endif
+      call handle_error(gas_concentrations%set_vmr(gases_lowercase(ji),vol_mix_ratio(:,:)))
     enddo ! ji
   
   end subroutine set_vol_mix_ratios
   
-  subroutine init_fluxes(fluxes,n_hor,n_vert)
+  subroutine set_fluxes(fluxes,flux_up,flux_dn,flux_net,n_hor)
   
-    ! this subroutine initializes a flux object
-    
-    ! the fluxes to initialize
-    type(ty_fluxes_broadband), intent(inout) :: fluxes
+    ! this subroutine points a flux object to the first n_hor columns of the given storage arrays and resets it
+    
+    ! the fluxes to set
+    type(ty_fluxes_broadband), intent(inout)     :: fluxes
+    ! the storage of the fluxes
+    real(wp), target,          intent(inout)     :: flux_up(:,:)
+    real(wp), target,          intent(inout)     :: flux_dn(:,:)
+    real(wp), target,          intent(inout)     :: flux_net(:,:)
     ! the number of columns
-    integer,                   intent(in)    :: n_hor
-    ! the number of levels
-    integer,                   intent(in)    :: n_vert
+    integer,                   intent(in)        :: n_hor
  	
  	! broad band fluxes
-    allocate(fluxes%flux_up(n_hor,n_vert))
-    allocate(fluxes%flux_dn(n_hor,n_vert))
-    allocate(fluxes%flux_net(n_hor,n_vert))
+    fluxes%flux_up => flux_up(1:n_hor,:)
+    fluxes%flux_dn => flux_dn(1:n_hor,:)
+    fluxes%flux_net => flux_net(1:n_hor,:)
     
     call reset_fluxes(fluxes)
     
-  end subroutine init_fluxes
+  end subroutine set_fluxes
   
   subroutine reset_fluxes(fluxes)
 
@@ -858,19 +996,6 @@ module radiation
 
   end subroutine reset_fluxes
   
-  subroutine free_fluxes(fluxes)
-  
-    ! freeing a flux object
-    ! the fluxes to free
-    type(ty_fluxes_broadband), intent(inout) :: fluxes
-    
-    if (associated(fluxes%flux_up)) deallocate(fluxes%flux_up)
-    if (associated(fluxes%flux_dn)) deallocate(fluxes%flux_dn)
-    if (associated(fluxes%flux_net)) deallocate(fluxes%flux_net)
-    if (associated(fluxes%flux_dn_dir)) deallocate(fluxes%flux_dn_dir)
-  
-  end subroutine free_fluxes
-  
   subroutine handle_error(error_message)
   
     character(len = *), intent(in) :: error_message
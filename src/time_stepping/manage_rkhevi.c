@@ -17,7 +17,7 @@ This file manages the RKHEVI time stepping.
 #include "../subgrid_scale/subgrid_scale.h"
 #include "../io/io.h"
 
-int manage_rkhevi(State *state_old, State *state_new, Grid *grid, Dualgrid *dualgrid, State *state_tendency, Diagnostics *diagnostics, Forcings *forcings,
+int manage_rkhevi(State *state_old, State *state_new, Grid *grid, Radiation_grid *radiation_grid, Dualgrid *dualgrid, State *state_tendency, Diagnostics *diagnostics, Forcings *forcings,
 Irreversible_quantities *irrev, Config *config, double delta_t, double time_coordinate)
 {
 	/*
@@ -77,10 +77,15 @@ Irreversible_quantities *irrev, Config *config, double delta_t, double time_coor
 
 		// 2.) explicit component of the generalized density equations
 		// -----------------------------------------------------------
-	    // Radiation is updated here.
-		if (config -> rad_on > 0 && config -> rad_update == 1 && rk_step == 0)
+	    // Radiation is updated here (in the asynchronous case, this is managed by the main).
+		if (config -> rad_on > 0 && config -> rad_update == 1 && rk_step == 0 && config -> rad_async == 0)
 		{
-			call_radiation(state_old, grid, dualgrid, state_tendency, diagnostics, forcings, irrev, config, delta_t, time_coordinate);
+			call_radiation(state_old, grid, radiation_grid, dualgrid, state_tendency, diagnostics, forcings, irrev, config, delta_t, time_coordinate);
+		}
+		// the radiative heating is interpolated to the middle of the time step
+		if (config -> rad_on == 1 && config -> rad_time_interpol == 1 && rk_step == 0)
+		{
+			interpolate_radiation_in_time(grid, forcings, time_coordinate + 0.5*delta_t);
 		}
 		scalar_tendencies_expl(state_old, state_new, state_tendency, grid, dualgrid, delta_t, diagnostics, forcings, irrev, config, rk_step);
 